@@ -27,6 +27,22 @@
 #define BASILISK_RESOURCE_STORAGES_EXTENSION "data"
 #endif
 
+#ifndef BASILISK_WORKER_THREADS
+#define BASILISK_WORKER_THREADS 4
+#endif
+
+#ifndef BASILISK_EVENTS_PER_FRAME_MAX
+#define BASILISK_EVENTS_PER_FRAME_MAX 65536
+#endif
+
+#ifndef BASILISK_EVENTS_MS_PER_FRAME_MAX
+#define BASILISK_EVENTS_MS_PER_FRAME_MAX 0
+#endif
+
+#ifndef BASILISK_IDLE_SLICE_MS
+#define BASILISK_IDLE_SLICE_MS 2
+#endif
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -38,6 +54,35 @@ typedef struct basilisk_engine basilisk_engine;
 /* Anonymous type to whatever the user chose for an entity to store. Used as an access to change the state of an entity and its children. */
 typedef void basilisk_entity;
 
+/**
+ * @brief Orders in which the events sharing a name can be sent. Events of LIFO names are sent first, then events of
+ * priority names, then events of FIFO names.
+ */
+typedef enum basilisk_event_dispatch_mode {
+    /** The last event stacked is sent first. This is the default. */
+    BASILISK_EVENT_DISPATCH_LIFO,
+    /** The first event stacked is sent first. */
+    BASILISK_EVENT_DISPATCH_FIFO,
+    /** The event of highest priority is sent first, the first one stacked among equals. */
+    BASILISK_EVENT_DISPATCH_PRIORITY,
+    /** The events stacked by an entity are gathered in a single event, holding the array of their data, and sent in FIFO order. */
+    BASILISK_EVENT_DISPATCH_BATCHED,
+} basilisk_event_dispatch_mode;
+
+/**
+ * @brief Ways to merge the events of some name stacked by a same entity, so that at most one of them waits to be sent.
+ */
+typedef enum basilisk_event_coalescing_mode {
+    /** All events are sent. */
+    BASILISK_EVENT_COALESCE_NONE,
+    /** Only the first event stacked is sent. */
+    BASILISK_EVENT_COALESCE_KEEP_FIRST,
+    /** Only the last event stacked is sent. */
+    BASILISK_EVENT_COALESCE_KEEP_LAST,
+    /** The data of the events stacked are folded into the data of the first one by a user reducer. */
+    BASILISK_EVENT_COALESCE_REDUCE,
+} basilisk_event_coalescing_mode;
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -57,6 +102,16 @@ typedef struct basilisk_entity_definition {
     void (*on_deinit)(basilisk_entity *self_data);
     /** Function ran on the entity-specific data each frame. */
     void (*on_frame)(basilisk_entity *self_data, float elapsed_ms);
+    /** Function (can be null) ran on the entity-specific data when a message sent directly to the entity is delivered. */
+    void (*on_message)(basilisk_entity *self_data, unsigned long message_id, void *message_data);
+
+    /** If set, the on_frame() callback only touches data of the entity's own subtree and does not modify the game tree (no entity added).
+    Subtrees made only of such entities are stepped concurrently on the engine's worker threads : events they stack and commands they queue
+    are received at the start of the next frame. From a worker thread, only basilisk_entity_stack_event(), basilisk_entity_stack_event_scoped(),
+    basilisk_entity_send(), basilisk_entity_queue_remove(), basilisk_entity_queue_subscribe_to_event(), basilisk_entity_queue_unsubscribe_from_event(),
+    basilisk_entity_get_parent(), basilisk_entity_get_child() and basilisk_entity_is() can be called : the other engine functions are ignored
+    there and log an error. */
+    bool is_parallel_safe;
 } basilisk_entity_definition;
 
 /**
@@ -84,6 +139,21 @@ typedef struct basilisk_specific_graft {
     basilisk_entity * (*graft_procedure)(basilisk_entity *entity, void *graft_args);
 } basilisk_specific_graft;
 
+/**
+ * @brief Data representing a condition on the data of an event. A key is read from the event data, masked, and
+ * compared to a value : the event matches if `(key & mask) == value`. A filter with a key size of zero matches all events.
+ */
+typedef struct basilisk_event_filter {
+    /** Position, in bytes, of the key in the event data. */
+    unsigned long offset;
+    /** Size, in bytes, of the key : 1, 2, 4 or 8. Zero disables the filter. */
+    unsigned long size;
+    /** Bits of the key that are compared. */
+    unsigned long long mask;
+    /** Expected value of the masked key. */
+    unsigned long long value;
+} basilisk_event_filter;
+
 /**
  * @brief Data representing the behavior to of an entity on receiving an event.
  */
@@ -92,14 +162,40 @@ typedef struct basilisk_specific_event_subscription {
     int index;
     /** Fucntion executed when an event is received. */
     void (*callback)(basilisk_entity *self_data, void *event_data);
+    /** Function (can be null) executed instead of `callback` when a batch of events is received, with the contiguous array of their data. */
+    void (*batch_callback)(basilisk_entity *self_data, void *events_data, unsigned long count);
+    /** Function (can be null) executed instead of `callback`, receiving `typed_callback` to call it through its actual type. Set by BASILISK_EVENT_TYPE(). */
+    void (*trampoline)(basilisk_entity *self_data, void *event_data, void (*typed_callback)(void));
+    /** Function of any type passed to `trampoline`. */
+    void (*typed_callback)(void);
+    /** Condition on the event data : the callbacks only receive the events matching it. */
+    basilisk_event_filter filter;
+    /** If set, the callbacks can be executed on a worker thread, at the same time as the other concurrent callbacks of neighbouring indexes and of other entities.
+    They must then only touch the data of their entity, and only call the engine functions allowed on worker threads (see basilisk_entity_definition.is_parallel_safe). */
+    bool is_concurrent;
 } basilisk_specific_event_subscription;
 
+/**
+ * @brief Handle to a subscription, returned when subscribing and used to unsubscribe. Zero is never a valid handle.
+ */
+typedef unsigned long long basilisk_event_subscription_handle;
+
 /**
  * @brief Data representing a new event to add to the stack.
  */
 typedef struct basilisk_specific_event {
     /** If set, the event will not be removed if the entity that sent it is removed itself. */
     bool is_detached;
+    /** If set, the data is not copied : it must stay untouched until the event is sent, before the sender's next frame. */
+    bool is_borrowed;
+    /** If set, the event brings data from outside of the engine (devices, network...) : it is recorded, and dropped when replaying a recording. */
+    bool is_input;
+    /** If set, the event is not sent by the current event phase but by the next one. Its data is copied even if borrowed. */
+    bool is_deferred;
+    /** Priority of the event, if its name is dispatched by priority. The higher, the sooner the event is sent. */
+    int priority;
+    /** If not zero, the event is sent by the first event phase after this many milliseconds. Its data is copied even if borrowed. */
+    unsigned long delay_ms;
 
     /** Size, in bytes, of the event's data.*/
     unsigned long data_size;
@@ -107,6 +203,112 @@ typedef struct basilisk_specific_event {
     void *data;
 } basilisk_specific_event;
 
+/**
+ * @brief Data representing how the events of some name are merged while they wait to be sent.
+ */
+typedef struct basilisk_specific_event_coalescing {
+    /** How the events are merged. */
+    basilisk_event_coalescing_mode mode;
+    /** Function (can be null) folding the data of a new event into the data of the event waiting to be sent, used by
+    BASILISK_EVENT_COALESCE_REDUCE. Both data are of the same size. */
+    void (*reducer)(void *pending_data, const void *new_data);
+} basilisk_specific_event_coalescing;
+
+/**
+ * @brief Data representing some work executed away from the main thread on behalf of an entity.
+ */
+typedef struct basilisk_specific_job {
+    /** Size, in bytes, of the job's data. */
+    unsigned long data_size;
+    /** Pointer (can be null) to the job's data. This data is copied to the engine by functions that take the
+    containing struct type, and the copy is shared by the routine and the completion callback. */
+    void *data;
+
+    /** Function executed on a worker thread. It must not call any basilisk function. */
+    void (*routine)(void *job_data);
+    /** Function (can be null) executed on the main thread, at the start of the frame following the job's completion. */
+    void (*on_done)(basilisk_entity *self_data, void *job_data);
+} basilisk_specific_job;
+
+/**
+ * @brief State of a coroutine attached to an entity, passed to the coroutine's body each time it resumes.
+ */
+typedef struct basilisk_coroutine {
+    /** Point of the body the coroutine resumes from. Managed by the BASILISK_COROUTINE_* macros. */
+    int resume_point;
+    /** Coroutine-owned copy of the data given at its start. Local variables of the body do not survive a wait : state kept across waits must live here. */
+    void *data;
+    /** Data of the event that resumed the coroutine, if it awaited one. Only valid until the body returns. */
+    void *event_data;
+} basilisk_coroutine;
+
+/**
+ * @brief Data of the events sent while a storage is prefetched (BASILISK_EVENT_STORAGE_PROGRESS) and once it is
+ * (BASILISK_EVENT_STORAGE_PREFETCHED).
+ */
+typedef struct basilisk_storage_progress {
+    /** Path to the prefetched storage file. */
+    const char *str_storage_path;
+    /** Number of resources of the storage already read in memory. */
+    unsigned long prefetched_count;
+    /** Number of resources in the storage. */
+    unsigned long resources_count;
+} basilisk_storage_progress;
+
+/* Name of the events sent while a storage is prefetched, each time another percent of its resources is read. */
+#define BASILISK_EVENT_STORAGE_PROGRESS "basilisk storage progress"
+/* Name of the event sent to all entities once a storage is prefetched. */
+#define BASILISK_EVENT_STORAGE_PREFETCHED "basilisk storage prefetched"
+
+/**
+ * @brief Data representing a new coroutine to attach to an entity.
+ */
+typedef struct basilisk_specific_coroutine {
+    /** Size, in bytes, of the coroutine's data. */
+    unsigned long data_size;
+    /** Pointer (can be null) to the coroutine's data. This data is copied to the engine by functions that take the
+    containing struct type. */
+    void *data;
+
+    /** Function executed each time the coroutine resumes. It must enclose its code in BASILISK_COROUTINE_BEGIN() and BASILISK_COROUTINE_END(). */
+    void (*body)(basilisk_entity *self_data, basilisk_coroutine *coroutine);
+} basilisk_specific_coroutine;
+
+/**
+ * @brief Data representing some low-priority work executed in slices, in the time left at the end of frames.
+ */
+typedef struct basilisk_specific_idle_task {
+    /** Size, in bytes, of the task's data. */
+    unsigned long data_size;
+    /** Pointer (can be null) to the task's data. This data is copied to the engine by functions that take the
+    containing struct type. */
+    void *data;
+
+    /** Function executing a short slice of the work. It returns true while work remains, and false once the task is finished. */
+    bool (*routine)(basilisk_entity *self_data, void *task_data);
+    /** Expected duration, in milliseconds, of a slice before any was measured. Zero uses BASILISK_IDLE_SLICE_MS. */
+    unsigned long slice_ms;
+} basilisk_specific_idle_task;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// ENGINE STATISTICS
+
+/**
+ * @brief Counters describing how the event phases of the main loop went.
+ */
+typedef struct basilisk_engine_event_stats {
+    /** Number of events sent during the last frame. */
+    unsigned long last_frame_events;
+    /** Number of frames whose event phase was cut short by the events count limit. */
+    unsigned long count_limit_hits;
+    /** Number of frames whose event phase was cut short by the time limit. */
+    unsigned long time_limit_hits;
+    /** Total number of events carried over to a later frame because of the limits. */
+    unsigned long carried_events;
+} basilisk_engine_event_stats;
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -128,16 +330,102 @@ basilisk_entity *basilisk_engine_root_entity(basilisk_engine *handle);
 /* Starts the main loop of the engine, resolving pending commands, sending events and stepping
 entities. */
 void basilisk_engine_run(basilisk_engine *handle, int fps);
+/* Records the frames and input events of the following runs to a file, or stops recording if the path is nullptr. */
+void basilisk_engine_record(basilisk_engine *handle, const char *str_path);
+/* Runs the engine at full speed on the frames and input events of a recording, until its end. */
+void basilisk_engine_replay(basilisk_engine *handle, const char *str_path);
+/* Limits the number of events sent and the time spent sending them each frame (zero meaning no limit). Events left over are sent first on the next frame. */
+void basilisk_engine_set_event_limits(basilisk_engine *handle, unsigned long max_events_per_frame, unsigned long max_ms_per_frame);
+/* Returns the counters describing the event phases of the main loop. */
+basilisk_engine_event_stats basilisk_engine_get_event_stats(const basilisk_engine *handle);
 
 // -------------------------------------------------------------------------------------------------
 // ENTITY INTERACTIONS
 
 /* Flags the engine to exit next frame. */
 void basilisk_entity_quit(basilisk_entity *entity);
-/* Adds a pending command to subscribe a callback to an event, by the event's name. */
-void basilisk_entity_queue_subscribe_to_event(basilisk_entity *entity, const char *str_event_name, basilisk_specific_event_subscription subscription_data);
+/* Sets the order in which the events of some name are sent, from now on. */
+void basilisk_entity_set_event_dispatch(basilisk_entity *entity, const char *str_event_name, basilisk_event_dispatch_mode mode);
+/* Sets how the events of some name stacked by a same entity are merged, from now on. */
+void basilisk_entity_set_event_coalescing(basilisk_entity *entity, const char *str_event_name, basilisk_specific_event_coalescing coalescing);
+/* Adds a pending command to subscribe a callback to an event, by the event's name. A name ending with '*' subscribes to all events starting with the same prefix. */
+basilisk_event_subscription_handle basilisk_entity_queue_subscribe_to_event(basilisk_entity *entity, const char *str_event_name, basilisk_specific_event_subscription subscription_data);
+/* Adds a pending command to unsubscribe a callback from an event, by the handle returned when it subscribed. */
+void basilisk_entity_queue_unsubscribe_from_event(basilisk_entity *entity, basilisk_event_subscription_handle subscription);
 /* Sends an event to subscribed entities. */
 void basilisk_entity_stack_event(basilisk_entity *entity, const char *str_event_name, basilisk_specific_event event_data);
+/* Sends an event to subscribed entities in the subtree of some entity. */
+void basilisk_entity_stack_event_scoped(basilisk_entity *entity, basilisk_entity *scope_root, const char *str_event_name, basilisk_specific_event event_data);
+/* Sends a message directly to an entity, received by its on_message() callback during the event phase. */
+void basilisk_entity_send(basilisk_entity *target, unsigned long message_id, void *data, unsigned long data_size);
+
+// -------------------------------------------------------------------------------------------------
+// ENTITY TYPED EVENTS
+
+/* Declares the size and alignment of the data of all events of some name. Events of this name with data of another size are rejected. Use BASILISK_EVENT_TYPE() instead. */
+void basilisk_entity_declare_event_type(basilisk_entity *entity, const char *str_event_name, unsigned long payload_size, unsigned long payload_alignment);
+
+/* Defines typed functions to declare, stack and subscribe to the events of some name carrying a payload_t, checked by the compiler : type_name_declare(entity), type_name_stack(entity, const payload_t *payload) and type_name_subscribe(entity, index, callback).
+   The stacked payload is copied. The typed callback is stored as is and called by a generated trampoline, through its actual type. */
+#define BASILISK_EVENT_TYPE(type_name, str_event_name, payload_t) \
+    static inline void type_name##_declare(basilisk_entity *entity) \
+    { basilisk_entity_declare_event_type(entity, str_event_name, sizeof(payload_t), _Alignof(payload_t)); } \
+    static inline void type_name##_stack(basilisk_entity *entity, const payload_t *payload) \
+    { payload_t payload_copy = *payload; \
+      basilisk_entity_stack_event(entity, str_event_name, (basilisk_specific_event) { .data_size = sizeof(payload_copy), .data = &payload_copy }); } \
+    static inline void type_name##_trampoline(basilisk_entity *self_data, void *event_data, void (*typed_callback)(void)) \
+    { ((void (*)(basilisk_entity *, payload_t *)) typed_callback)(self_data, (payload_t *) event_data); } \
+    static inline basilisk_event_subscription_handle type_name##_subscribe(basilisk_entity *entity, int index, void (*callback)(basilisk_entity *self_data, payload_t *payload)) \
+    { return basilisk_entity_queue_subscribe_to_event(entity, str_event_name, (basilisk_specific_event_subscription) { .index = index, .trampoline = &type_name##_trampoline, .typed_callback = (void (*)(void)) callback }); }
+
+// -------------------------------------------------------------------------------------------------
+// ENTITY TIMERS
+
+/* Executes a callback on the entity once, after some delay. */
+void basilisk_entity_schedule(basilisk_entity *entity, unsigned long delay_ms, void (*callback)(basilisk_entity *self_data, void *timer_data), void *timer_data);
+/* Executes a callback on the entity every period, starting after one period. */
+void basilisk_entity_schedule_periodic(basilisk_entity *entity, unsigned long period_ms, void (*callback)(basilisk_entity *self_data, void *timer_data), void *timer_data);
+/* Cancels all pending timers of the entity that were scheduled with a callback. */
+void basilisk_entity_unschedule(basilisk_entity *entity, void (*callback)(basilisk_entity *self_data, void *timer_data));
+
+// -------------------------------------------------------------------------------------------------
+// ENTITY JOBS
+
+/* Executes some work on a worker thread, and notifies the entity on the main thread once it is done. The job is cancelled if the entity is removed first. */
+void basilisk_entity_submit_job(basilisk_entity *entity, basilisk_specific_job job_data);
+
+// -------------------------------------------------------------------------------------------------
+// ENTITY IDLE TASKS
+
+/* Queues some low-priority work executed in slices, only when a frame ends early enough to leave time for it. The task is removed along the entity. */
+void basilisk_entity_queue_idle_task(basilisk_entity *entity, basilisk_specific_idle_task task_data);
+
+// -------------------------------------------------------------------------------------------------
+// ENTITY COROUTINES
+
+/* Attaches a coroutine to the entity, first resumed on the next frame. The coroutine is removed along the entity. */
+void basilisk_entity_start_coroutine(basilisk_entity *entity, basilisk_specific_coroutine coroutine_data);
+
+/* Flags the running coroutine to resume after some frames. Use BASILISK_COROUTINE_AWAIT_FRAMES() in the coroutine's body instead. */
+void basilisk_coroutine_await_frames(basilisk_coroutine *coroutine, unsigned long frames_count);
+/* Flags the running coroutine to resume after some duration. Use BASILISK_COROUTINE_AWAIT_DURATION() in the coroutine's body instead. */
+void basilisk_coroutine_await_duration(basilisk_coroutine *coroutine, unsigned long duration_ms);
+/* Flags the running coroutine to resume on the next event of some name. Use BASILISK_COROUTINE_AWAIT_EVENT() in the coroutine's body instead. */
+void basilisk_coroutine_await_event(basilisk_coroutine *coroutine, const char *str_event_name);
+
+/* Opens the body of a coroutine. Awaits resume the body where they were written, so that at most one await can be written on a single line. */
+#define BASILISK_COROUTINE_BEGIN(coroutine) switch ((coroutine)->resume_point) { case 0:
+/* Closes the body of a coroutine. Returning from the body without awaiting finishes the coroutine. */
+#define BASILISK_COROUTINE_END(coroutine) default: break; }
+
+/* Suspends the coroutine after some call flagging what it waits for, and resumes it from there. */
+#define BASILISK_COROUTINE_AWAIT(coroutine, await_call) do { await_call; (coroutine)->resume_point = __LINE__; return; case __LINE__: ; } while (0)
+/* Suspends the coroutine for some frames. */
+#define BASILISK_COROUTINE_AWAIT_FRAMES(coroutine, frames_count) BASILISK_COROUTINE_AWAIT(coroutine, basilisk_coroutine_await_frames(coroutine, frames_count))
+/* Suspends the coroutine for some milliseconds. */
+#define BASILISK_COROUTINE_AWAIT_DURATION(coroutine, duration_ms) BASILISK_COROUTINE_AWAIT(coroutine, basilisk_coroutine_await_duration(coroutine, duration_ms))
+/* Suspends the coroutine until an event is sent. Its data is then available in the coroutine's event_data field. */
+#define BASILISK_COROUTINE_AWAIT_EVENT(coroutine, str_event_name) BASILISK_COROUTINE_AWAIT(coroutine, basilisk_coroutine_await_event(coroutine, str_event_name))
 
 // -------------------------------------------------------------------------------------------------
 // ENTITY HIERARCHY MODIFICATIONS
@@ -168,8 +456,16 @@ bool basilisk_entity_is(const basilisk_entity *entity, basilisk_entity_definitio
 void basilisk_engine_declare_resource(basilisk_engine *handle, const char *str_storage_name, const char *str_file_path);
 #define basilisk_engine_declare_resource(handle, str_storage_name, str_file_path) basilisk_engine_declare_resource(handle, BASILISK_RESOURCE_STORAGES_FOLDER "/" str_storage_name "." BASILISK_RESOURCE_STORAGES_EXTENSION, str_file_path)
 
-/* Loads a storage file if not already and search for a resource in it, returning its data. */
-void *basilisk_entity_fetch_resource(basilisk_entity *entity, const char *str_storage_name, const char *str_file_path, unsigned long *out_size);
+/* Loads the index of a storage file if not already and maps a resource from it, returning its read-only data. */
+const void *basilisk_entity_fetch_resource(basilisk_entity *entity, const char *str_storage_name, const char *str_file_path, unsigned long *out_size);
 #define basilisk_entity_fetch_resource(entity, str_storage_name, str_file_path, out_size) basilisk_entity_fetch_resource(entity, BASILISK_RESOURCE_STORAGES_FOLDER "/" str_storage_name "." BASILISK_RESOURCE_STORAGES_EXTENSION, str_file_path, out_size)
 
+/* Tells the engine that an entity does not use a resource it fetched anymore. The resource's memory is released once no entity uses it. */
+void basilisk_entity_release_resource(basilisk_entity *entity, const char *str_storage_name, const char *str_file_path);
+#define basilisk_entity_release_resource(entity, str_storage_name, str_file_path) basilisk_entity_release_resource(entity, BASILISK_RESOURCE_STORAGES_FOLDER "/" str_storage_name "." BASILISK_RESOURCE_STORAGES_EXTENSION, str_file_path)
+
+/* Loads a storage file if not already and reads all of its resources in memory on a worker thread, sending progress events and an event once done. */
+void basilisk_entity_prefetch_storage(basilisk_entity *entity, const char *str_storage_name);
+#define basilisk_entity_prefetch_storage(entity, str_storage_name) basilisk_entity_prefetch_storage(entity, BASILISK_RESOURCE_STORAGES_FOLDER "/" str_storage_name "." BASILISK_RESOURCE_STORAGES_EXTENSION)
+
 #endif
@@ -23,6 +23,9 @@
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 
+/* Initialisation callback for a BE_event_relay_sdl entity. Sends the relayed events in order, and in batches. */
+static void BE_event_relay_sdl_init(basilisk_entity *self_data);
+
 /* Frame callback for a BE_event_relay_sdl entity. Polls new SDL Events and sends them back through the engine. */
 static void BE_event_relay_sdl_on_frame(basilisk_entity *self_data, float elapsed_ms);
 
@@ -34,7 +37,7 @@ static void BE_event_relay_sdl_on_frame(basilisk_entity *self_data, float elapse
  * @see ENTITY_DEF_EVENT_RELAY_SDL
  */
 typedef struct BE_event_relay_sdl {
-    /** Internal buffer to re-order the polled events. Overriden each frame. */
+    /** Internal buffer holding the polled events. Overriden each frame. */
     SDL_Event event_buffer[BE_EVENT_RELAY_SDL_BUFFER_SIZE];
 } BE_event_relay_sdl;
 
@@ -42,13 +45,26 @@ typedef struct BE_event_relay_sdl {
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 
+/**
+ * @brief Initialisation callback for a BE_event_relay_sdl entity.
+ *
+ * SDL uses a FIFO collection to handle events : the events relayed by the entity are dispatched in FIFO order too,
+ * so they are received in the order SDL received them. The "sdl event" events of a frame are gathered in a single
+ * batch, so that subscribers with a batch callback receive them all in one call.
+ *
+ * @param[inout] self_data pointer to a BE_event_relay_sdl object
+ */
+static void BE_event_relay_sdl_init(basilisk_entity *self_data)
+{
+    basilisk_entity_set_event_dispatch(self_data, "sdl event", BASILISK_EVENT_DISPATCH_BATCHED);
+    basilisk_entity_set_event_dispatch(self_data, "sdl event quit", BASILISK_EVENT_DISPATCH_FIFO);
+}
+
 /**
  * @brief Frame callback for a BE_event_relay_sdl entity.
  *
- * Polls events from the SDL library and resends them through the engine as an engine event.
- * SDL uses a FIFO collection to handle event, while the basilisk engine uses a FILO collection. On a frame,
- * the entity will poll the X first events, buffer them, and send them as events in the reverse order they were
- * received. This have the effect of stacking SDL events in the order SDL received them.
+ * Polls events from the SDL library and resends them through the engine as an engine event, in the order they were
+ * polled.
  *
  * @param[inout] self_data pointer to a BE_event_relay_sdl object
  * @param[in] elapsed_ms number of elapsed ms since last frame
@@ -59,18 +75,18 @@ static void BE_event_relay_sdl_on_frame(basilisk_entity *self_data, float elapse
 
     BE_event_relay_sdl *relay = (BE_event_relay_sdl *) self_data;
     SDL_Event event = { 0u };
-    size_t buffer_pos = 0u;
+    size_t buffer_length = 0u;
 
-    while ((buffer_pos < BE_EVENT_RELAY_SDL_BUFFER_SIZE) && SDL_PollEvent(&event)) {
-        relay->event_buffer[buffer_pos] = event;
-        buffer_pos += 1u;
+    while ((buffer_length < BE_EVENT_RELAY_SDL_BUFFER_SIZE) && SDL_PollEvent(&event)) {
+        relay->event_buffer[buffer_length] = event;
+        buffer_length += 1u;
     }
 
-    for ( ; buffer_pos > 0 ; buffer_pos--) {
-        if (relay->event_buffer[buffer_pos - 1].type == SDL_QUIT) {
-            basilisk_entity_stack_event(self_data, "sdl event quit", (basilisk_specific_event) { .is_detached = true });
+    for (size_t buffer_pos = 0u ; buffer_pos < buffer_length ; buffer_pos++) {
+        if (relay->event_buffer[buffer_pos].type == SDL_QUIT) {
+            basilisk_entity_stack_event(self_data, "sdl event quit", (basilisk_specific_event) { .is_detached = true, .is_input = true });
         } else {
-            basilisk_entity_stack_event(self_data, "sdl event", (basilisk_specific_event) { .is_detached = false, .data_size = sizeof(*relay->event_buffer), .data = relay->event_buffer + buffer_pos - 1, });
+            basilisk_entity_stack_event(self_data, "sdl event", (basilisk_specific_event) { .is_detached = false, .is_input = true, .data_size = sizeof(*relay->event_buffer), .data = relay->event_buffer + buffer_pos, });
         }
     }
 }
@@ -85,7 +101,11 @@ static void BE_event_relay_sdl_on_frame(basilisk_entity *self_data, float elapse
  * @brief Defines the entity properties of a BE_event_relay_sdl entity
  *
  * The goal of this entity is to poll sdl events and retransmit them through the engine's event stack. It might be a child of a BE_sdl_context entity.
- * The events transfered are stacked in a way that reflects the order they were polled : the later the event is polled, the deeper it will be placed on the event stack.
+ * The events transfered are dispatched in FIFO order : they are received in the order they were polled.
+ * The "sdl event" events polled on a frame are sent as one batch : a subscription's batch_callback receives the array of
+ * all SDL_Event objects at once, while a plain callback still receives them one after the other.
+ * Subscribers only interested in some kinds of SDL events can filter them on their type, and are not called for the others :
+ * `.filter = { .offset = offsetof(SDL_Event, type), .size = sizeof(Uint32), .mask = ~0ull, .value = SDL_KEYDOWN }`.
  *
  * This entity might send two events : "sdl event" and "sdl event quit"
  *  - "sdl event" is associated to a pointer to a SDL_Event object. It is one of the SDL events the entity polled on last frame.
@@ -96,6 +116,7 @@ static void BE_event_relay_sdl_on_frame(basilisk_entity *self_data, float elapse
  */
 const basilisk_entity_definition ENTITY_DEF_EVENT_RELAY_SDL = {
         .data_size = sizeof(BE_event_relay_sdl),
+        .on_init = &BE_event_relay_sdl_init,
         .on_frame = &BE_event_relay_sdl_on_frame,
 };
 
@@ -62,6 +62,7 @@ static void BE_render_manager_sdl_post_draw(basilisk_entity *self_data, void *ev
  * @brief Initialisation callback for a BE_render_manager_sdl entity.
  * Initialises the data of a render manager, creating a renderer and buffer to organize draw operations.
  * The renderer is bound to a parent BE_window_sdl entity. If no such entity is found, the renderer will not be created.
+ * The draw events are dispatched in FIFO order, so they are received in the order they are stacked.
  *
  * @see BE_render_manager_sdl, ENTITY_DEF_RENDER_MANAGER_SDL
  *
@@ -79,6 +80,10 @@ static void BE_render_manager_sdl_init(basilisk_entity *self_data)
 
     init_data->renderer = SDL_CreateRenderer(parent_window, -1, init_data->flags);
 
+    basilisk_entity_set_event_dispatch(self_data, "sdl renderer pre draw", BASILISK_EVENT_DISPATCH_FIFO);
+    basilisk_entity_set_event_dispatch(self_data, "sdl renderer draw", BASILISK_EVENT_DISPATCH_FIFO);
+    basilisk_entity_set_event_dispatch(self_data, "sdl renderer post draw", BASILISK_EVENT_DISPATCH_FIFO);
+
     if (init_data->renderer) {
         init_data->buffer = SDL_CreateTexture(init_data->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, (int) init_data->w, (int) init_data->h);
 
@@ -110,7 +115,8 @@ static void BE_render_manager_sdl_deinit(basilisk_entity *self_data)
 
 /**
  * @brief Frame callback for a BE_render_manager_sdl entity.
- * Queue events to order drawing operations.
+ * Queue events to order drawing operations. The events are scoped to the render manager's subtree, so that entities
+ * only draw with the renderer they are placed under.
  *
  * @see BE_render_manager_sdl, BE_render_manager_sdl_event_draw
  *
@@ -125,9 +131,9 @@ static void BE_render_manager_sdl_on_frame(basilisk_entity *self_data, float ela
 
     BE_render_manager_sdl *data = (BE_render_manager_sdl *) self_data;
 
-    basilisk_entity_stack_event(self_data, "sdl renderer post draw", (basilisk_specific_event) { 0u });
-    basilisk_entity_stack_event(self_data, "sdl renderer draw", (basilisk_specific_event) { .data_size = sizeof(BE_render_manager_sdl_event_draw), .data = &(BE_render_manager_sdl_event_draw) { data->renderer } });
-    basilisk_entity_stack_event(self_data, "sdl renderer pre draw", (basilisk_specific_event) { 0u });
+    basilisk_entity_stack_event_scoped(self_data, self_data, "sdl renderer pre draw", (basilisk_specific_event) { 0u });
+    basilisk_entity_stack_event_scoped(self_data, self_data, "sdl renderer draw", (basilisk_specific_event) { .data_size = sizeof(BE_render_manager_sdl_event_draw), .data = &(BE_render_manager_sdl_event_draw) { data->renderer } });
+    basilisk_entity_stack_event_scoped(self_data, self_data, "sdl renderer post draw", (basilisk_specific_event) { 0u });
 }
 
 /**
@@ -187,7 +193,7 @@ static void BE_render_manager_sdl_post_draw(basilisk_entity *self_data, void *ev
 /**
  * @brief Defines the properties of a BE_render_manager_sdl entity.
  *
- * This entity exists to organize drawing operation in a single time unit. To achieve that, the entity will send three events on each frame : "sdl renderer pre draw", "sdl renderer draw" and "sdl renderer post draw". Those three events are guaranteed to be resolved in this specific order, and entities that want to call SDL drawing functions can do so when receiving a "sdl renderer draw" event, which is associated to the `BE_render_manager_sdl_event_draw` data structure.
+ * This entity exists to organize drawing operation in a single time unit. To achieve that, the entity will send three events on each frame : "sdl renderer pre draw", "sdl renderer draw" and "sdl renderer post draw". Those three events are guaranteed to be resolved in this specific order, and entities that want to call SDL drawing functions can do so when receiving a "sdl renderer draw" event, which is associated to the `BE_render_manager_sdl_event_draw` data structure. The events are only sent to entities in the subtree of the render manager : with several windows, each entity draws on the window of the render manager it is placed under.
  *
  * This entity might send three events :
  * - "sdl renderer pre draw", not associated to any data, to notify that drawing operations will happen next ;
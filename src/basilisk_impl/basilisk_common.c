@@ -10,6 +10,7 @@
  */
 #include <stdio.h>
 #include <math.h>
+#include <time.h>
 
 #include "basilisk_common.h"
 
@@ -242,6 +243,23 @@ i32 identifier_compare(const void *lhs, const void *rhs)
     return range_compare(&RANGE_TO_ANY(name_lhs), &RANGE_TO_ANY(name_rhs), &identifier_compare_character);
 }
 
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the current time of the system's monotonic clock, in milliseconds. Only differences between two
+ * returned values are meaningful.
+ *
+ * @return f64
+ */
+f64 time_monotonic_ms(void)
+{
+    struct timespec now = { 0u };
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((f64) now.tv_sec * 1000.) + ((f64) now.tv_nsec / 1000000.);
+}
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -74,6 +74,11 @@ i32 identifier_compare_doubleref(const void *lhs, const void *rhs);
 /* Compares two identifiers. */
 i32 identifier_compare(const void *lhs, const void *rhs);
 
+// -------------------------------------------------------------------------------------------------
+
+/* Returns a point in time, in milliseconds, from a clock that cannot jump. */
+f64 time_monotonic_ms(void);
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
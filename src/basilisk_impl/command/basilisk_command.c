@@ -11,6 +11,8 @@
 
 #include "basilisk_command.h"
 
+#include "../inbox/basilisk_inbox.h"
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -21,6 +23,8 @@
 typedef struct command_queue {
     /** Range of commands. */
     RANGE(command) *queue_impl;
+    /** Commands appended from other threads, waiting to be moved to the range. */
+    mpsc_inbox *inbox;
 } command_queue;
 
 // -------------------------------------------------------------------------------------------------
@@ -66,7 +70,7 @@ command command_create_subscribe_to_event(basilisk_engine_entity *source, const
 {
     command new_cmd = { 0u };
 
-    if (!source || !event_name || !subscription_data.callback) {
+    if (!source || !event_name || (!subscription_data.callback && !subscription_data.batch_callback && !subscription_data.trampoline)) {
         return (command) { .flavor = COMMAND_INVALID };
     }
 
@@ -83,6 +87,33 @@ command command_create_subscribe_to_event(basilisk_engine_entity *source, const
     return new_cmd;
 }
 
+/**
+ * @brief Creates a command to revoke a subscription made by an entity.
+ *
+ * @param[in] source Entity that sent the command.
+ * @param[in] handle Handle of the subscription.
+ * @param[inout] alloc Allocator used for the allocation of the command.
+ * @return A fresh command to be queued.
+ */
+command command_create_unsubscribe_from_event(basilisk_engine_entity *source, u64 handle, allocator alloc)
+{
+    command new_cmd = { 0u };
+
+    if (!source || (handle == 0u)) {
+        return (command) { .flavor = COMMAND_INVALID };
+    }
+
+    new_cmd = (command) {
+            .flavor = COMMAND_UNSUBSCRIBE_FROM_EVENT,
+            .source = source,
+            .specific.unsubscribe_from_event = {
+                    .handle = handle,
+            },
+    };
+
+    return new_cmd;
+}
+
 // -------------------------------------------------------------------------------------------------
 
 /**
@@ -106,6 +137,9 @@ void command_destroy(command *cmd, allocator alloc)
         range_destroy_dynamic(alloc, &RANGE_TO_ANY(cmd->specific.subscribe_to_event.target_event_name));
         break;
 
+    case COMMAND_UNSUBSCRIBE_FROM_EVENT:
+        break;
+
     default:
         break;
     }
@@ -132,6 +166,7 @@ command_queue *command_queue_create(allocator alloc)
     if (new_queue) {
         *new_queue = (command_queue) {
             .queue_impl = range_create_dynamic(alloc, sizeof(*new_queue->queue_impl->data), BASILISK_COLLECTIONS_START_LENGTH),
+            .inbox = mpsc_inbox_create(sizeof(command), alloc),
         };
     }
 
@@ -150,6 +185,9 @@ void command_queue_destroy(command_queue **queue, allocator alloc)
         return;
     }
 
+    command_queue_drain_inbox(*queue, alloc);
+    mpsc_inbox_destroy(&(*queue)->inbox, alloc);
+
     for (size_t i = 0u ; i < (*queue)->queue_impl->length ; i++) {
         command_destroy((*queue)->queue_impl->data + i, alloc);
     }
@@ -178,6 +216,44 @@ void command_queue_append(command_queue *queue, command cmd, allocator alloc)
     range_insert_value(RANGE_TO_ANY(queue->queue_impl), queue->queue_impl->length, &cmd);
 }
 
+/**
+ * @brief Adds a command to the inbox of a queue. The queue assumes ownership of the command.
+ * Unlike `command_queue_append()`, this function can be called from any thread : the command will join the queue on the
+ * next call to `command_queue_drain_inbox()`.
+ *
+ * @param[inout] queue Command queue to be extended.
+ * @param[in] cmd Queued command.
+ * @param[inout] alloc Thread-safe allocator used to store the command in the inbox.
+ */
+void command_queue_append_threadsafe(command_queue *queue, command cmd, allocator alloc)
+{
+    if (!queue || (cmd.flavor == COMMAND_INVALID)) {
+        return;
+    }
+
+    mpsc_inbox_push(queue->inbox, &cmd, alloc);
+}
+
+/**
+ * @brief Moves all commands received in the inbox of a queue to the end of the queue, in the order they were received.
+ * Must be called from the thread owning the queue.
+ *
+ * @param[inout] queue Target command queue.
+ * @param[inout] alloc Allocator used to extend the queue.
+ */
+void command_queue_drain_inbox(command_queue *queue, allocator alloc)
+{
+    command received = { 0u };
+
+    if (!queue) {
+        return;
+    }
+
+    while (mpsc_inbox_pop(queue->inbox, &received, alloc)) {
+        command_queue_append(queue, received, alloc);
+    }
+}
+
 /**
  * @brief Returns the command at the front of a queue, i.e. the oldest command. The command is removed from the queue.
  *
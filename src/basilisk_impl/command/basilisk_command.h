@@ -32,6 +32,7 @@ typedef enum command_flavor {
     COMMAND_INVALID = 0,            /// flags an error value
     COMMAND_REMOVE_ENTITY,          /// flags a command to remove an entity
     COMMAND_SUBSCRIBE_TO_EVENT,     /// flags a command to subscribe an entity to an event
+    COMMAND_UNSUBSCRIBE_FROM_EVENT, /// flags a command to revoke a subscription of an entity
 } command_flavor;
 
 // -------------------------------------------------------------------------------------------------
@@ -56,10 +57,22 @@ typedef struct command_subscribe_to_event {
     basilisk_engine_entity *subscribed;
     /** Registered callback information. */
     basilisk_specific_event_subscription subscription_data;
+    /** Handle reserved for the subscription. */
+    u64 handle;
 } command_subscribe_to_event;
 
 // -------------------------------------------------------------------------------------------------
 
+/**
+ * @brief Specific data layout for a command to revoke a subscription.
+ */
+typedef struct command_unsubscribe_from_event {
+    /** Handle of the revoked subscription. */
+    u64 handle;
+} command_unsubscribe_from_event;
+
+// -------------------------------------------------------------------------------------------------
+
 /**
  * @brief General command queued in the engine.
  */
@@ -75,6 +88,8 @@ typedef struct command {
         command_remove_entity remove_entity;
         /** COMMAND_SUBSCRIBE_TO_EVENT */
         command_subscribe_to_event subscribe_to_event;
+        /** COMMAND_UNSUBSCRIBE_FROM_EVENT */
+        command_unsubscribe_from_event unsubscribe_from_event;
     } specific;
 } command;
 
@@ -86,6 +101,8 @@ typedef struct command {
 command command_create_remove_entity(basilisk_engine_entity *source, allocator alloc);
 /* Creates a command to subscribe an entity and a callback to an event. */
 command command_create_subscribe_to_event(basilisk_engine_entity *source, const char *event_name, basilisk_specific_event_subscription subscription_data, allocator alloc);
+/* Creates a command to revoke a subscription of an entity. */
+command command_create_unsubscribe_from_event(basilisk_engine_entity *source, u64 handle, allocator alloc);
 
 // -------------------------------------------------------------------------------------------------
 
@@ -105,6 +122,10 @@ void command_queue_destroy(command_queue **queue, allocator alloc);
 
 /* Adds a command to the queue. */
 void command_queue_append(command_queue *queue, command cmd, allocator alloc);
+/* Adds a command to the inbox of the queue, from any thread. */
+void command_queue_append_threadsafe(command_queue *queue, command cmd, allocator alloc);
+/* Moves the commands received in the inbox of the queue at the end of the queue. */
+void command_queue_drain_inbox(command_queue *queue, allocator alloc);
 /* Removes the oldest command from the queue and returns it */
 command command_queue_pop_front(command_queue *queue);
 /* Returns the number of currently stored commands in the queue. */
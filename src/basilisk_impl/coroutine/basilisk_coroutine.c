@@ -0,0 +1,580 @@
+/**
+ * @file basilisk_coroutine.c
+ * @author gabriel ()
+ * @brief Implementation file for the coroutine scheduler.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <ustd/sorting.h>
+
+#include "basilisk_coroutine.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Kinds of conditions a coroutine can wait for.
+ */
+typedef enum coroutine_wait_kind {
+    /** The coroutine returned without waiting : it is finished. */
+    COROUTINE_WAIT_NONE,
+    /** The coroutine waits for a frame. */
+    COROUTINE_WAIT_FRAMES,
+    /** The coroutine waits for a point in time. */
+    COROUTINE_WAIT_DURATION,
+    /** The coroutine waits for an event to be sent. */
+    COROUTINE_WAIT_EVENT,
+} coroutine_wait_kind;
+
+/**
+ * @brief Single coroutine tied to an entity, followed by its data.
+ */
+typedef struct coroutine_entry {
+    /** State shared with the coroutine's body. */
+    basilisk_coroutine state;
+    /** Non-owned reference to the scheduler holding the coroutine. */
+    coroutine_scheduler *scheduler;
+
+    /** Entity the coroutine is tied to. */
+    basilisk_engine_entity *source;
+    /** Function executed each time the coroutine resumes. */
+    void (*body)(basilisk_entity *self_data, basilisk_coroutine *coroutine);
+
+    /** Condition the coroutine waits for, set by the last await. */
+    coroutine_wait_kind wait_kind;
+    /** Frame at which the coroutine resumes, if it waits for frames. */
+    u64 wake_frame;
+    /** Time at which the coroutine resumes, if it waits for a duration. */
+    f64 wake_time_ms;
+    /** Name of the event the coroutine waits for, until the coroutine is parked. */
+    identifier *awaited_event;
+
+    /** Copy of the coroutine's data. */
+    byte data[];
+} coroutine_entry;
+
+/**
+ * @brief Coroutines waiting for the same event.
+ */
+typedef struct coroutine_event_waiters {
+    /** Name of the event. */
+    identifier *name;
+    /** Coroutines waiting for the event, in the order they started waiting. */
+    RANGE(coroutine_entry *) *waiters;
+} coroutine_event_waiters;
+
+/**
+ * @brief Collection of coroutines waiting to be resumed.
+ */
+typedef struct coroutine_scheduler {
+    /** Thread-safe copy of the engine's allocator, used by the coroutines to copy the names of the events they wait for. */
+    allocator alloc;
+
+    /** Number of steps of the scheduler. */
+    u64 frame;
+    /** Milliseconds accumulated by the steps of the scheduler. */
+    f64 now_ms;
+    /** Number of coroutines in the scheduler. */
+    size_t length;
+
+    /** Coroutines waiting for a frame, sorted from the latest to the earliest. */
+    RANGE(coroutine_entry *) *by_frame;
+    /** Coroutines waiting for a point in time, sorted from the latest to the earliest. */
+    RANGE(coroutine_entry *) *by_time;
+    /** Coroutines waiting for an event, sorted by event name. */
+    RANGE(coroutine_event_waiters) *by_event;
+    /** Coroutines about to be resumed. */
+    RANGE(coroutine_entry *) *ready;
+} coroutine_scheduler;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Places a coroutine in the collection matching the condition it waits for, or releases it if it is finished. */
+static void coroutine_scheduler_park(coroutine_scheduler *scheduler, coroutine_entry *entry, allocator alloc);
+
+/* Resumes all coroutines flagged as ready. */
+static void coroutine_scheduler_resume_ready(coroutine_scheduler *scheduler, void *event_data, allocator alloc);
+
+/* Releases a coroutine. */
+static void coroutine_scheduler_release(coroutine_scheduler *scheduler, coroutine_entry *entry, allocator alloc);
+
+/* Releases all coroutines of a collection tied to an entity. */
+static void coroutine_scheduler_release_from(coroutine_scheduler *scheduler, coroutine_entry **entries, size_t *length, basilisk_engine_entity *source, allocator alloc);
+
+/* Clears the condition a coroutine waits for. */
+static void coroutine_entry_reset_wait(coroutine_entry *entry);
+
+/* Compares two coroutines by decreasing wake-up frame. */
+static i32 coroutine_entry_compare_wake_frame(const void *lhs, const void *rhs);
+
+/* Compares two coroutines by decreasing wake-up time. */
+static i32 coroutine_entry_compare_wake_time(const void *lhs, const void *rhs);
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates an empty coroutine scheduler.
+ *
+ * @param[inout] alloc Allocator used for the creation.
+ * @return coroutine_scheduler *
+ */
+coroutine_scheduler *coroutine_scheduler_create(allocator alloc)
+{
+    coroutine_scheduler *new_scheduler = nullptr;
+
+    new_scheduler = alloc.malloc(alloc, sizeof(*new_scheduler));
+
+    if (new_scheduler) {
+        *new_scheduler = (coroutine_scheduler) {
+                .alloc = alloc,
+                .by_frame = range_create_dynamic(alloc, sizeof(*new_scheduler->by_frame->data), BASILISK_COLLECTIONS_START_LENGTH),
+                .by_time = range_create_dynamic(alloc, sizeof(*new_scheduler->by_time->data), BASILISK_COLLECTIONS_START_LENGTH),
+                .by_event = range_create_dynamic(alloc, sizeof(*new_scheduler->by_event->data), BASILISK_COLLECTIONS_START_LENGTH),
+                .ready = range_create_dynamic(alloc, sizeof(*new_scheduler->ready->data), BASILISK_COLLECTIONS_START_LENGTH),
+        };
+    }
+
+    return new_scheduler;
+}
+
+/**
+ * @brief Releases the memory taken by a coroutine scheduler and all of its coroutines, and nullifies the pointer passed.
+ *
+ * @param[inout] scheduler Object to destroy.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void coroutine_scheduler_destroy(coroutine_scheduler **scheduler, allocator alloc)
+{
+    if (!scheduler || !*scheduler) {
+        return;
+    }
+
+    coroutine_scheduler_remove_coroutines_of(*scheduler, nullptr, alloc);
+
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*scheduler)->ready));
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*scheduler)->by_event));
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*scheduler)->by_time));
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*scheduler)->by_frame));
+
+    alloc.free(alloc, *scheduler);
+    *scheduler = nullptr;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Copies a coroutine and its data, and ties it to an entity. The coroutine's body is executed for the first
+ * time on the next step of the scheduler.
+ *
+ * @param[inout] scheduler Target scheduler.
+ * @param[in] source Entity the coroutine is tied to.
+ * @param[in] coroutine_data Description of the coroutine. Its data is copied.
+ * @param[inout] alloc Allocator used for the copy.
+ */
+void coroutine_scheduler_start(coroutine_scheduler *scheduler, basilisk_engine_entity *source, basilisk_specific_coroutine coroutine_data, allocator alloc)
+{
+    coroutine_entry *new_entry = nullptr;
+
+    if (!scheduler || !coroutine_data.body) {
+        return;
+    }
+
+    new_entry = alloc.malloc(alloc, sizeof(*new_entry) + coroutine_data.data_size);
+
+    if (!new_entry) {
+        return;
+    }
+
+    *new_entry = (coroutine_entry) {
+            .scheduler = scheduler,
+            .source = source,
+            .body = coroutine_data.body,
+            .wait_kind = COROUTINE_WAIT_FRAMES,
+            .wake_frame = scheduler->frame + 1u,
+    };
+
+    if (coroutine_data.data && (coroutine_data.data_size > 0u)) {
+        bytewise_copy(new_entry->data, coroutine_data.data, coroutine_data.data_size);
+        new_entry->state.data = new_entry->data;
+    }
+
+    scheduler->length += 1u;
+    coroutine_scheduler_park(scheduler, new_entry, alloc);
+}
+
+/**
+ * @brief Removes and releases all coroutines tied to an entity, wherever they wait. If no entity is given, all
+ * coroutines are removed.
+ *
+ * @param[inout] scheduler Target scheduler.
+ * @param[in] source Entity whose coroutines are removed. Can be nullptr.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void coroutine_scheduler_remove_coroutines_of(coroutine_scheduler *scheduler, basilisk_engine_entity *source, allocator alloc)
+{
+    if (!scheduler) {
+        return;
+    }
+
+    coroutine_scheduler_release_from(scheduler, scheduler->by_frame->data, &scheduler->by_frame->length, source, alloc);
+    coroutine_scheduler_release_from(scheduler, scheduler->by_time->data, &scheduler->by_time->length, source, alloc);
+    coroutine_scheduler_release_from(scheduler, scheduler->ready->data, &scheduler->ready->length, source, alloc);
+
+    for (size_t i = scheduler->by_event->length ; i > 0u ; i--) {
+        coroutine_event_waiters *list = scheduler->by_event->data + (i - 1u);
+
+        coroutine_scheduler_release_from(scheduler, list->waiters->data, &list->waiters->length, source, alloc);
+
+        if (list->waiters->length == 0u) {
+            range_destroy_dynamic(alloc, &RANGE_TO_ANY(list->name));
+            range_destroy_dynamic(alloc, &RANGE_TO_ANY(list->waiters));
+            range_remove(RANGE_TO_ANY(scheduler->by_event), i - 1u);
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Moves the scheduler forward by one frame and some time, and resumes all coroutines whose awaited frame or
+ * time is reached, from the earliest to the latest. Coroutines waiting again are resumed on a later step at the
+ * earliest.
+ *
+ * @param[inout] scheduler Target scheduler.
+ * @param[in] elapsed_ms Milliseconds elapsed since the last step.
+ * @param[inout] alloc Allocator used to move the coroutines around.
+ */
+void coroutine_scheduler_advance(coroutine_scheduler *scheduler, f32 elapsed_ms, allocator alloc)
+{
+    coroutine_entry *entry = nullptr;
+
+    if (!scheduler) {
+        return;
+    }
+
+    scheduler->frame += 1u;
+    scheduler->now_ms += (f64) elapsed_ms;
+
+    while ((scheduler->by_frame->length > 0u) && (scheduler->by_frame->data[scheduler->by_frame->length - 1u]->wake_frame <= scheduler->frame)) {
+        entry = scheduler->by_frame->data[scheduler->by_frame->length - 1u];
+        range_remove(RANGE_TO_ANY(scheduler->by_frame), scheduler->by_frame->length - 1u);
+
+        scheduler->ready = range_ensure_capacity(alloc, RANGE_TO_ANY(scheduler->ready), 1);
+        range_insert_value(RANGE_TO_ANY(scheduler->ready), scheduler->ready->length, &entry);
+    }
+
+    while ((scheduler->by_time->length > 0u) && (scheduler->by_time->data[scheduler->by_time->length - 1u]->wake_time_ms <= scheduler->now_ms)) {
+        entry = scheduler->by_time->data[scheduler->by_time->length - 1u];
+        range_remove(RANGE_TO_ANY(scheduler->by_time), scheduler->by_time->length - 1u);
+
+        scheduler->ready = range_ensure_capacity(alloc, RANGE_TO_ANY(scheduler->ready), 1);
+        range_insert_value(RANGE_TO_ANY(scheduler->ready), scheduler->ready->length, &entry);
+    }
+
+    coroutine_scheduler_resume_ready(scheduler, nullptr, alloc);
+}
+
+/**
+ * @brief Resumes all coroutines waiting for an event, in the order they started waiting. The event's data is
+ * available to the coroutines until they return. Coroutines waiting again for the same event are resumed by a later
+ * event. A scoped event only resumes the coroutines of entities in its subtree.
+ *
+ * @param[inout] scheduler Target scheduler.
+ * @param[in] ev Event being sent.
+ * @param[inout] alloc Allocator used to move the coroutines around.
+ */
+void coroutine_scheduler_notify_event(coroutine_scheduler *scheduler, event ev, allocator alloc)
+{
+    size_t list_pos = 0u;
+    size_t waiter_pos = 0u;
+    coroutine_event_waiters list = { 0u };
+
+    if (!scheduler || !ev.name) {
+        return;
+    }
+
+    if (!sorted_range_find_in(RANGE_TO_ANY(scheduler->by_event), &identifier_compare, &(ev.name), &list_pos)) {
+        return;
+    }
+
+    list = scheduler->by_event->data[list_pos];
+
+    if (ev.scope) {
+        while (waiter_pos < list.waiters->length) {
+            if (basilisk_engine_entity_is_in_subtree(list.waiters->data[waiter_pos]->source, ev.scope)) {
+                scheduler->ready = range_ensure_capacity(alloc, RANGE_TO_ANY(scheduler->ready), 1);
+                range_insert_value(RANGE_TO_ANY(scheduler->ready), scheduler->ready->length, list.waiters->data + waiter_pos);
+                range_remove(RANGE_TO_ANY(list.waiters), waiter_pos);
+            } else {
+                waiter_pos += 1u;
+            }
+        }
+    } else {
+        scheduler->ready = range_ensure_capacity(alloc, RANGE_TO_ANY(scheduler->ready), list.waiters->length);
+        range_insert_range(RANGE_TO_ANY(scheduler->ready), scheduler->ready->length, RANGE_TO_ANY(list.waiters));
+        range_clear(RANGE_TO_ANY(list.waiters));
+    }
+
+    if (list.waiters->length == 0u) {
+        range_remove(RANGE_TO_ANY(scheduler->by_event), list_pos);
+        range_destroy_dynamic(alloc, &RANGE_TO_ANY(list.name));
+        range_destroy_dynamic(alloc, &RANGE_TO_ANY(list.waiters));
+    }
+
+    coroutine_scheduler_resume_ready(scheduler, ev.data, alloc);
+}
+
+/**
+ * @brief Returns the number of coroutines in the scheduler, waiting or running.
+ *
+ * @param[in] scheduler Target scheduler.
+ * @return size_t
+ */
+size_t coroutine_scheduler_length(const coroutine_scheduler *scheduler)
+{
+    if (!scheduler) {
+        return 0u;
+    }
+
+    return scheduler->length;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Flags a running coroutine to be resumed after some frames once its body returns. Waiting for zero frames
+ * waits for the next frame.
+ *
+ * @param[inout] coroutine State of the running coroutine.
+ * @param[in] frames_count Number of frames to wait for.
+ */
+void coroutine_await_frames(basilisk_coroutine *coroutine, u64 frames_count)
+{
+    coroutine_entry *entry = nullptr;
+
+    if (!coroutine) {
+        return;
+    }
+
+    entry = CONTAINER_OF(coroutine, coroutine_entry, state);
+    coroutine_entry_reset_wait(entry);
+
+    entry->wait_kind = COROUTINE_WAIT_FRAMES;
+    entry->wake_frame = entry->scheduler->frame + ((frames_count > 0u) ? frames_count : 1u);
+}
+
+/**
+ * @brief Flags a running coroutine to be resumed after some duration once its body returns. The coroutine is resumed
+ * on the first frame reaching the duration.
+ *
+ * @param[inout] coroutine State of the running coroutine.
+ * @param[in] duration_ms Number of milliseconds to wait for.
+ */
+void coroutine_await_duration(basilisk_coroutine *coroutine, f64 duration_ms)
+{
+    coroutine_entry *entry = nullptr;
+
+    if (!coroutine) {
+        return;
+    }
+
+    entry = CONTAINER_OF(coroutine, coroutine_entry, state);
+    coroutine_entry_reset_wait(entry);
+
+    entry->wait_kind = COROUTINE_WAIT_DURATION;
+    entry->wake_time_ms = entry->scheduler->now_ms + duration_ms;
+}
+
+/**
+ * @brief Flags a running coroutine to be resumed by the next event of some name once its body returns. If the name
+ * is not a valid identifier, the coroutine is finished instead.
+ *
+ * @param[inout] coroutine State of the running coroutine.
+ * @param[in] str_event_name Null-terminated string (copied) of the name of the awaited event.
+ */
+void coroutine_await_event(basilisk_coroutine *coroutine, const char *str_event_name)
+{
+    coroutine_entry *entry = nullptr;
+
+    if (!coroutine || !str_event_name) {
+        return;
+    }
+
+    entry = CONTAINER_OF(coroutine, coroutine_entry, state);
+    coroutine_entry_reset_wait(entry);
+
+    entry->awaited_event = identifier_from_cstring(str_event_name, entry->scheduler->alloc);
+    if (entry->awaited_event) {
+        entry->wait_kind = COROUTINE_WAIT_EVENT;
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Places a coroutine in the collection matching the condition it waits for. Finished coroutines are released.
+ *
+ * @param[inout] scheduler Target scheduler.
+ * @param[inout] entry Parked coroutine.
+ * @param[inout] alloc Allocator used to extend the collections.
+ */
+static void coroutine_scheduler_park(coroutine_scheduler *scheduler, coroutine_entry *entry, allocator alloc)
+{
+    size_t list_pos = 0u;
+    coroutine_event_waiters created_list = { 0u };
+
+    switch (entry->wait_kind) {
+        case COROUTINE_WAIT_FRAMES:
+            scheduler->by_frame = range_ensure_capacity(alloc, RANGE_TO_ANY(scheduler->by_frame), 1);
+            (void) sorted_range_insert_in(RANGE_TO_ANY(scheduler->by_frame), &coroutine_entry_compare_wake_frame, &entry);
+            break;
+
+        case COROUTINE_WAIT_DURATION:
+            scheduler->by_time = range_ensure_capacity(alloc, RANGE_TO_ANY(scheduler->by_time), 1);
+            (void) sorted_range_insert_in(RANGE_TO_ANY(scheduler->by_time), &coroutine_entry_compare_wake_time, &entry);
+            break;
+
+        case COROUTINE_WAIT_EVENT:
+            if (!sorted_range_find_in(RANGE_TO_ANY(scheduler->by_event), &identifier_compare, &(entry->awaited_event), &list_pos)) {
+                created_list = (coroutine_event_waiters) {
+                        .name = entry->awaited_event,
+                        .waiters = range_create_dynamic(alloc, sizeof(*created_list.waiters->data), BASILISK_COLLECTIONS_START_LENGTH),
+                };
+                entry->awaited_event = nullptr;
+
+                scheduler->by_event = range_ensure_capacity(alloc, RANGE_TO_ANY(scheduler->by_event), 1);
+                list_pos = sorted_range_insert_in(RANGE_TO_ANY(scheduler->by_event), &identifier_compare, &created_list);
+            }
+            coroutine_entry_reset_wait(entry);
+            entry->wait_kind = COROUTINE_WAIT_EVENT;
+
+            scheduler->by_event->data[list_pos].waiters = range_ensure_capacity(alloc, RANGE_TO_ANY(scheduler->by_event->data[list_pos].waiters), 1);
+            range_insert_value(RANGE_TO_ANY(scheduler->by_event->data[list_pos].waiters), scheduler->by_event->data[list_pos].waiters->length, &entry);
+            break;
+
+        default:
+            coroutine_scheduler_release(scheduler, entry, alloc);
+            break;
+    }
+}
+
+/**
+ * @brief Resumes, in order, all coroutines flagged as ready, then parks them again according to what they wait for.
+ *
+ * @param[inout] scheduler Target scheduler.
+ * @param[in] event_data Data of the event resuming the coroutines. Can be nullptr.
+ * @param[inout] alloc Allocator used to park the coroutines.
+ */
+static void coroutine_scheduler_resume_ready(coroutine_scheduler *scheduler, void *event_data, allocator alloc)
+{
+    coroutine_entry *entry = nullptr;
+
+    for (size_t i = 0u ; i < scheduler->ready->length ; i++) {
+        entry = scheduler->ready->data[i];
+
+        coroutine_entry_reset_wait(entry);
+        entry->state.event_data = event_data;
+        entry->body(basilisk_engine_entity_get_specific_data(entry->source), &entry->state);
+        entry->state.event_data = nullptr;
+
+        coroutine_scheduler_park(scheduler, entry, alloc);
+    }
+
+    range_clear(RANGE_TO_ANY(scheduler->ready));
+}
+
+/**
+ * @brief Releases the memory taken by a coroutine that was removed from all collections.
+ *
+ * @param[inout] scheduler Scheduler that held the coroutine.
+ * @param[inout] entry Released coroutine.
+ * @param[inout] alloc Allocator used for the free.
+ */
+static void coroutine_scheduler_release(coroutine_scheduler *scheduler, coroutine_entry *entry, allocator alloc)
+{
+    coroutine_entry_reset_wait(entry);
+    alloc.free(alloc, entry);
+
+    scheduler->length -= 1u;
+}
+
+/**
+ * @brief Removes and releases all coroutines of a collection tied to an entity, keeping the order of the others.
+ * If no entity is given, all coroutines of the collection are released.
+ *
+ * @param[inout] scheduler Target scheduler.
+ * @param[inout] entries Contents of the collection.
+ * @param[inout] length Length of the collection, updated by the function.
+ * @param[in] source Entity whose coroutines are removed. Can be nullptr.
+ * @param[inout] alloc Allocator used for the free.
+ */
+static void coroutine_scheduler_release_from(coroutine_scheduler *scheduler, coroutine_entry **entries, size_t *length, basilisk_engine_entity *source, allocator alloc)
+{
+    size_t kept = 0u;
+
+    for (size_t i = 0u ; i < *length ; i++) {
+        if (!source || (entries[i]->source == source)) {
+            coroutine_scheduler_release(scheduler, entries[i], alloc);
+        } else {
+            entries[kept] = entries[i];
+            kept += 1u;
+        }
+    }
+
+    *length = kept;
+}
+
+/**
+ * @brief Clears the condition a coroutine waits for, releasing the name of the event it might wait for.
+ *
+ * @param[inout] entry Target coroutine.
+ */
+static void coroutine_entry_reset_wait(coroutine_entry *entry)
+{
+    if (entry->awaited_event) {
+        range_destroy_dynamic(entry->scheduler->alloc, &RANGE_TO_ANY(entry->awaited_event));
+    }
+
+    entry->wait_kind = COROUTINE_WAIT_NONE;
+}
+
+/**
+ * @brief Compares two coroutines stored by reference, the one waking up later coming first.
+ *
+ * @param[in] lhs Pointer to a coroutine pointer.
+ * @param[in] rhs Pointer to a coroutine pointer.
+ * @return i32
+ */
+static i32 coroutine_entry_compare_wake_frame(const void *lhs, const void *rhs)
+{
+    const coroutine_entry *lhs_entry = *(coroutine_entry * const *) lhs;
+    const coroutine_entry *rhs_entry = *(coroutine_entry * const *) rhs;
+
+    return (lhs_entry->wake_frame < rhs_entry->wake_frame) - (lhs_entry->wake_frame > rhs_entry->wake_frame);
+}
+
+/**
+ * @brief Compares two coroutines stored by reference, the one waking up later coming first.
+ *
+ * @param[in] lhs Pointer to a coroutine pointer.
+ * @param[in] rhs Pointer to a coroutine pointer.
+ * @return i32
+ */
+static i32 coroutine_entry_compare_wake_time(const void *lhs, const void *rhs)
+{
+    const coroutine_entry *lhs_entry = *(coroutine_entry * const *) lhs;
+    const coroutine_entry *rhs_entry = *(coroutine_entry * const *) rhs;
+
+    return (lhs_entry->wake_time_ms < rhs_entry->wake_time_ms) - (lhs_entry->wake_time_ms > rhs_entry->wake_time_ms);
+}
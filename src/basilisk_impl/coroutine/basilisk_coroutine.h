@@ -0,0 +1,70 @@
+/**
+ * @file basilisk_coroutine.h
+ * @author gabriel ()
+ * @brief Resume entity coroutines once the frames, duration or event they wait for are reached.
+ *
+ * Waiting coroutines are parked in collections sorted by their wake-up frame or time, or grouped by the name of the
+ * event they wait for. A step of the scheduler only looks at the coroutines that must wake up, so that a waiting
+ * coroutine costs nothing to the engine until it resumes.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef __COROUTINE_H__
+#define __COROUTINE_H__
+
+#include "../basilisk_common.h"
+#include "../entity/basilisk_entity.h"
+#include "../event/basilisk_event.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Opaque type to a collection of coroutines waiting to be resumed. */
+typedef struct coroutine_scheduler coroutine_scheduler;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Allocates a coroutine scheduler and returns a pointer to it. */
+coroutine_scheduler *coroutine_scheduler_create(allocator alloc);
+
+/* Releases memory taken by a coroutine scheduler and its coroutines, and nullifies the pointer passed. */
+void coroutine_scheduler_destroy(coroutine_scheduler **scheduler, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Adds a coroutine tied to an entity, first resumed on the next step of the scheduler. */
+void coroutine_scheduler_start(coroutine_scheduler *scheduler, basilisk_engine_entity *source, basilisk_specific_coroutine coroutine_data, allocator alloc);
+
+/* Removes all coroutines tied to an entity. */
+void coroutine_scheduler_remove_coroutines_of(coroutine_scheduler *scheduler, basilisk_engine_entity *source, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Moves the scheduler to the next frame, resuming the coroutines whose frames count or duration is reached. */
+void coroutine_scheduler_advance(coroutine_scheduler *scheduler, f32 elapsed_ms, allocator alloc);
+
+/* Resumes the coroutines waiting for an event. */
+void coroutine_scheduler_notify_event(coroutine_scheduler *scheduler, event ev, allocator alloc);
+
+/* Returns the number of coroutines in the scheduler. */
+size_t coroutine_scheduler_length(const coroutine_scheduler *scheduler);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Flags a running coroutine to wait for some number of frames. */
+void coroutine_await_frames(basilisk_coroutine *coroutine, u64 frames_count);
+
+/* Flags a running coroutine to wait for some duration. */
+void coroutine_await_duration(basilisk_coroutine *coroutine, f64 duration_ms);
+
+/* Flags a running coroutine to wait for an event. */
+void coroutine_await_event(basilisk_coroutine *coroutine, const char *str_event_name);
+
+#endif
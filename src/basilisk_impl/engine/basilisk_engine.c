@@ -14,6 +14,7 @@
 
 #include <signal.h>
 #include <stdlib.h>
+#include <threads.h>
 #include <time.h>
 
 #include <ustd/logging.h>
@@ -23,14 +24,43 @@
 #include "../basilisk_common.h"
 
 #include "../command/basilisk_command.h"
+#include "../coroutine/basilisk_coroutine.h"
 #include "../entity/basilisk_entity.h"
 #include "../event/basilisk_event.h"
+#include "../idle/basilisk_idle.h"
+#include "../job/basilisk_job.h"
+#include "../message/basilisk_message.h"
+#include "../recorder/basilisk_recorder.h"
 #include "../resource/basilisk_resource.h"
+#include "../timer/basilisk_timer.h"
+#include "../worker_pool/basilisk_worker_pool.h"
 
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 
+/**
+ * @brief Subtree of parallel-safe entities stepped as a single task on a worker thread.
+ */
+typedef struct basilisk_engine_parallel_step {
+    /** Entities of the subtree, from its root to its leafs. */
+    basilisk_engine_entity_range *entities;
+    /** Number of active entities to step on the main thread before the subtree, so that its parent is stepped first. */
+    size_t stepped_after;
+    /** Milliseconds passed to the entities' on_frame() callback. */
+    f32 elapsed_ms;
+} basilisk_engine_parallel_step;
+
+/**
+ * @brief Data of a job reading a storage file in memory on a worker thread.
+ */
+typedef struct basilisk_engine_prefetch {
+    /** Engine receiving the progress events. */
+    basilisk_engine *handle;
+    /** Progress of the prefetch, sent with the events. */
+    basilisk_storage_progress progress;
+} basilisk_engine_prefetch;
+
 /**
  * @brief Data layout of an engine instance. Every operation possible stems from one of the objects
  * stored in this struct : this is the central data structure of the engine, from which we can navigate
@@ -48,16 +78,46 @@ typedef struct basilisk_engine {
     event_stack *events;
     /** Publisher / subscriber object maintaining a collection of subscriptions of entities to events. */
     event_broker *pub_sub;
+    /** Post office delivering the messages sent directly from an entity to another. */
+    message_post_office *messages;
     /** Resource manager object to load / unload files from the filesystem. */
     resource_manager *res_manager;
+    /** Timing wheel holding the delayed and periodic callbacks of entities. */
+    timer_wheel *timers;
+    /** Threads used to step parallel-safe subtrees. */
+    worker_pool *workers;
+    /** Group of the tasks stepping parallel-safe subtrees during a frame. */
+    worker_task_group frame_tasks;
+    /** Jobs submitted by entities to the worker threads. */
+    job_system *jobs;
+    /** Coroutines attached to entities, waiting to be resumed. */
+    coroutine_scheduler *coroutines;
+    /** Low-priority tasks executed in the time left at the end of frames. */
+    idle_queue *idle_tasks;
+    /** Recording of the frames and input events, written during a run or read during a replay. Can be nullptr. */
+    recorder *recorder;
 
     /** Root of the game tree as an empty entity. */
     basilisk_engine_entity *root_entity;
 
     /** Buffer of references to entities to use for the main loop. */
     basilisk_engine_entity_range *active_entities;
+    /** Subtrees of parallel-safe entities, stepped concurrently to the active entities. */
+    RANGE(basilisk_engine_parallel_step) *parallel_steps;
     /** Flags that the active entities buffer needs to be reloaded. */
     bool update_active_entities;
+    /** Flags that the tree changed since its entities were last numbered for scoped events. */
+    bool is_subtree_index_stale;
+
+    /** Maximum number of events sent during a frame. Zero means no limit. */
+    size_t max_events_per_frame;
+    /** Maximum number of milliseconds spent sending events during a frame. Zero means no limit. */
+    f64 max_events_ms_per_frame;
+    /** Counters of the event phases. */
+    basilisk_engine_event_stats event_stats;
+
+    /** Thread running the main loop. Entity interactions coming from other threads go through thread-safe inboxes. */
+    thrd_t main_thread;
 
     /** Flag signaling wether the engine should exit or not the main loop. */
     bool should_quit;
@@ -80,22 +140,63 @@ static void basilisk_engine_process_command(basilisk_engine *handle, command cmd
 static void basilisk_engine_process_command_remove_entity(basilisk_engine *handle, basilisk_engine_entity *subject, command_remove_entity *cmd);
 /* Processes a specific command to subscribe an entity to an event, changing the state of the publisher / susbcriber collection. */
 static void basilisk_engine_process_command_subscribe_to_event(basilisk_engine *handle, command_subscribe_to_event *cmd);
+/* Processes a specific command to revoke a subscription of an entity, changing the state of the publisher / susbcriber collection. */
+static void basilisk_engine_process_command_unsubscribe_from_event(basilisk_engine *handle, basilisk_engine_entity *subject, command_unsubscribe_from_event *cmd);
 
 // -------------------------------------------------------------------------------------------------
 
 /* Processes an event, passing it to registered entities and then destroying it. */
 static void basilisk_engine_process_event(basilisk_engine *handle, event processed_event);
 
+/* Processes the stacked events until none are left or the frame's limits are reached, carrying the rest over. */
+static void basilisk_engine_unwind_events(basilisk_engine *handle);
+
 // -------------------------------------------------------------------------------------------------
 
 /* Steps all entities forward in time with their on_frame() callback. */
 static void basilisk_engine_frame_step_entities(basilisk_engine *handle, f32 elapsed_time);
 
+/* Sleeps until the end of a frame, and returns the point in time the next frame starts from. */
+static f64 basilisk_engine_sleep_until(f64 deadline_ms);
+
+/* Executes a frame, from the collection of the inboxes to the step of the entities, and returns the number of commands processed. */
+static size_t basilisk_engine_run_frame(basilisk_engine *handle, f64 frame_delay);
+
+/* Stacks the input events recorded during the current frame of a replayed session. */
+static void basilisk_engine_replay_input_events(basilisk_engine *handle, bool is_received);
+
+/* Records an input event received from another thread, when it leaves the inbox. */
+static void basilisk_engine_record_received_input(void *context, const event_stacked *item);
+
+/* Builds the path from the root entity to an entity, as names separated by '/'. */
+static identifier *basilisk_engine_path_to(basilisk_engine *handle, basilisk_engine_entity *target);
+
 // -------------------------------------------------------------------------------------------------
 
 /* Updates the active entities buffer if needed. */
 static void basilisk_engine_update_active_entities(basilisk_engine *handle);
 
+/* Checks if the calling thread is the one running the main loop. */
+static bool basilisk_engine_is_main_thread(const basilisk_engine *handle);
+
+/* Checks if the calling thread is the one running the main loop, and logs an error if it is not. */
+static bool basilisk_engine_require_main_thread(const basilisk_engine *handle, const char *str_function);
+
+/* Releases the parallel-safe subtrees buffer. */
+static void basilisk_engine_clear_parallel_steps(basilisk_engine *handle);
+
+/* Worker task stepping a whole parallel-safe subtree. */
+static void basilisk_engine_parallel_step_task(void *task_args);
+
+/* Job routine reading all resources of a storage file in memory. */
+static void basilisk_engine_prefetch_routine(void *job_data);
+
+/* Sends a progress event each time another percent of a storage is prefetched. */
+static void basilisk_engine_prefetch_progress(void *context, size_t prefetched_count, size_t resources_count);
+
+/* Sends the event signaling the end of the prefetch of a storage. */
+static void basilisk_engine_prefetch_done(basilisk_entity *self_data, void *job_data);
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -139,16 +240,32 @@ basilisk_engine *basilisk_engine_create(void)
                 .commands    = command_queue_create(used_alloc),
                 .events      = event_stack_create(used_alloc),
                 .pub_sub     = event_broker_create(used_alloc),
+                .messages    = message_post_office_create(used_alloc),
                 .res_manager = resource_manager_create(used_alloc),
+                .timers      = timer_wheel_create(used_alloc),
+                .coroutines  = coroutine_scheduler_create(used_alloc),
+                .idle_tasks  = idle_queue_create(used_alloc),
+                .recorder    = nullptr,
+                .workers     = worker_pool_create(BASILISK_WORKER_THREADS, used_alloc),
 
                 .root_entity = basilisk_engine_entity_create(identifier_root, (basilisk_specific_entity) { 0u }, new_engine, used_alloc),
 
                 .active_entities = nullptr,
+                .parallel_steps = nullptr,
                 .update_active_entities = false,
+                .is_subtree_index_stale = true,
+
+                .max_events_per_frame = BASILISK_EVENTS_PER_FRAME_MAX,
+                .max_events_ms_per_frame = BASILISK_EVENTS_MS_PER_FRAME_MAX,
+                .event_stats = { 0u },
+
+                .main_thread = thrd_current(),
 
                 .should_quit = false,
         };
 
+        new_engine->jobs = job_system_create(new_engine->workers, used_alloc);
+
         logger_log(new_engine->logger, LOGGER_SEVERITY_INFO, "Engine is ready.\n");
     }
 
@@ -171,11 +288,21 @@ void basilisk_engine_destroy(basilisk_engine **handle)
 
     used_alloc = (*handle)->alloc;
 
+    job_system_cancel_jobs_of((*handle)->jobs, nullptr);
+    worker_pool_destroy(&(*handle)->workers, used_alloc);
+    job_system_destroy(&(*handle)->jobs, used_alloc);
+
     if ((*handle)->active_entities) {
         range_destroy_dynamic(used_alloc, &RANGE_TO_ANY((*handle)->active_entities));
     }
+    basilisk_engine_clear_parallel_steps(*handle);
 
+    recorder_destroy(&(*handle)->recorder, used_alloc);
+    idle_queue_destroy(&(*handle)->idle_tasks, used_alloc);
+    coroutine_scheduler_destroy(&(*handle)->coroutines, used_alloc);
+    timer_wheel_destroy(&(*handle)->timers, used_alloc);
     resource_manager_destroy(&(*handle)->res_manager, used_alloc);
+    message_post_office_destroy(&(*handle)->messages, used_alloc);
     event_broker_destroy(&(*handle)->pub_sub, used_alloc);
     event_stack_destroy(&(*handle)->events, used_alloc);
     command_queue_destroy(&(*handle)->commands, used_alloc);
@@ -212,41 +339,177 @@ basilisk_entity *basilisk_engine_root_entity(basilisk_engine *handle)
  * @brief Starts a main loop until an interupt signal is sent to the program or an entity flags the
  * engine to quit.
  *
- * During a frame, the engine will process all commands describing pending operations, then unwind the
- * event stack until it is empty, and finaly step all entities from the root of the tree to its leafs.
+ * During a frame, the engine will collect the commands and events sent from other threads, notify the entities of
+ * their finished jobs, process all commands describing pending operations, fire the expired timers, resume the
+ * coroutines whose wait is over, then deliver the direct messages and unwind the event stack until both are empty or
+ * the event limits are reached, and
+ * finaly step all entities from the root of the tree to its leafs. The time left before the frame's deadline is given to the idle tasks, then the
+ * engine sleeps until the deadline.
  *
  * @param[inout] handle Engine instance.
  * @param[in] fps Target frequency of the main loop.
  */
 void basilisk_engine_run(basilisk_engine *handle, int fps) {
     f64 frame_delay = { 0. };
+    f64 frame_deadline = { 0. };
+    size_t forced_idle_slices = 0u;
 
     if (!handle || (fps == 0u)) {
         return;
     }
 
     handle->should_quit = false;
+    handle->main_thread = thrd_current();
     frame_delay = 1000. / (f64) fps;
 
     logger_log(handle->logger, LOGGER_SEVERITY_INFO, "Started the main loop at %d fps..\n", fps);
 
+    frame_deadline = time_monotonic_ms();
+
     do {
+        frame_deadline += frame_delay;
         handle->should_quit = (shared_interrupt_flag == 1);
 
-        while (command_queue_length(handle->commands) > 0u) {
-            basilisk_engine_process_command(handle, command_queue_pop_front(handle->commands));
+        (void) basilisk_engine_run_frame(handle, frame_delay);
+
+        forced_idle_slices = idle_queue_run_until(handle->idle_tasks, frame_deadline, handle->alloc);
+        if (forced_idle_slices > 0u) {
+            logger_log(handle->logger, LOGGER_SEVERITY_ERRO, "%lu idle task(s) did not fit in the time left by frames for a while : a slice of each was run past the deadline.\n", forced_idle_slices);
         }
 
-        while (event_stack_length(handle->events) > 0u) {
-            basilisk_engine_process_event(handle, event_stack_pop(handle->events));
+        frame_deadline = basilisk_engine_sleep_until(frame_deadline);
+    } while (!handle->should_quit);
+}
+
+/**
+ * @brief Starts recording the following runs of the engine to a binary file : the duration of each frame, the input
+ * events stacked by the entities, and the number of commands processed by each frame. The file is overwritten. A
+ * nullptr path stops the current recording.
+ *
+ * @param[inout] handle Engine instance.
+ * @param[in] str_path Path to the recording file, or nullptr.
+ */
+void basilisk_engine_record(basilisk_engine *handle, const char *str_path)
+{
+    if (!handle) {
+        return;
+    }
+
+    recorder_destroy(&handle->recorder, handle->alloc);
+
+    if (!str_path) {
+        return;
+    }
+
+    handle->recorder = recorder_create(str_path, false, handle->alloc);
+
+    if (handle->recorder) {
+        logger_log(handle->logger, LOGGER_SEVERITY_INFO, "Recording session to \"%s\".\n", str_path);
+    } else {
+        logger_log(handle->logger, LOGGER_SEVERITY_ERRO, "Cannot record session to \"%s\".\n", str_path);
+    }
+}
+
+/**
+ * @brief Runs the engine on a recorded session, as fast as possible : each frame is given its recorded duration, and
+ * the input events recorded during a frame are stacked at the same point of the frame, while the input events
+ * stacked by the entities themselves are dropped. Frames have no deadline : each idle task is given one slice after
+ * each frame. Input events recorded between two frames are stacked between the same frames. A recording holding a
+ * record the replay does not expect stops the replay there, and is logged. The replay stops at the end of the recording, or when the engine is
+ * asked to quit. Frames whose number of processed commands differs from the recording are logged, as the replay
+ * diverged from the session there. The entities of the replaying engine are set up by the caller, usually without
+ * the ones opening windows or reading devices.
+ *
+ * @param[inout] handle Engine instance.
+ * @param[in] str_path Path to a recording file written by basilisk_engine_record().
+ */
+void basilisk_engine_replay(basilisk_engine *handle, const char *str_path)
+{
+    f64 frame_delay = 0.;
+    size_t frame_count = 0u;
+    size_t processed_commands = 0u;
+    size_t recorded_commands = 0u;
+
+    if (!handle || !str_path) {
+        return;
+    }
+
+    recorder_destroy(&handle->recorder, handle->alloc);
+    handle->recorder = recorder_create(str_path, true, handle->alloc);
+
+    if (!handle->recorder) {
+        logger_log(handle->logger, LOGGER_SEVERITY_ERRO, "Cannot replay session from \"%s\".\n", str_path);
+        return;
+    }
+
+    handle->should_quit = false;
+    handle->main_thread = thrd_current();
+
+    logger_log(handle->logger, LOGGER_SEVERITY_INFO, "Replaying session from \"%s\"..\n", str_path);
+
+    // input events stacked before the first frame
+    basilisk_engine_replay_input_events(handle, false);
+
+    while (!handle->should_quit && recorder_read_frame(handle->recorder, &frame_delay)) {
+        handle->should_quit = (shared_interrupt_flag == 1);
+
+        processed_commands = basilisk_engine_run_frame(handle, frame_delay);
+        basilisk_engine_replay_input_events(handle, false);
+
+        if (recorder_read_commands(handle->recorder, &recorded_commands) && (recorded_commands != processed_commands)) {
+            logger_log(handle->logger, LOGGER_SEVERITY_ERRO, "Replay diverged at frame %lu : %lu commands processed instead of %lu.\n", frame_count, processed_commands, recorded_commands);
         }
 
-        basilisk_engine_update_active_entities(handle);
+        idle_queue_run_pass(handle->idle_tasks, handle->alloc);
 
-        basilisk_engine_frame_step_entities(handle, (f32) frame_delay);
+        // input events stacked between this frame and the next one
+        basilisk_engine_replay_input_events(handle, false);
 
-        (void) nanosleep(&(struct timespec) { .tv_nsec = (long) (frame_delay * 1000000.f) }, nullptr);
-    } while (!handle->should_quit);
+        frame_count += 1u;
+    }
+
+    if (!handle->should_quit && !recorder_is_at_end(handle->recorder)) {
+        logger_log(handle->logger, LOGGER_SEVERITY_ERRO, "Replay stopped at frame %lu : unexpected record in \"%s\".\n", frame_count, str_path);
+    }
+
+    recorder_destroy(&handle->recorder, handle->alloc);
+
+    logger_log(handle->logger, LOGGER_SEVERITY_INFO, "Replayed %lu frames.\n", frame_count);
+}
+
+/**
+ * @brief Sets the limits of the event phase of each frame. Once a frame sent the maximum number of events, or spent
+ * the maximum number of milliseconds sending them, the events left are carried over to the next frame, where they
+ * are sent before the newer ones, in their original order. A limit of zero disables it.
+ *
+ * @param[inout] handle Engine instance.
+ * @param[in] max_events_per_frame Maximum number of events sent during a frame.
+ * @param[in] max_ms_per_frame Maximum number of milliseconds spent sending events during a frame.
+ */
+void basilisk_engine_set_event_limits(basilisk_engine *handle, unsigned long max_events_per_frame, unsigned long max_ms_per_frame)
+{
+    if (!handle) {
+        return;
+    }
+
+    handle->max_events_per_frame = (size_t) max_events_per_frame;
+    handle->max_events_ms_per_frame = (f64) max_ms_per_frame;
+}
+
+/**
+ * @brief Returns the counters describing how the event phases of the main loop went, most notably how often the
+ * event limits were reached.
+ *
+ * @param[in] handle Engine instance.
+ * @return basilisk_engine_event_stats
+ */
+basilisk_engine_event_stats basilisk_engine_get_event_stats(const basilisk_engine *handle)
+{
+    if (!handle) {
+        return (basilisk_engine_event_stats) { 0u };
+    }
+
+    return handle->event_stats;
 }
 
 /**
@@ -272,6 +535,7 @@ void basilisk_entity_quit(basilisk_entity *entity)
 
 /**
  * @brief Immediately builds an entity and adds it as a child to another, and returns a pointer to the new entity.
+ * Must be called from the main thread.
  *
  * @param[in] entity Entity soon-to-be parent.
  * @param[in] str_id Name (copied) of the new entity.
@@ -286,7 +550,7 @@ basilisk_entity *basilisk_entity_add_child(basilisk_entity *entity, const char *
     basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
     basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
 
-    if (!full_entity || !handle) {
+    if (!full_entity || !handle || !basilisk_engine_require_main_thread(handle, __func__)) {
         return nullptr;
     }
 
@@ -309,12 +573,14 @@ basilisk_entity *basilisk_entity_add_child(basilisk_entity *entity, const char *
     range_destroy_dynamic(handle->alloc, &RANGE_TO_ANY(new_entity_id));
 
     handle->update_active_entities = true;
+    handle->is_subtree_index_stale = true;
 
     return basilisk_engine_entity_get_specific_data(new_entity);
 }
 
 /**
  * @brief Queues a command to remove an entity from the game tree. All children of the entity will be also removed.
+ * This function can be called from any thread.
  *
  * @param[in] entity Entity to remove.
  */
@@ -328,9 +594,16 @@ void basilisk_entity_queue_remove(basilisk_entity *entity)
     basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
     basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
 
-    if (handle) {
-        cmd = command_create_remove_entity(full_entity, handle->alloc);
+    if (!handle) {
+        return;
+    }
+
+    cmd = command_create_remove_entity(full_entity, handle->alloc);
+
+    if (basilisk_engine_is_main_thread(handle)) {
         command_queue_append(handle->commands, cmd, handle->alloc);
+    } else {
+        command_queue_append_threadsafe(handle->commands, cmd, handle->alloc);
     }
 }
 
@@ -354,208 +627,669 @@ basilisk_entity *basilisk_entity_graft(basilisk_entity *entity, basilisk_specifi
 /**
  * @brief Queue a command to subscribe an entity's callback to an event.
  * If this entity is removed before the operation is done, the command is also removed.
+ * This function can be called from any thread.
  *
  * @param[in] entity Entity subscribing the callback.
- * @param[in] str_event_name Name (copied) of the event the entity wants to subscribe a callback to.
+ * @param[in] str_event_name Name (copied) of the event the entity wants to subscribe a callback to. If it ends with a
+ * '*', the callback receives all events whose name starts with the characters before the '*'.
  * @param[in] callback Pointer to the callback that will receive the entity's data and event data.
+ * @return Handle to the subscription, usable to unsubscribe, or zero if the subscription is invalid.
  */
-void basilisk_entity_queue_subscribe_to_event(basilisk_entity *entity,  const char *str_event_name, basilisk_specific_event_subscription subscription_data)
+basilisk_event_subscription_handle basilisk_entity_queue_subscribe_to_event(basilisk_entity *entity,  const char *str_event_name, basilisk_specific_event_subscription subscription_data)
 {
     if (!entity) {
-        return;
+        return 0u;
     }
 
     command cmd = { 0u };
     basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
     basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
 
-    if (handle) {
-        cmd = command_create_subscribe_to_event(full_entity, str_event_name, subscription_data, handle->alloc);
+    if (!handle) {
+        return 0u;
+    }
+
+    cmd = command_create_subscribe_to_event(full_entity, str_event_name, subscription_data, handle->alloc);
+
+    if (cmd.flavor == COMMAND_INVALID) {
+        return 0u;
+    }
+
+    if (basilisk_engine_is_main_thread(handle)) {
+        cmd.specific.subscribe_to_event.handle = event_broker_reserve_handle(handle->pub_sub);
         command_queue_append(handle->commands, cmd, handle->alloc);
+    } else {
+        cmd.specific.subscribe_to_event.handle = event_broker_reserve_handle_threadsafe(handle->pub_sub);
+        command_queue_append_threadsafe(handle->commands, cmd, handle->alloc);
     }
+
+    return cmd.specific.subscribe_to_event.handle;
 }
 
 /**
- * @brief Immediately stacks a named event to be sent to all entities registered to the event's name.
+ * @brief Queue a command to revoke a subscription made by an entity, by the handle returned when it subscribed.
+ * Once the command is processed, the callback is not called anymore, and removing the subscription does not depend
+ * on the number of subscriptions. Handles of other entities, or of subscriptions already revoked, are ignored.
+ * This function can be called from any thread.
  *
- * @param[in] entity Entity sending the event.
- * @param[in] str_event_name Name (copied) of the event stacked.
- * @param[in] event_data Event's specific data (copied).
+ * @param[in] entity Entity that subscribed the callback.
+ * @param[in] subscription Handle returned by basilisk_entity_queue_subscribe_to_event().
  */
-void basilisk_entity_stack_event(basilisk_entity *entity, const char *str_event_name, basilisk_specific_event event_data)
+void basilisk_entity_queue_unsubscribe_from_event(basilisk_entity *entity, basilisk_event_subscription_handle subscription)
 {
     if (!entity) {
         return;
     }
 
+    command cmd = { 0u };
     basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
     basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
 
-    if (event_data.is_detached) {
-        event_stack_push(handle->events, handle->root_entity, str_event_name, event_data.data_size, event_data.data, handle->alloc);
-    } else {
-        event_stack_push(handle->events, full_entity, str_event_name, event_data.data_size, event_data.data, handle->alloc);
+    if (!handle) {
+        return;
     }
 
+    cmd = command_create_unsubscribe_from_event(full_entity, subscription, handle->alloc);
+
+    if (basilisk_engine_is_main_thread(handle)) {
+        command_queue_append(handle->commands, cmd, handle->alloc);
+    } else {
+        command_queue_append_threadsafe(handle->commands, cmd, handle->alloc);
+    }
 }
 
-// -------------------------------------------------------------------------------------------------
-// -------------------------------------------------------------------------------------------------
-// -------------------------------------------------------------------------------------------------
+/**
+ * @brief Immediately stacks a named event to be sent to all entities registered to the event's name.
+ * When called from another thread than the one running the engine, the event is stacked at the start of the next frame.
+ *
+ * @param[in] entity Entity sending the event.
+ * @param[in] str_event_name Name (copied) of the event stacked.
+ * @param[in] event_data Event's specific data (copied, unless borrowed).
+ */
+void basilisk_entity_stack_event(basilisk_entity *entity, const char *str_event_name, basilisk_specific_event event_data)
+{
+    basilisk_entity_stack_event_scoped(entity, nullptr, str_event_name, event_data);
+}
 
 /**
- * @brief Returns the first parent entity of the provided name and definition.
- * If no corresponding parent is found, the function returns nullptr.
+ * @brief Immediately stacks a named event to be sent only to the entities registered to the event's name that are in
+ * the subtree of some entity, this entity included. The event is removed if the root of the subtree is removed before
+ * the event is sent. When called from another thread than the one running the engine, the event is stacked at the
+ * start of the next frame.
+ * Borrowed event data is not copied : it is sent during the event phase following the call, before the next call to
+ * the sender's on_frame(), and must stay untouched until then. Borrowed data is still copied if the event is stacked
+ * from another thread, held by a batched or coalescing name, or carried over to the next frame by the event limits.
  *
- * @param[in] entity Entity from which to search for the parent.
- * @param[in] str_parent_name Name of the potential parent. Can be nullptr if you just want to search by type or get the first parent.
- * @param[in] entity_def Entity definition used to create the potential parent. Can be nullptr if you just want to search by name or get the first parent.
- * @return basilisk_entity *
+ * @param[in] entity Entity sending the event.
+ * @param[in] scope_root Root of the subtree of entities receiving the event. If nullptr, the event is sent to all entities.
+ * @param[in] str_event_name Name (copied) of the event stacked.
+ * @param[in] event_data Event's specific data (copied, unless borrowed).
  */
-basilisk_entity *basilisk_entity_get_parent(basilisk_entity *entity, const char *str_parent_name, const basilisk_entity_definition *entity_def)
+void basilisk_entity_stack_event_scoped(basilisk_entity *entity, basilisk_entity *scope_root, const char *str_event_name, basilisk_specific_event event_data)
 {
     if (!entity) {
-        return nullptr;
+        return;
     }
 
     basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
-    full_entity = basilisk_engine_entity_get_parent(full_entity);
+    basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
+    basilisk_engine_entity *source = full_entity;
+    basilisk_engine_entity *scope = (scope_root) ? basilisk_engine_entity_get_containing_full_entity(scope_root) : nullptr;
+    identifier *scope_path = nullptr;
 
-    if ((entity_def == nullptr) && (str_parent_name == nullptr)) {
-        return basilisk_engine_entity_get_specific_data(full_entity);
+    if (!handle) {
+        return;
     }
 
-    while ((full_entity != nullptr)
-            && (((entity_def == nullptr) || (!basilisk_engine_entity_has_definition(full_entity, *entity_def)))
-                    && ((str_parent_name == nullptr) || (identifier_compare_to_cstring(basilisk_engine_entity_get_name(full_entity), str_parent_name) != 0))))
-    {
-        full_entity = basilisk_engine_entity_get_parent(full_entity);
+    if (event_data.is_detached) {
+        source = handle->root_entity;
     }
 
-    return basilisk_engine_entity_get_specific_data(full_entity);
+    // input events from other threads are recorded once they leave the inbox, in the order they reach the stack
+    if (event_data.is_input && recorder_is_replaying(handle->recorder)) {
+        return;
+    }
+
+    if (event_data.is_input && handle->recorder && basilisk_engine_is_main_thread(handle)) {
+        scope_path = basilisk_engine_path_to(handle, scope);
+        recorder_write_event(handle->recorder, false, str_event_name, (scope_path) ? scope_path->data : nullptr, event_data);
+        if (scope_path) {
+            range_destroy_dynamic(handle->alloc, &RANGE_TO_ANY(scope_path));
+        }
+    }
+
+    if (basilisk_engine_is_main_thread(handle)) {
+        if (!event_stack_push(handle->events, source, scope, str_event_name, event_data, handle->alloc)) {
+            logger_log(handle->logger, LOGGER_SEVERITY_ERRO, "Dropped event \"%s\" : its data does not fit its declared type.\n", str_event_name);
+        }
+    } else {
+        event_stack_push_threadsafe(handle->events, source, scope, str_event_name, event_data, handle->alloc);
+    }
 }
 
 /**
- * @brief Returns the child of the entity at the end of the provided path. If no such child is found, returns nullptr.
- * If the given path is empty, the root is returned : it is the entity given as argument.
+ * @brief Sets the order in which the events of some name are sent : LIFO (the default), FIFO, by the priority given
+ * when stacking them, or in batches. Within a frame, events of LIFO names are sent first, then events of priority
+ * names, then events of FIFO names, then batches. Events already stacked keep their place. Must be called from the
+ * main thread.
  *
- * @param[in] entity Entity from which to search for the child.
- * @param[in] path Path to the potential child entity.
- * @param[in] entity_def Entity definition used to create the potential parent. Can be nullptr if you just want to search by name..
- * @return basilisk_entity *
+ * @param[in] entity Entity setting the dispatch mode.
+ * @param[in] str_event_name Name of the events.
+ * @param[in] mode Order in which the events will be sent.
  */
-basilisk_entity *basilisk_entity_get_child(basilisk_entity *entity, const char *str_path, const basilisk_entity_definition *entity_def)
+void basilisk_entity_set_event_dispatch(basilisk_entity *entity, const char *str_event_name, basilisk_event_dispatch_mode mode)
 {
-    if (!entity || !str_path) {
-        return nullptr;
+    if (!entity || !str_event_name) {
+        return;
     }
 
     basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
     basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
-    basilisk_engine_entity *found_entity = nullptr;
-    path *child_path = nullptr;
 
-    if (handle) {
-        child_path = path_from_cstring(str_path, handle->alloc);
-        found_entity = basilisk_engine_entity_get_child(full_entity, child_path);
-        path_destroy(&child_path, handle->alloc);
+    if (handle && basilisk_engine_require_main_thread(handle, __func__)) {
+        event_stack_set_dispatch(handle->events, str_event_name, mode, handle->alloc);
     }
+}
 
-    if (entity_def && !basilisk_engine_entity_has_definition(found_entity, *entity_def)) {
-        return nullptr;
+/**
+ * @brief Sets how the events of some name stacked by a same entity (in a same scope) are merged while they wait to be
+ * sent, so that at most one of them is sent : the first one, the last one, or one whose data folds the data of all of
+ * them with a user reducer. Coalesced events are sent once all other events were sent. Must be called from the main
+ * thread.
+ *
+ * @param[in] entity Entity setting the coalescing policy.
+ * @param[in] str_event_name Name of the events.
+ * @param[in] coalescing How the events will be merged.
+ */
+void basilisk_entity_set_event_coalescing(basilisk_entity *entity, const char *str_event_name, basilisk_specific_event_coalescing coalescing)
+{
+    if (!entity || !str_event_name) {
+        return;
     }
 
-    return basilisk_engine_entity_get_specific_data(found_entity);
+    basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
+    basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
+
+    if (handle && basilisk_engine_require_main_thread(handle, __func__)) {
+        event_stack_set_coalescing(handle->events, str_event_name, coalescing, handle->alloc);
+    }
 }
 
 /**
- * @brief
+ * @brief Declares the size and alignment of the data of all events of some name. Their data is then taken from a pool
+ * of blocks of this size instead of being allocated for each event, and events of this name whose data has another
+ * size are dropped. Prefer the functions defined by BASILISK_EVENT_TYPE(), which check the type of the data at compile
+ * time. Must be called from the main thread.
  *
- * @param entity
- * @param entity_def
- * @return
+ * @param[in] entity Entity declaring the type.
+ * @param[in] str_event_name Name of the events.
+ * @param[in] payload_size Number of bytes of the data of each event.
+ * @param[in] payload_alignment Alignment of the data of each event.
  */
-bool basilisk_entity_is(const basilisk_entity *entity, basilisk_entity_definition entity_def)
+void basilisk_entity_declare_event_type(basilisk_entity *entity, const char *str_event_name, unsigned long payload_size, unsigned long payload_alignment)
 {
-    basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
-    return basilisk_engine_entity_has_definition(full_entity, entity_def);
-}
+    if (!entity || !str_event_name) {
+        return;
+    }
 
-// -------------------------------------------------------------------------------------------------
+    basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
+    basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
 
-#undef basilisk_engine_declare_resource
+    if (handle && basilisk_engine_require_main_thread(handle, __func__) && !event_stack_declare_type(handle->events, str_event_name, payload_size, payload_alignment, handle->alloc)) {
+        logger_log(handle->logger, LOGGER_SEVERITY_ERRO, "Cannot declare the type of event \"%s\" : it was declared with another type.\n", str_event_name);
+    }
+}
 
 /**
- * @brief Declares a resource into the engine to be used later. Trying to get (with `basilisk_entity_fetch_resource()`)
- * an undeclared resource will fail regardless of its existence.
- * In nominal, development mode (with the compilation switch BASILISK_RELEASE reset), this function will search for the
- * specified resource file and append it to a storage file named after the storage name provided.
- * With BASILISK_RELEASE set, the function will only check that the resource is present in an already existing storage file
- * of the provided name.
- * If all went right, the resource will be ready to be used by entity requesting it with `basilisk_entity_fetch_resource()`.
+ * @brief Sends a message directly to an entity, without going through the event broker. The message is put in the
+ * mailbox of the target in constant time, and delivered to its on_message() callback during the event phase, before
+ * the stacked events. Messages to an entity are delivered in the order they were sent, and are discarded if the
+ * entity is removed first.
+ * When called from another thread than the one running the engine, the message is put in the mailbox at the start of
+ * the next frame.
  *
- * @param[inout] handle Handle to an engine instance.
- * @param[in] str_storage_name Name of the storage retaining the resource data.
- * @param[in] str_file_path Path to a resource file to declare.
+ * @param[in] target Entity receiving the message.
+ * @param[in] message_id User-defined identifier of the message.
+ * @param[in] data Message data (copied). Might be nullptr.
+ * @param[in] data_size Size, in bytes, of the message data.
  */
-void basilisk_engine_declare_resource(basilisk_engine *handle, const char *str_storage_name, const char *str_file_path)
+void basilisk_entity_send(basilisk_entity *target, unsigned long message_id, void *data, unsigned long data_size)
 {
-    const char *str_storage_path = str_storage_name; // for lisibility and intent
+    if (!target) {
+        return;
+    }
+
+    basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(target);
+    basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
 
     if (!handle) {
         return;
     }
 
-    if(resource_manager_touch(handle->res_manager, str_storage_path, str_file_path, handle->alloc)) {
-        logger_log(handle->logger, LOGGER_SEVERITY_INFO, "Detected resource \"%s\" in storage \"%s\".\n", str_file_path, str_storage_path);
+    if (basilisk_engine_is_main_thread(handle)) {
+        message_post_office_send(handle->messages, basilisk_engine_entity_get_mailbox(full_entity), message_id, data, (size_t) data_size, handle->alloc);
     } else {
-        logger_log(handle->logger, LOGGER_SEVERITY_ERRO, "Failed to detect resource \"%s\" in storage \"%s\".\n", str_file_path, str_storage_path);
+        message_post_office_send_threadsafe(handle->messages, basilisk_engine_entity_get_mailbox(full_entity), message_id, data, (size_t) data_size, handle->alloc);
     }
 }
 
-#undef basilisk_entity_fetch_resource
+// -------------------------------------------------------------------------------------------------
 
 /**
- * @brief Returns the data from a resource present in a storage. The entity will be registered as using this storage, and if it is the first
- * one to do so, all of the storage's resources will be loaded in memory. On entity removal, the entity will be also removed from the storage's
- * users, and if it was the last one, the storage will be unloaded. You can also pass nullptr to the `str_file_path` argument to notify the engine
- * that the provided entity needs to keep the storage loaded as long as it lives.
+ * @brief Schedules a callback to be executed on the entity once, after some delay.
+ * The timer is cancelled if the entity is removed before it fires. Timers fire during the frame, after commands are
+ * processed and before events are sent.
+ * Must be called from the main thread.
  *
- * The memory returned is owned by the engine and will follow its own lifetime.
- *
- * @param[in] entity Entity querying a resource. It will be registered as a user of the storage.
- * @param[in] str_storage_name Name of the storage containing the resource.
- * @param[in] str_file_path File path to the actual resource. Can be nullptr.
- * @param[out] out_size Outgoing number of bytes the function returned.
- * @return void *
+ * @param[in] entity Entity receiving the callback.
+ * @param[in] delay_ms Number of milliseconds before the callback is executed.
+ * @param[in] callback Function executed when the timer fires.
+ * @param[in] timer_data Non-owned data passed to the callback.
  */
-void *basilisk_entity_fetch_resource(basilisk_entity *entity, const char *str_storage_name, const char *str_file_path, unsigned long *out_size)
+void basilisk_entity_schedule(basilisk_entity *entity, unsigned long delay_ms, void (*callback)(basilisk_entity *self_data, void *timer_data), void *timer_data)
 {
-    const char *str_storage_path = str_storage_name; // for lisibility and intent
-
     if (!entity) {
-        return nullptr;
+        return;
     }
 
     basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
     basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
 
-    if (!handle) {
-        return nullptr;
+    if (handle && basilisk_engine_require_main_thread(handle, __func__)) {
+        timer_wheel_schedule(handle->timers, full_entity, delay_ms, 0u, callback, timer_data, handle->alloc);
     }
-
-    resource_manager_add_supplicant(handle->res_manager, str_storage_path, full_entity, handle->alloc);
-    return resource_manager_fetch(handle->res_manager, str_storage_path, str_file_path, out_size);
 }
 
-// -------------------------------------------------------------------------------------------------
-// -------------------------------------------------------------------------------------------------
-// -------------------------------------------------------------------------------------------------
-
 /**
- * @brief Completely removes an entity and its children from everything in the engine.
- * Additionally of removing the entities from the tree, it will remove all relevant events, subscriptions
- * and commands linked to the entities. All of the entities memory is released.
+ * @brief Schedules a callback to be executed on the entity every period, the first time after one period.
+ * The timer lives until it is unscheduled or the entity is removed.
+ * Must be called from the main thread.
+ *
+ * @param[in] entity Entity receiving the callback.
+ * @param[in] period_ms Number of milliseconds between two executions of the callback.
+ * @param[in] callback Function executed each time the timer fires.
+ * @param[in] timer_data Non-owned data passed to the callback.
+ */
+void basilisk_entity_schedule_periodic(basilisk_entity *entity, unsigned long period_ms, void (*callback)(basilisk_entity *self_data, void *timer_data), void *timer_data)
+{
+    if (!entity) {
+        return;
+    }
+
+    basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
+    basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
+
+    if (handle && basilisk_engine_require_main_thread(handle, __func__)) {
+        timer_wheel_schedule(handle->timers, full_entity, period_ms, (period_ms > 0u) ? period_ms : 1u, callback, timer_data, handle->alloc);
+    }
+}
+
+/**
+ * @brief Cancels all pending timers of an entity that were scheduled with some callback.
+ * Must be called from the main thread.
+ *
+ * @param[in] entity Entity that scheduled the timers.
+ * @param[in] callback Callback the timers were scheduled with.
+ */
+void basilisk_entity_unschedule(basilisk_entity *entity, void (*callback)(basilisk_entity *self_data, void *timer_data))
+{
+    if (!entity || !callback) {
+        return;
+    }
+
+    basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
+    basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
+
+    if (handle && basilisk_engine_require_main_thread(handle, __func__)) {
+        timer_wheel_unschedule(handle->timers, full_entity, callback);
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Hands some work to the engine's worker threads on behalf of an entity. The job's data is copied, and the
+ * copy is passed to the routine on a worker thread, then to the completion callback on the main thread, at the start
+ * of the frame following the routine's return. If the entity is removed before that, the routine is skipped if it
+ * did not start yet and the completion callback is not executed.
+ * Must be called from the main thread.
+ *
+ * @param[in] entity Entity submitting the job and receiving its completion.
+ * @param[in] job_data Description of the job.
+ */
+void basilisk_entity_submit_job(basilisk_entity *entity, basilisk_specific_job job_data)
+{
+    if (!entity) {
+        return;
+    }
+
+    basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
+    basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
+
+    if (handle && basilisk_engine_require_main_thread(handle, __func__)) {
+        job_system_submit(handle->jobs, full_entity, job_data, handle->alloc);
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Attaches a coroutine to an entity. The coroutine's data is copied, and its body is first executed on the
+ * next frame, after the timers fire. Each time the body awaits frames, a duration or an event, it returns and is
+ * resumed from the await once the condition is met ; a waiting coroutine is not looked at until then. The coroutine
+ * is finished when its body returns without awaiting, and is removed if the entity is removed.
+ * Must be called from the main thread.
+ *
+ * @param[in] entity Entity the coroutine is attached to.
+ * @param[in] coroutine_data Description of the coroutine.
+ */
+void basilisk_entity_start_coroutine(basilisk_entity *entity, basilisk_specific_coroutine coroutine_data)
+{
+    if (!entity) {
+        return;
+    }
+
+    basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
+    basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
+
+    if (handle && basilisk_engine_require_main_thread(handle, __func__)) {
+        coroutine_scheduler_start(handle->coroutines, full_entity, coroutine_data, handle->alloc);
+    }
+}
+
+/**
+ * @brief Flags a running coroutine to be resumed after some frames once its body returns. Waiting for zero frames
+ * waits for the next frame.
+ *
+ * @param[inout] coroutine State of the running coroutine.
+ * @param[in] frames_count Number of frames to wait for.
+ */
+void basilisk_coroutine_await_frames(basilisk_coroutine *coroutine, unsigned long frames_count)
+{
+    coroutine_await_frames(coroutine, (u64) frames_count);
+}
+
+/**
+ * @brief Flags a running coroutine to be resumed after some duration once its body returns. The coroutine is resumed
+ * on the first frame reaching the duration.
+ *
+ * @param[inout] coroutine State of the running coroutine.
+ * @param[in] duration_ms Number of milliseconds to wait for.
+ */
+void basilisk_coroutine_await_duration(basilisk_coroutine *coroutine, unsigned long duration_ms)
+{
+    coroutine_await_duration(coroutine, (f64) duration_ms);
+}
+
+/**
+ * @brief Flags a running coroutine to be resumed by the next event of some name once its body returns. The event is
+ * still sent to the subscribed callbacks.
+ *
+ * @param[inout] coroutine State of the running coroutine.
+ * @param[in] str_event_name Name of the awaited event.
+ */
+void basilisk_coroutine_await_event(basilisk_coroutine *coroutine, const char *str_event_name)
+{
+    coroutine_await_event(coroutine, str_event_name);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Queues some low-priority work on behalf of an entity. The task's data is copied, and its routine is executed
+ * in slices in the time left at the end of frames, a slice being started only if it is expected to end before the
+ * frame's deadline. A task whose slices never fit is still given one after many frames skipping it, and an error is
+ * logged. The task is removed once its routine returns false, or if the entity is removed.
+ * Must be called from the main thread.
+ *
+ * @param[in] entity Entity the task works for.
+ * @param[in] task_data Description of the task.
+ */
+void basilisk_entity_queue_idle_task(basilisk_entity *entity, basilisk_specific_idle_task task_data)
+{
+    if (!entity) {
+        return;
+    }
+
+    basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
+    basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
+
+    if (handle && basilisk_engine_require_main_thread(handle, __func__)) {
+        idle_queue_push(handle->idle_tasks, full_entity, task_data, handle->alloc);
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the first parent entity of the provided name and definition.
+ * If no corresponding parent is found, the function returns nullptr.
+ *
+ * @param[in] entity Entity from which to search for the parent.
+ * @param[in] str_parent_name Name of the potential parent. Can be nullptr if you just want to search by type or get the first parent.
+ * @param[in] entity_def Entity definition used to create the potential parent. Can be nullptr if you just want to search by name or get the first parent.
+ * @return basilisk_entity *
+ */
+basilisk_entity *basilisk_entity_get_parent(basilisk_entity *entity, const char *str_parent_name, const basilisk_entity_definition *entity_def)
+{
+    if (!entity) {
+        return nullptr;
+    }
+
+    basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
+    full_entity = basilisk_engine_entity_get_parent(full_entity);
+
+    if ((entity_def == nullptr) && (str_parent_name == nullptr)) {
+        return basilisk_engine_entity_get_specific_data(full_entity);
+    }
+
+    while ((full_entity != nullptr)
+            && (((entity_def == nullptr) || (!basilisk_engine_entity_has_definition(full_entity, *entity_def)))
+                    && ((str_parent_name == nullptr) || (identifier_compare_to_cstring(basilisk_engine_entity_get_name(full_entity), str_parent_name) != 0))))
+    {
+        full_entity = basilisk_engine_entity_get_parent(full_entity);
+    }
+
+    return basilisk_engine_entity_get_specific_data(full_entity);
+}
+
+/**
+ * @brief Returns the child of the entity at the end of the provided path. If no such child is found, returns nullptr.
+ * If the given path is empty, the root is returned : it is the entity given as argument.
+ *
+ * @param[in] entity Entity from which to search for the child.
+ * @param[in] path Path to the potential child entity.
+ * @param[in] entity_def Entity definition used to create the potential parent. Can be nullptr if you just want to search by name..
+ * @return basilisk_entity *
+ */
+basilisk_entity *basilisk_entity_get_child(basilisk_entity *entity, const char *str_path, const basilisk_entity_definition *entity_def)
+{
+    if (!entity || !str_path) {
+        return nullptr;
+    }
+
+    basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
+    basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
+    basilisk_engine_entity *found_entity = nullptr;
+    path *child_path = nullptr;
+
+    if (handle) {
+        child_path = path_from_cstring(str_path, handle->alloc);
+        found_entity = basilisk_engine_entity_get_child(full_entity, child_path);
+        path_destroy(&child_path, handle->alloc);
+    }
+
+    if (entity_def && !basilisk_engine_entity_has_definition(found_entity, *entity_def)) {
+        return nullptr;
+    }
+
+    return basilisk_engine_entity_get_specific_data(found_entity);
+}
+
+/**
+ * @brief
+ *
+ * @param entity
+ * @param entity_def
+ * @return
+ */
+bool basilisk_entity_is(const basilisk_entity *entity, basilisk_entity_definition entity_def)
+{
+    basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
+    return basilisk_engine_entity_has_definition(full_entity, entity_def);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+#undef basilisk_engine_declare_resource
+
+/**
+ * @brief Declares a resource into the engine to be used later. Trying to get (with `basilisk_entity_fetch_resource()`)
+ * an undeclared resource will fail regardless of its existence.
+ * In nominal, development mode (with the compilation switch BASILISK_RELEASE reset), this function will search for the
+ * specified resource file and append it to a storage file named after the storage name provided.
+ * With BASILISK_RELEASE set, the function will only check that the resource is present in an already existing storage file
+ * of the provided name.
+ * If all went right, the resource will be ready to be used by entity requesting it with `basilisk_entity_fetch_resource()`.
+ * Must be called from the main thread.
+ *
+ * @param[inout] handle Handle to an engine instance.
+ * @param[in] str_storage_name Name of the storage retaining the resource data.
+ * @param[in] str_file_path Path to a resource file to declare.
+ */
+void basilisk_engine_declare_resource(basilisk_engine *handle, const char *str_storage_name, const char *str_file_path)
+{
+    const char *str_storage_path = str_storage_name; // for lisibility and intent
+
+    if (!handle || !basilisk_engine_require_main_thread(handle, __func__)) {
+        return;
+    }
+
+    if(resource_manager_touch(handle->res_manager, str_storage_path, str_file_path, handle->alloc)) {
+        logger_log(handle->logger, LOGGER_SEVERITY_INFO, "Detected resource \"%s\" in storage \"%s\".\n", str_file_path, str_storage_path);
+    } else {
+        logger_log(handle->logger, LOGGER_SEVERITY_ERRO, "Failed to detect resource \"%s\" in storage \"%s\".\n", str_file_path, str_storage_path);
+    }
+}
+
+#undef basilisk_entity_fetch_resource
+
+/**
+ * @brief Returns the data from a resource present in a storage. The entity will be registered as using this storage, and if it is the first
+ * one to do so, the storage's index will be loaded in memory. Only the requested resource is then mapped from the storage file, and the entity
+ * is counted as one of its holders. On entity removal, the entity will be also removed from the storage's users and from the holders of the
+ * resources it fetched, and if it was the last one, the storage will be unloaded. You can also pass nullptr to the `str_file_path` argument to
+ * notify the engine that the provided entity needs to keep the storage loaded as long as it lives.
+ * Must be called from the main thread.
+ *
+ * The memory returned is owned by the engine and stays valid until the entity releases it (see `basilisk_entity_release_resource()`) or is
+ * removed. It is mapped read-only from the storage file and must not be written to.
+ *
+ * @param[in] entity Entity querying a resource. It will be registered as a user of the storage.
+ * @param[in] str_storage_name Name of the storage containing the resource.
+ * @param[in] str_file_path File path to the actual resource. Can be nullptr.
+ * @param[out] out_size Outgoing number of bytes the function returned.
+ * @return const void *
+ */
+const void *basilisk_entity_fetch_resource(basilisk_entity *entity, const char *str_storage_name, const char *str_file_path, unsigned long *out_size)
+{
+    const char *str_storage_path = str_storage_name; // for lisibility and intent
+
+    if (!entity) {
+        return nullptr;
+    }
+
+    basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
+    basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
+
+    if (!handle || !basilisk_engine_require_main_thread(handle, __func__)) {
+        return nullptr;
+    }
+
+    resource_manager_add_supplicant(handle->res_manager, str_storage_path, full_entity, handle->alloc);
+    return resource_manager_fetch(handle->res_manager, str_storage_path, str_file_path, full_entity, out_size, handle->alloc);
+}
+
+#undef basilisk_entity_release_resource
+
+/**
+ * @brief Marks an entity as no longer using a resource it fetched. Once no entity holds the resource, its memory is unmapped,
+ * while the rest of the storage stays loaded for its users. Data previously returned for this resource to this entity must not
+ * be used anymore.
+ * Must be called from the main thread.
+ *
+ * @param[in] entity Entity releasing a resource.
+ * @param[in] str_storage_name Name of the storage containing the resource.
+ * @param[in] str_file_path File path to the actual resource.
+ */
+void basilisk_entity_release_resource(basilisk_entity *entity, const char *str_storage_name, const char *str_file_path)
+{
+    const char *str_storage_path = str_storage_name; // for lisibility and intent
+
+    if (!entity) {
+        return;
+    }
+
+    basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
+    basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
+
+    if (!handle || !basilisk_engine_require_main_thread(handle, __func__)) {
+        return;
+    }
+
+    resource_manager_release(handle->res_manager, str_storage_path, str_file_path, full_entity, handle->alloc);
+}
+
+#undef basilisk_entity_prefetch_storage
+
+/**
+ * @brief Reads all resources of a storage in memory on a worker thread, so that fetching them later does not stall the
+ * frame waiting for the disk. The entity is registered as a user of the storage, like with `basilisk_entity_fetch_resource()`.
+ * Each time another percent of the resources is read, a BASILISK_EVENT_STORAGE_PROGRESS event is sent, and once all
+ * are read, a BASILISK_EVENT_STORAGE_PREFETCHED event is sent, both carrying a basilisk_storage_progress.
+ * Resources can be fetched during the prefetch : a fetch only waits for the resource it returns to be read.
+ * Must be called from the main thread.
+ *
+ * @param[in] entity Entity prefetching the storage. It will be registered as a user of the storage.
+ * @param[in] str_storage_name Name of the storage.
+ */
+void basilisk_entity_prefetch_storage(basilisk_entity *entity, const char *str_storage_name)
+{
+    const char *str_storage_path = str_storage_name; // for lisibility and intent
+    basilisk_engine_prefetch prefetch = { 0u };
+
+    if (!entity || !str_storage_path) {
+        return;
+    }
+
+    basilisk_engine_entity *full_entity = basilisk_engine_entity_get_containing_full_entity(entity);
+    basilisk_engine *handle = basilisk_engine_entity_get_host_engine_handle(full_entity);
+
+    if (!handle || !basilisk_engine_require_main_thread(handle, __func__)) {
+        return;
+    }
+
+    resource_manager_add_supplicant(handle->res_manager, str_storage_path, full_entity, handle->alloc);
+
+    prefetch = (basilisk_engine_prefetch) { .handle = handle, .progress = { .str_storage_path = str_storage_path } };
+    job_system_submit(handle->jobs, full_entity, (basilisk_specific_job) {
+            .data_size = sizeof(prefetch),
+            .data = &prefetch,
+            .routine = &basilisk_engine_prefetch_routine,
+            .on_done = &basilisk_engine_prefetch_done,
+    }, handle->alloc);
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Completely removes an entity and its children from everything in the engine.
+ * Additionally of removing the entities from the tree, it will remove all relevant events, subscriptions
+ * and commands linked to the entities. All of the entities memory is released.
  *
  * @param[inout] handle Engine handle.
  * @param[inout] target Entity to remove along its children.
@@ -595,8 +1329,15 @@ static void basilisk_engine_annihilate_entity(basilisk_engine *handle, basilisk_
     basilisk_engine_entity_deinit(target);
     resource_manager_remove_supplicant(handle->res_manager, target, handle->alloc);
     event_stack_remove_events_of(handle->events, target, handle->alloc);
+    message_post_office_discard(handle->messages, basilisk_engine_entity_get_mailbox(target), handle->alloc);
+    timer_wheel_remove_timers_of(handle->timers, target);
+    job_system_cancel_jobs_of(handle->jobs, target);
+    coroutine_scheduler_remove_coroutines_of(handle->coroutines, target, handle->alloc);
+    idle_queue_remove_tasks_of(handle->idle_tasks, target, handle->alloc);
     command_queue_remove_commands_of(handle->commands, target, handle->alloc);
-    event_broker_unsubscribe_from_all(handle->pub_sub, target, handle->alloc);
+    for (u64 sub = basilisk_engine_entity_pop_subscription(target) ; sub != 0u ; sub = basilisk_engine_entity_pop_subscription(target)) {
+        event_broker_unsubscribe(handle->pub_sub, sub, handle->alloc);
+    }
     basilisk_engine_entity_destroy(&target, handle->alloc);
 }
 
@@ -629,6 +1370,9 @@ static void basilisk_engine_process_command(basilisk_engine *handle, command cmd
     case COMMAND_SUBSCRIBE_TO_EVENT:
         basilisk_engine_process_command_subscribe_to_event(handle, &(cmd.specific.subscribe_to_event));
         break;
+    case COMMAND_UNSUBSCRIBE_FROM_EVENT:
+        basilisk_engine_process_command_unsubscribe_from_event(handle, subject, &(cmd.specific.unsubscribe_from_event));
+        break;
     default:
         break;
     }
@@ -657,6 +1401,7 @@ static void basilisk_engine_process_command_remove_entity(basilisk_engine *handl
     logger_log(handle->logger, LOGGER_SEVERITY_INFO, "Removed entity \"%s\".\n", basilisk_engine_entity_get_name(subject)->data);
     basilisk_engine_annihilate_entity_and_chilren(handle, cmd->removed);
     handle->update_active_entities = true;
+    handle->is_subtree_index_stale = true;
 }
 
 /**
@@ -672,10 +1417,34 @@ static void basilisk_engine_process_command_subscribe_to_event(basilisk_engine *
         return;
     }
 
-    event_broker_subscribe(handle->pub_sub, cmd->subscribed, cmd->target_event_name, cmd->subscription_data, handle->alloc);
+    event_broker_subscribe(handle->pub_sub, cmd->subscribed, cmd->target_event_name, cmd->handle, cmd->subscription_data, handle->alloc);
+    basilisk_engine_entity_add_subscription(cmd->subscribed, cmd->handle, handle->alloc);
     logger_log(handle->logger, LOGGER_SEVERITY_INFO, "Entity \"%s\" subscribed callback %#010x to event \"%s\".\n", basilisk_engine_entity_get_name(cmd->subscribed)->data, cmd->subscription_data.callback, cmd->target_event_name->data);
 }
 
+/**
+ * @brief Processes a command trusted to be a command to revoke a subscription. The subscription is only revoked if it
+ * was made by the entity that sent the command.
+ *
+ * @param[inout] handle Engine handle.
+ * @param[in] subject Entity that sent the command.
+ * @param[in] cmd Command containing the subscription handle.
+ */
+static void basilisk_engine_process_command_unsubscribe_from_event(basilisk_engine *handle, basilisk_engine_entity *subject, command_unsubscribe_from_event *cmd)
+{
+    if (!handle || !cmd) {
+        return;
+    }
+
+    if (!basilisk_engine_entity_remove_subscription(subject, cmd->handle)) {
+        logger_log(handle->logger, LOGGER_SEVERITY_ERRO, "Entity \"%s\" cannot revoke subscription %#llx : it did not make it.\n", basilisk_engine_entity_get_name(subject)->data, cmd->handle);
+        return;
+    }
+
+    event_broker_unsubscribe(handle->pub_sub, cmd->handle, handle->alloc);
+    logger_log(handle->logger, LOGGER_SEVERITY_INFO, "Entity \"%s\" revoked subscription %#llx.\n", basilisk_engine_entity_get_name(subject)->data, cmd->handle);
+}
+
 // -------------------------------------------------------------------------------------------------
 
 /**
@@ -690,41 +1459,298 @@ static void basilisk_engine_process_event(basilisk_engine *handle, event process
         return;
     }
 
-    event_broker_publish(handle->pub_sub, processed_event);
+    if (processed_event.scope && handle->is_subtree_index_stale) {
+        (void) basilisk_engine_entity_index_subtree(handle->root_entity, 0u);
+        handle->is_subtree_index_stale = false;
+    }
+
+    if (!event_is_borrow_intact(&processed_event)) {
+        logger_log(handle->logger, LOGGER_SEVERITY_ERRO, "Borrowed data of event \"%s\" changed before it was sent.\n", processed_event.name->data);
+    }
+
+    event_broker_publish(handle->pub_sub, processed_event, handle->workers, handle->alloc);
+    coroutine_scheduler_notify_event(handle->coroutines, processed_event, handle->alloc);
 
     event_destroy(&processed_event, handle->alloc);
 }
 
+/**
+ * @brief Processes the stacked events, the ones carried over from the last frame being sent first, until the stack
+ * is empty or the events count or time limits of the frame are reached. Events left over are carried over to the next
+ * frame, keeping their order, and the event counters are updated.
+ *
+ * @param[inout] handle Engine handle.
+ */
+static void basilisk_engine_unwind_events(basilisk_engine *handle)
+{
+    size_t processed_count = 0u;
+    f64 phase_deadline = 0.;
+    bool is_count_capped = false;
+    bool is_time_capped = false;
+
+    if (!handle) {
+        return;
+    }
+
+    if (handle->max_events_ms_per_frame > 0.) {
+        phase_deadline = time_monotonic_ms() + handle->max_events_ms_per_frame;
+    }
+
+    while (!is_count_capped && !is_time_capped && ((message_post_office_length(handle->messages) > 0u) || (event_stack_length(handle->events) > 0u))) {
+        if (!message_post_office_deliver(handle->messages, handle->alloc)) {
+            basilisk_engine_process_event(handle, event_stack_pop(handle->events, handle->alloc));
+        }
+        processed_count += 1u;
+
+        is_count_capped = (handle->max_events_per_frame > 0u) && (processed_count >= handle->max_events_per_frame);
+        is_time_capped = (handle->max_events_ms_per_frame > 0.) && (time_monotonic_ms() >= phase_deadline);
+    }
+
+    handle->event_stats.last_frame_events = processed_count;
+
+    if ((message_post_office_length(handle->messages) > 0u) || (event_stack_length(handle->events) > 0u)) {
+        handle->event_stats.count_limit_hits += is_count_capped;
+        handle->event_stats.time_limit_hits += (is_time_capped && !is_count_capped);
+        handle->event_stats.carried_events += message_post_office_length(handle->messages) + event_stack_length(handle->events);
+
+        event_stack_carry_over(handle->events, handle->alloc);
+    }
+}
+
 // -------------------------------------------------------------------------------------------------
 
 /**
  * @brief Invoques all on_frame() callbacks found in the game tree's entities, from the root of the tree
  * to the leafs.
+ * Subtrees made only of parallel-safe entities are handed to the worker threads, each subtree being stepped from its
+ * root to its leafs, while the other entities are stepped on the calling thread. A subtree is only handed over once the
+ * parent of its root was stepped, so that parents are still stepped before their children. The function returns once
+ * all entities were stepped.
  *
  * @param[inout] handle Engine handle.
  * @param[in] elapsed_time milliseconds elapsed since the last time this function was executed.
  */
 static void basilisk_engine_frame_step_entities(basilisk_engine *handle, f32 elapsed_ms)
 {
-    basilisk_engine_entity_range *all_entities = nullptr;
-
     if (!handle ||!handle->active_entities) {
         return;
     }
 
-    for (size_t i = 0u ; i < handle->active_entities->length ; i++) {
-        basilisk_engine_entity_step_frame(handle->active_entities->data[i], elapsed_ms);
+    size_t step_pos = 0u;
+
+    // subtrees are sorted by the number of active entities to step before them
+    for (size_t i = 0u ; i <= handle->active_entities->length ; i++) {
+        while ((step_pos < handle->parallel_steps->length) && (handle->parallel_steps->data[step_pos].stepped_after <= i)) {
+            handle->parallel_steps->data[step_pos].elapsed_ms = elapsed_ms;
+            worker_pool_submit(handle->workers, (worker_task) {
+                    .routine = &basilisk_engine_parallel_step_task,
+                    .args = handle->parallel_steps->data + step_pos,
+                    .group = &handle->frame_tasks, }, handle->alloc);
+            step_pos += 1u;
+        }
+
+        if (i < handle->active_entities->length) {
+            basilisk_engine_entity_step_frame(handle->active_entities->data[i], elapsed_ms);
+        }
+    }
+
+    worker_pool_wait(handle->workers, &handle->frame_tasks);
+}
+
+/**
+ * @brief Sleeps until a frame's deadline. If the deadline is already passed, the function returns immediately and
+ * the next frame starts from the current time instead, so that a late frame does not make the following ones rush.
+ *
+ * @param[in] deadline_ms Point in time, from time_monotonic_ms(), at which the frame ends.
+ * @return f64
+ */
+static f64 basilisk_engine_sleep_until(f64 deadline_ms)
+{
+    f64 now_ms = time_monotonic_ms();
+    f64 remaining_ms = deadline_ms - now_ms;
+    time_t remaining_s = { 0 };
+
+    if (remaining_ms <= 0.) {
+        return now_ms;
+    }
+
+    remaining_s = (time_t) (remaining_ms / 1000.);
+    (void) nanosleep(&(struct timespec) {
+            .tv_sec = remaining_s,
+            .tv_nsec = (long) ((remaining_ms - ((f64) remaining_s * 1000.)) * 1000000.) }, nullptr);
+
+    return deadline_ms;
+}
+
+/**
+ * @brief Executes a frame : collects the commands, events, messages and finished jobs sent from other threads,
+ * processes the pending commands, fires the expired timers, resumes the coroutines whose wait is over, releases the
+ * deferred and delayed events, unwinds the events and steps all entities. When the engine records a session, the frame is written to the recording. Returns
+ * the number of commands processed by the frame.
+ *
+ * @param[inout] handle Engine handle.
+ * @param[in] frame_delay Duration of the frame, in milliseconds.
+ * @return size_t
+ */
+static size_t basilisk_engine_run_frame(basilisk_engine *handle, f64 frame_delay)
+{
+    size_t processed_commands = 0u;
+
+    recorder_write_frame(handle->recorder, frame_delay);
+
+    command_queue_drain_inbox(handle->commands, handle->alloc);
+    event_stack_drain_inbox(handle->events, &basilisk_engine_record_received_input, handle, handle->alloc);
+    basilisk_engine_replay_input_events(handle, true);
+    message_post_office_drain_inbox(handle->messages, handle->alloc);
+    job_system_collect(handle->jobs, handle->alloc);
+
+    while (command_queue_length(handle->commands) > 0u) {
+        basilisk_engine_process_command(handle, command_queue_pop_front(handle->commands));
+        processed_commands += 1u;
+    }
+
+    timer_wheel_advance(handle->timers, (f32) frame_delay, handle->alloc);
+    coroutine_scheduler_advance(handle->coroutines, (f32) frame_delay, handle->alloc);
+    event_stack_advance(handle->events, frame_delay, handle->alloc);
+
+    basilisk_engine_unwind_events(handle);
+
+    basilisk_engine_update_active_entities(handle);
+
+    basilisk_engine_frame_step_entities(handle, (f32) frame_delay);
+
+    recorder_write_commands(handle->recorder, processed_commands);
+
+    return processed_commands;
+}
+
+/**
+ * @brief Stacks the input events recorded during the current frame of a replayed session, in the order they were
+ * recorded. Events received from other threads are stacked where the inbox of the stack was drained, and the others
+ * after the entities were stepped, where the entities reading devices stack them. They are detached from any entity,
+ * and an event whose scope cannot be found in the tree anymore is dropped.
+ *
+ * @param[inout] handle Engine handle.
+ * @param[in] is_received If set, the events received from other threads are stacked.
+ */
+static void basilisk_engine_replay_input_events(basilisk_engine *handle, bool is_received)
+{
+    identifier *event_name = nullptr;
+    identifier *scope_path = nullptr;
+    path *scope_ids = nullptr;
+    basilisk_engine_entity *scope = nullptr;
+    basilisk_specific_event event_data = { 0u };
+
+    while (recorder_read_event(handle->recorder, is_received, &event_name, &scope_path, &event_data, handle->alloc)) {
+        scope = nullptr;
+        if (scope_path) {
+            scope_ids = path_from_cstring(scope_path->data, handle->alloc);
+            scope = basilisk_engine_entity_get_child(handle->root_entity, scope_ids);
+            path_destroy(&scope_ids, handle->alloc);
+        }
+
+        if (scope_path && !scope) {
+            logger_log(handle->logger, LOGGER_SEVERITY_ERRO, "Dropped replayed event \"%s\" : its scope \"%s\" does not exist.\n", event_name->data, scope_path->data);
+        } else {
+            (void) event_stack_push(handle->events, handle->root_entity, scope, event_name->data, event_data, handle->alloc);
+        }
+
+        range_destroy_dynamic(handle->alloc, &RANGE_TO_ANY(event_name));
+        if (scope_path) {
+            range_destroy_dynamic(handle->alloc, &RANGE_TO_ANY(scope_path));
+        }
+        if (event_data.data) {
+            handle->alloc.free(handle->alloc, event_data.data);
+        }
+    }
+}
+
+/**
+ * @brief Records an input event received from another thread, when the inbox of the event stack is drained at the
+ * start of the frame. Recording it there keeps the events in the order they reach the stack.
+ *
+ * @param[inout] context Engine handle.
+ * @param[in] item Received event.
+ */
+static void basilisk_engine_record_received_input(void *context, const event_stacked *item)
+{
+    basilisk_engine *handle = (basilisk_engine *) context;
+    identifier *scope_path = nullptr;
+
+    if (!handle->recorder) {
+        return;
+    }
+
+    scope_path = basilisk_engine_path_to(handle, item->ev.scope);
+
+    recorder_write_event(handle->recorder, true, item->ev.name->data, (scope_path) ? scope_path->data : nullptr, (basilisk_specific_event) {
+            .is_input = true,
+            .is_deferred = item->is_deferred,
+            .priority = (int) item->priority,
+            .delay_ms = (unsigned long) item->delay_ms,
+            .data_size = (unsigned long) item->ev.data_size,
+            .data = item->ev.data,
+    });
+
+    if (scope_path) {
+        range_destroy_dynamic(handle->alloc, &RANGE_TO_ANY(scope_path));
     }
 }
 
+/**
+ * @brief Builds the path from the root entity to an entity : the names of the entity and its parents, separated by '/',
+ * as understood by `path_from_cstring()`.
+ *
+ * @param[inout] handle Engine handle.
+ * @param[in] target Entity at the end of the path.
+ * @return identifier * nullptr if the entity is nullptr or the root entity.
+ */
+static identifier *basilisk_engine_path_to(basilisk_engine *handle, basilisk_engine_entity *target)
+{
+    identifier *path_name = nullptr;
+    const identifier *name = nullptr;
+
+    if (!target || (target == handle->root_entity)) {
+        return nullptr;
+    }
+
+    path_name = range_create_dynamic(handle->alloc, sizeof(*path_name->data), BASILISK_COLLECTIONS_START_LENGTH);
+    range_insert_value(RANGE_TO_ANY(path_name), 0u, &(const char) { '\0' });
+
+    while (target && (target != handle->root_entity)) {
+        name = basilisk_engine_entity_get_name(target);
+
+        path_name = range_ensure_capacity(handle->alloc, RANGE_TO_ANY(path_name), name->length);
+        if (path_name->length > 1u) {
+            range_insert_value(RANGE_TO_ANY(path_name), 0u, &(const char) { '/' });
+        }
+        // the names are prepended without their trailing '\0'
+        for (size_t i = name->length - 1u ; i > 0u ; i--) {
+            range_insert_value(RANGE_TO_ANY(path_name), 0u, name->data + (i - 1u));
+        }
+
+        target = basilisk_engine_entity_get_parent(target);
+    }
+
+    return path_name;
+}
+
 /**
  * @brief Fills the internal entities buffer collection if it was marked as dirty.
- * The active entities collection is filled from parent to children from the root entity.
+ * The active entities collection is filled from parent to children from the root entity. Subtrees made only of
+ * parallel-safe entities are set aside in their own buffers, along with the position of their parent in the active
+ * entities. The tree is explored breadth-first : those positions only grow from one subtree to the next, so all parents
+ * are found in a single pass over the active entities.
  *
  * @param[in] handle Traget engine instance.
  */
 static void basilisk_engine_update_active_entities(basilisk_engine *handle)
 {
+    basilisk_engine_entity_range *parallel_roots = nullptr;
+    basilisk_engine_parallel_step step = { 0u };
+    basilisk_engine_entity *parent = nullptr;
+    size_t parent_pos = 0u;
+
     if (!handle || !handle->update_active_entities) {
         return;
     }
@@ -732,6 +1758,152 @@ static void basilisk_engine_update_active_entities(basilisk_engine *handle)
     if (handle->active_entities) {
         range_destroy_dynamic(handle->alloc, &RANGE_TO_ANY(handle->active_entities));
     }
+    basilisk_engine_clear_parallel_steps(handle);
+
+    handle->active_entities = basilisk_engine_entity_get_children_split(handle->root_entity, &parallel_roots, handle->alloc);
+    handle->parallel_steps = range_create_dynamic(handle->alloc, sizeof(*handle->parallel_steps->data), parallel_roots->length + 1u);
+
+    for (size_t i = 0u ; i < parallel_roots->length ; i++) {
+        step = (basilisk_engine_parallel_step) { .entities = basilisk_engine_entity_get_children(parallel_roots->data[i], handle->alloc) };
+        step.entities = range_ensure_capacity(handle->alloc, RANGE_TO_ANY(step.entities), 1);
+        range_insert_value(RANGE_TO_ANY(step.entities), 0u, parallel_roots->data + i);
+
+        // the root entity is not stepped : subtrees under it can start right away
+        parent = basilisk_engine_entity_get_parent(parallel_roots->data[i]);
+        if (parent != handle->root_entity) {
+            // parents come in the same order as their subtrees : the search resumes from the last parent found
+            while ((parent_pos < handle->active_entities->length) && (handle->active_entities->data[parent_pos] != parent)) {
+                parent_pos += 1u;
+            }
+            step.stepped_after = (parent_pos < handle->active_entities->length) ? (parent_pos + 1u) : parent_pos;
+        }
+
+        range_insert_value(RANGE_TO_ANY(handle->parallel_steps), handle->parallel_steps->length, &step);
+    }
+
+    range_destroy_dynamic(handle->alloc, &RANGE_TO_ANY(parallel_roots));
+}
+
+/**
+ * @brief Releases the buffers of parallel-safe subtrees.
+ *
+ * @param[inout] handle Target engine instance.
+ */
+static void basilisk_engine_clear_parallel_steps(basilisk_engine *handle)
+{
+    if (!handle || !handle->parallel_steps) {
+        return;
+    }
+
+    for (size_t i = 0u ; i < handle->parallel_steps->length ; i++) {
+        range_destroy_dynamic(handle->alloc, &RANGE_TO_ANY(handle->parallel_steps->data[i].entities));
+    }
+    range_destroy_dynamic(handle->alloc, &RANGE_TO_ANY(handle->parallel_steps));
+    handle->parallel_steps = nullptr;
+}
+
+/**
+ * @brief Worker task stepping all entities of a parallel-safe subtree, from its root to its leafs.
+ *
+ * @param[inout] task_args Pointer to a basilisk_engine_parallel_step object.
+ */
+static void basilisk_engine_parallel_step_task(void *task_args)
+{
+    basilisk_engine_parallel_step *step = (basilisk_engine_parallel_step *) task_args;
+
+    for (size_t i = 0u ; i < step->entities->length ; i++) {
+        basilisk_engine_entity_step_frame(step->entities->data[i], step->elapsed_ms);
+    }
+}
+
+/**
+ * @brief Job routine reading all resources of a storage file in memory, on a worker thread.
+ *
+ * @param[inout] job_data Pointer to a basilisk_engine_prefetch object.
+ */
+static void basilisk_engine_prefetch_routine(void *job_data)
+{
+    basilisk_engine_prefetch *prefetch = (basilisk_engine_prefetch *) job_data;
+
+    (void) resource_manager_prefetch(prefetch->progress.str_storage_path, &basilisk_engine_prefetch_progress, prefetch);
+}
+
+/**
+ * @brief Updates the progress of a prefetch, and sends it to all entities each time another percent of the storage is
+ * read. Called from the worker thread : the event goes through the inbox of the event stack, sent by the root entity
+ * as the prefetching entity might be removed meanwhile.
+ *
+ * @param[inout] context Pointer to a basilisk_engine_prefetch object.
+ * @param[in] prefetched_count Number of resources read so far.
+ * @param[in] resources_count Number of resources in the storage.
+ */
+static void basilisk_engine_prefetch_progress(void *context, size_t prefetched_count, size_t resources_count)
+{
+    basilisk_engine_prefetch *prefetch = (basilisk_engine_prefetch *) context;
+
+    prefetch->progress.prefetched_count = prefetched_count;
+    prefetch->progress.resources_count = resources_count;
+
+    if (((prefetched_count * 100u) / resources_count) == (((prefetched_count - 1u) * 100u) / resources_count)) {
+        return;
+    }
+
+    event_stack_push_threadsafe(prefetch->handle->events, prefetch->handle->root_entity, nullptr, BASILISK_EVENT_STORAGE_PROGRESS,
+            (basilisk_specific_event) { .data_size = sizeof(prefetch->progress), .data = &prefetch->progress }, prefetch->handle->alloc);
+}
+
+/**
+ * @brief Sends the event signaling that a storage was prefetched, on the main thread.
+ *
+ * @param[inout] self_data Entity that asked for the prefetch.
+ * @param[inout] job_data Pointer to a basilisk_engine_prefetch object.
+ */
+static void basilisk_engine_prefetch_done(basilisk_entity *self_data, void *job_data)
+{
+    basilisk_engine_prefetch *prefetch = (basilisk_engine_prefetch *) job_data;
+
+    basilisk_entity_stack_event(self_data, BASILISK_EVENT_STORAGE_PREFETCHED, (basilisk_specific_event) {
+            .is_detached = true,
+            .data_size = sizeof(prefetch->progress),
+            .data = &prefetch->progress,
+    });
+}
+
+/**
+ * @brief Checks if the calling thread is the one running (or that will run) the engine's main loop. While that thread
+ * executes a pool task (helping the workers when it waits on them), it is treated as a worker, so that the code of a
+ * task behaves the same whichever thread picked it.
+ *
+ * @param[in] handle Target engine instance.
+ * @return bool
+ */
+static bool basilisk_engine_is_main_thread(const basilisk_engine *handle)
+{
+    if (!handle || worker_pool_is_running_task()) {
+        return false;
+    }
+
+    return thrd_equal(thrd_current(), handle->main_thread) != 0;
+}
+
+/**
+ * @brief Checks if the calling thread is the one running the engine's main loop. If not, an error is logged and the
+ * caller is expected to do nothing : the function it guards touches engine data that is not protected for other
+ * threads.
+ *
+ * @param[in] handle Target engine instance.
+ * @param[in] str_function Name of the guarded function, for the log.
+ * @return bool
+ */
+static bool basilisk_engine_require_main_thread(const basilisk_engine *handle, const char *str_function)
+{
+    if (basilisk_engine_is_main_thread(handle)) {
+        return true;
+    }
+
+    if (handle) {
+        logger_log(handle->logger, LOGGER_SEVERITY_ERRO, "Cannot call %s() outside of the main thread, the call is ignored.\n", str_function);
+    }
 
-    handle->active_entities = basilisk_engine_entity_get_children(handle->root_entity, handle->alloc);
+    return false;
 }
@@ -14,6 +14,7 @@
 #include <basilisk.h>
 
 #include "basilisk_entity.h"
+#include "../message/basilisk_message.h"
 
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -40,6 +41,19 @@ typedef struct basilisk_engine_entity {
 
     basilisk_entity_definition self_definition;
 
+    /** Messages sent directly to the entity, waiting to be delivered. */
+    message_mailbox mailbox;
+
+    /** Handles of the subscriptions made by the entity, revoked when it is removed. */
+    RANGE(u64) *subscriptions;
+    /** Last run of concurrent callbacks the entity was given a delivery in. */
+    u64 fanout_run;
+
+    /** Number of the entity in a depth-first walk of the tree. */
+    size_t subtree_first;
+    /** Greatest number of the entity's subtree in a depth-first walk of the tree. */
+    size_t subtree_last;
+
     /** The user's data. */
     basilisk_entity_storage data;
 } basilisk_engine_entity;
@@ -82,9 +96,14 @@ basilisk_engine_entity *basilisk_engine_entity_create(const identifier *id, basi
                         .on_init = user_data.entity_def.on_init,
                         .on_deinit = user_data.entity_def.on_deinit,
                         .on_frame = user_data.entity_def.on_frame,
+                        .on_message = user_data.entity_def.on_message,
+                        .is_parallel_safe = user_data.entity_def.is_parallel_safe,
 
                         .data_size = user_data.entity_def.data_size,
-                }
+                },
+
+                .mailbox = message_mailbox_create(new_entity),
+                .subscriptions = range_create_dynamic(alloc, sizeof(*new_entity->subscriptions->data), BASILISK_COLLECTIONS_START_LENGTH),
         };
 
         // optional starting data
@@ -111,6 +130,7 @@ void basilisk_engine_entity_destroy(basilisk_engine_entity **target, allocator a
 
     range_destroy_dynamic(alloc, &RANGE_TO_ANY((*target)->children));
     range_destroy_dynamic(alloc, &RANGE_TO_ANY((*target)->id));
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*target)->subscriptions));
 
     alloc.free(alloc, *target);
     *target = nullptr;
@@ -178,6 +198,21 @@ const identifier *basilisk_engine_entity_get_name(const basilisk_engine_entity *
     return target->id;
 }
 
+/**
+ * @brief Returns a reference to the mailbox receiving the messages sent directly to an entity.
+ *
+ * @param[in] target Target entity.
+ * @return message_mailbox *
+ */
+message_mailbox *basilisk_engine_entity_get_mailbox(basilisk_engine_entity *target)
+{
+    if (!target) {
+        return nullptr;
+    }
+
+    return &target->mailbox;
+}
+
 /**
  * @brief Returns the direct parent of the entity.
  *
@@ -356,6 +391,216 @@ basilisk_engine_entity_range *basilisk_engine_entity_get_children(basilisk_engin
     return entities;
 }
 
+/**
+ * @brief Returns an allocated range of the children of an entity, in the same parent-to-children order as
+ * `basilisk_engine_entity_get_children()`, except that subtrees made only of parallel-safe entities are not explored.
+ * The roots of those subtrees are instead appended to a second range, allocated by the function.
+ *
+ * @param[in] target Entity from which to extract children.
+ * @param[out] out_parallel_roots Outgoing allocated range of the roots of the parallel-safe subtrees.
+ * @param[inout] alloc Allocator used to create the returned ranges.
+ * @return basilisk_engine_entity_range*
+ */
+basilisk_engine_entity_range *basilisk_engine_entity_get_children_split(basilisk_engine_entity *target, basilisk_engine_entity_range **out_parallel_roots, allocator alloc)
+{
+    size_t child_pos = 0u;
+    basilisk_engine_entity *child = nullptr;
+    basilisk_engine_entity_range *entities = nullptr;
+    basilisk_engine_entity_range *explored = nullptr;
+
+    if (!target || !out_parallel_roots) {
+        return nullptr;
+    }
+
+    entities = range_create_dynamic(alloc, sizeof(*entities->data), BASILISK_COLLECTIONS_START_LENGTH);
+    *out_parallel_roots = range_create_dynamic(alloc, sizeof(*(*out_parallel_roots)->data), BASILISK_COLLECTIONS_START_LENGTH);
+    explored = range_create_dynamic_from_copy_of(alloc, RANGE_TO_ANY(target->children));
+
+    while (child_pos < explored->length) {
+        child = explored->data[child_pos];
+
+        if (basilisk_engine_entity_is_parallel_safe_subtree(child)) {
+            *out_parallel_roots = range_ensure_capacity(alloc, RANGE_TO_ANY(*out_parallel_roots), 1);
+            range_insert_value(RANGE_TO_ANY(*out_parallel_roots), (*out_parallel_roots)->length, &child);
+        } else {
+            entities = range_ensure_capacity(alloc, RANGE_TO_ANY(entities), 1);
+            range_insert_value(RANGE_TO_ANY(entities), entities->length, &child);
+
+            explored = range_ensure_capacity(alloc, RANGE_TO_ANY(explored), child->children->length);
+            range_insert_range(RANGE_TO_ANY(explored), explored->length, RANGE_TO_ANY(child->children));
+        }
+
+        child_pos += 1u;
+    }
+
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY(explored));
+
+    return entities;
+}
+
+/**
+ * @brief Checks that an entity and all of its children, recursively, were created from definitions marked as parallel-safe.
+ *
+ * @param[in] target Root of the examined subtree.
+ * @return bool
+ */
+bool basilisk_engine_entity_is_parallel_safe_subtree(const basilisk_engine_entity *target)
+{
+    bool is_safe = false;
+
+    if (!target) {
+        return false;
+    }
+
+    is_safe = target->self_definition.is_parallel_safe;
+
+    for (size_t i = 0u ; is_safe && (i < target->children->length) ; i++) {
+        is_safe = basilisk_engine_entity_is_parallel_safe_subtree(target->children->data[i]);
+    }
+
+    return is_safe;
+}
+
+/**
+ * @brief Numbers an entity and all of its children, recursively, in depth-first order. Each entity then knows the
+ * interval of numbers covered by its subtree, and checking that an entity is in a subtree takes two comparisons.
+ * Returns the number following the last one given.
+ *
+ * @param[inout] target Root of the numbered subtree.
+ * @param[in] first_index Number given to the root of the subtree.
+ * @return size_t
+ */
+size_t basilisk_engine_entity_index_subtree(basilisk_engine_entity *target, size_t first_index)
+{
+    size_t next_index = first_index;
+
+    if (!target) {
+        return first_index;
+    }
+
+    target->subtree_first = first_index;
+    next_index += 1u;
+
+    for (size_t i = 0u ; i < target->children->length ; i++) {
+        next_index = basilisk_engine_entity_index_subtree(target->children->data[i], next_index);
+    }
+
+    target->subtree_last = next_index - 1u;
+
+    return next_index;
+}
+
+/**
+ * @brief Checks that an entity is the root of some subtree or one of its children, using the numbers given by the
+ * last call to `basilisk_engine_entity_index_subtree()`.
+ *
+ * @param[in] target Examined entity.
+ * @param[in] subtree_root Root of the subtree.
+ * @return bool
+ */
+bool basilisk_engine_entity_is_in_subtree(const basilisk_engine_entity *target, const basilisk_engine_entity *subtree_root)
+{
+    if (!target || !subtree_root) {
+        return false;
+    }
+
+    return (subtree_root->subtree_first <= target->subtree_first) && (target->subtree_first <= subtree_root->subtree_last);
+}
+
+/**
+ * @brief Remembers the handle of a subscription made by an entity, so it can be revoked when the entity is removed.
+ *
+ * @param[inout] target Entity that made the subscription.
+ * @param[in] subscription_handle Handle of the subscription.
+ * @param[inout] alloc Allocator used to extend the entity's handles.
+ */
+void basilisk_engine_entity_add_subscription(basilisk_engine_entity *target, u64 subscription_handle, allocator alloc)
+{
+    if (!target || (subscription_handle == 0u)) {
+        return;
+    }
+
+    target->subscriptions = range_ensure_capacity(alloc, RANGE_TO_ANY(target->subscriptions), 1);
+    range_insert_value(RANGE_TO_ANY(target->subscriptions), target->subscriptions->length, &subscription_handle);
+}
+
+/**
+ * @brief Forgets the handle of a subscription made by an entity. Returns false if the entity did not make the
+ * subscription. The last handle takes the place of the removed one, as the order of the handles does not matter.
+ *
+ * @param[inout] target Entity that made the subscription.
+ * @param[in] subscription_handle Handle of the subscription.
+ * @return bool
+ */
+bool basilisk_engine_entity_remove_subscription(basilisk_engine_entity *target, u64 subscription_handle)
+{
+    if (!target) {
+        return false;
+    }
+
+    for (size_t i = 0u ; i < target->subscriptions->length ; i++) {
+        if (target->subscriptions->data[i] == subscription_handle) {
+            target->subscriptions->data[i] = target->subscriptions->data[target->subscriptions->length - 1u];
+            range_remove(RANGE_TO_ANY(target->subscriptions), target->subscriptions->length - 1u);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Forgets and returns the handle of the last subscription made by an entity, or zero if it has none.
+ *
+ * @param[inout] target Examined entity.
+ * @return u64
+ */
+u64 basilisk_engine_entity_pop_subscription(basilisk_engine_entity *target)
+{
+    u64 subscription_handle = 0u;
+
+    if (!target || (target->subscriptions->length == 0u)) {
+        return 0u;
+    }
+
+    subscription_handle = target->subscriptions->data[target->subscriptions->length - 1u];
+    range_remove(RANGE_TO_ANY(target->subscriptions), target->subscriptions->length - 1u);
+
+    return subscription_handle;
+}
+
+/**
+ * @brief Returns the last run of concurrent callbacks an entity was given a delivery in, as set by
+ * `basilisk_engine_entity_set_fanout_run()`.
+ *
+ * @param[in] target Examined entity.
+ * @return u64
+ */
+u64 basilisk_engine_entity_get_fanout_run(const basilisk_engine_entity *target)
+{
+    if (!target) {
+        return 0u;
+    }
+
+    return target->fanout_run;
+}
+
+/**
+ * @brief Marks an entity as given a delivery in some run of concurrent callbacks. Only the thread publishing the events
+ * reads and writes this mark.
+ *
+ * @param[inout] target Target entity.
+ * @param[in] fanout_run Number of the run.
+ */
+void basilisk_engine_entity_set_fanout_run(basilisk_engine_entity *target, u64 fanout_run)
+{
+    if (!target) {
+        return;
+    }
+
+    target->fanout_run = fanout_run;
+}
+
 /**
  * @brief Calls the `.on_frame()` callback of some entity, if it exists.
  *
@@ -374,19 +619,81 @@ void basilisk_engine_entity_step_frame(basilisk_engine_entity *target, f32 elaps
 }
 
 /**
- * @brief Calls an arbitrary event callback over an entity.
+ * @brief Calls an arbitrary event callback over an entity. A batch callback receives all the events at once, while a
+ * plain callback receives them one after the other. A trampoline also receives them one after the other, along with the
+ * typed callback it converts back to its actual type.
+ *
+ * @param[inout] target Target entity.
+ * @param[in] subscription_data Event callbacks.
+ * @param[inout] events_data Contiguous array of the data of the events passed to the callback.
+ * @param[in] data_size Number of bytes of data of each event.
+ * @param[in] count Number of events.
+ */
+void basilisk_engine_entity_send_event(basilisk_engine_entity *target, basilisk_specific_event_subscription subscription_data, void *events_data, size_t data_size, size_t count)
+{
+    if (!target) {
+        return;
+    }
+
+    if (subscription_data.batch_callback) {
+        subscription_data.batch_callback(target->data, events_data, count);
+    } else if (subscription_data.callback) {
+        for (size_t i = 0u ; i < count ; i++) {
+            subscription_data.callback(target->data, (events_data) ? ((byte *) events_data + (i * data_size)) : nullptr);
+        }
+    } else if (subscription_data.trampoline) {
+        for (size_t i = 0u ; i < count ; i++) {
+            subscription_data.trampoline(target->data, (events_data) ? ((byte *) events_data + (i * data_size)) : nullptr, subscription_data.typed_callback);
+        }
+    }
+}
+
+/**
+ * @brief Calls a timer callback over an entity.
+ *
+ * @param[inout] target Target entity.
+ * @param[in] callback Timer callback.
+ * @param[inout] timer_data Timer data passed to the callback.
+ */
+void basilisk_engine_entity_send_timer(basilisk_engine_entity *target, void (*callback)(basilisk_entity *self_data, void *timer_data), void *timer_data)
+{
+    if (!target || !callback) {
+        return;
+    }
+
+    callback(target->data, timer_data);
+}
+
+/**
+ * @brief Calls the on_message() callback of an entity, if it has one.
+ *
+ * @param[inout] target Target entity.
+ * @param[in] message_id User-defined identifier of the message.
+ * @param[inout] message_data Message data passed to the callback.
+ */
+void basilisk_engine_entity_send_message(basilisk_engine_entity *target, unsigned long message_id, void *message_data)
+{
+    if (!target || !target->self_definition.on_message) {
+        return;
+    }
+
+    target->self_definition.on_message(target->data, message_id, message_data);
+}
+
+/**
+ * @brief Calls a job completion callback over an entity.
  *
  * @param[inout] target Target entity.
- * @param[in] callback Event callback.
- * @param[inout] event_data Event data passed to the callback.
+ * @param[in] on_done Completion callback.
+ * @param[inout] job_data Job data passed to the callback.
  */
-void basilisk_engine_entity_send_event(basilisk_engine_entity *target, basilisk_specific_event_subscription subscription_data, void *event_data)
+void basilisk_engine_entity_send_job_result(basilisk_engine_entity *target, void (*on_done)(basilisk_entity *self_data, void *job_data), void *job_data)
 {
-    if (!target || !subscription_data.callback) {
+    if (!target || !on_done) {
         return;
     }
 
-    subscription_data.callback(target->data, event_data);
+    on_done(target->data, job_data);
 }
 
 /**
@@ -430,5 +737,6 @@ static bool basilisk_entity_definition_unit_is_same_as(basilisk_entity_definitio
     return   (def_unit.data_size == broad_def.data_size)
             && (def_unit.on_init   == broad_def.on_init)
             && (def_unit.on_frame  == broad_def.on_frame)
+            && (def_unit.on_message == broad_def.on_message)
             && (def_unit.on_deinit == broad_def.on_deinit);
 }
@@ -25,6 +25,9 @@ typedef struct basilisk_engine_entity basilisk_engine_entity;
 /* Quickhand for a range of entities. */
 typedef RANGE(basilisk_engine_entity *) basilisk_engine_entity_range;
 
+/* Messages sent directly to an entity, see the message module. */
+typedef struct message_mailbox message_mailbox;
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -46,6 +49,8 @@ basilisk_entity *basilisk_engine_entity_get_specific_data(basilisk_engine_entity
 basilisk_engine *basilisk_engine_entity_get_host_engine_handle(basilisk_engine_entity *target);
 /* Returns the name of an entity. */
 const identifier *basilisk_engine_entity_get_name(const basilisk_engine_entity *target);
+/* Returns the mailbox receiving the messages sent directly to an entity. */
+message_mailbox *basilisk_engine_entity_get_mailbox(basilisk_engine_entity *target);
 
 basilisk_engine_entity *basilisk_engine_entity_get_parent(basilisk_engine_entity *target);
 
@@ -70,6 +75,33 @@ basilisk_engine_entity *basilisk_engine_entity_get_child(basilisk_engine_entity
 basilisk_engine_entity *basilisk_engine_entity_get_direct_child(basilisk_engine_entity *target, const identifier *id_path);
 /* Returns an allocated range of all children of an entity, recursively. */
 basilisk_engine_entity_range *basilisk_engine_entity_get_children(basilisk_engine_entity *target, allocator alloc);
+/* Returns an allocated range of all children of an entity, recursively, setting aside the subtrees that can be stepped concurrently. */
+basilisk_engine_entity_range *basilisk_engine_entity_get_children_split(basilisk_engine_entity *target, basilisk_engine_entity_range **out_parallel_roots, allocator alloc);
+/* Checks that an entity and all of its children are marked as parallel-safe. */
+bool basilisk_engine_entity_is_parallel_safe_subtree(const basilisk_engine_entity *target);
+
+// -------------------------------------------------------------------------------------------------
+// SUBTREE INDEX
+
+/* Numbers an entity and all of its children in depth-first order, so that each subtree covers an interval of numbers. */
+size_t basilisk_engine_entity_index_subtree(basilisk_engine_entity *target, size_t first_index);
+/* Checks, from the last numbering, that an entity is in the subtree of another. */
+bool basilisk_engine_entity_is_in_subtree(const basilisk_engine_entity *target, const basilisk_engine_entity *subtree_root);
+
+// -------------------------------------------------------------------------------------------------
+// SUBSCRIPTIONS
+
+/* Remembers the handle of a subscription made by an entity. */
+void basilisk_engine_entity_add_subscription(basilisk_engine_entity *target, u64 subscription_handle, allocator alloc);
+/* Forgets the handle of a subscription made by an entity, and checks that the entity made it. */
+bool basilisk_engine_entity_remove_subscription(basilisk_engine_entity *target, u64 subscription_handle);
+/* Forgets and returns the handle of one of the subscriptions made by an entity, or zero if there are none left. */
+u64 basilisk_engine_entity_pop_subscription(basilisk_engine_entity *target);
+
+/* Returns the last run of concurrent callbacks an entity was given a delivery in. */
+u64 basilisk_engine_entity_get_fanout_run(const basilisk_engine_entity *target);
+/* Marks an entity as given a delivery in some run of concurrent callbacks. */
+void basilisk_engine_entity_set_fanout_run(basilisk_engine_entity *target, u64 fanout_run);
 
 // -------------------------------------------------------------------------------------------------
 // CALLBACKS EXECUTION
@@ -77,8 +109,17 @@ basilisk_engine_entity_range *basilisk_engine_entity_get_children(basilisk_engin
 /* Execute the on_frame() callback tied to an entity. */
 void basilisk_engine_entity_step_frame(basilisk_engine_entity *target, f32 elapsed_ms);
 
-/* Execute an event callback trusted to be linked to an entity. */
-void basilisk_engine_entity_send_event(basilisk_engine_entity *target, basilisk_specific_event_subscription subscription_data, void *event_data);
+/* Execute an event callback trusted to be linked to an entity, once per event or once for the whole batch. */
+void basilisk_engine_entity_send_event(basilisk_engine_entity *target, basilisk_specific_event_subscription subscription_data, void *events_data, size_t data_size, size_t count);
+
+/* Execute a timer callback trusted to be linked to an entity. */
+void basilisk_engine_entity_send_timer(basilisk_engine_entity *target, void (*callback)(basilisk_entity *self_data, void *timer_data), void *timer_data);
+
+/* Execute the on_message() callback tied to an entity. */
+void basilisk_engine_entity_send_message(basilisk_engine_entity *target, unsigned long message_id, void *message_data);
+
+/* Execute a job completion callback trusted to be linked to an entity. */
+void basilisk_engine_entity_send_job_result(basilisk_engine_entity *target, void (*on_done)(basilisk_entity *self_data, void *job_data), void *job_data);
 
 /* Execute the on_init() callback tied to an entity */
 void basilisk_engine_entity_init(basilisk_engine_entity *target);
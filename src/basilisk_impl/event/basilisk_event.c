@@ -8,44 +8,88 @@
  * @copyright Copyright (c) 2024
  *
  */
+#include <stdatomic.h>
+
 #include <ustd/sorting.h>
 
 #include "../entity/basilisk_entity.h"
 #include "basilisk_event.h"
+#include "event_channel/basilisk_event_channel.h"
 #include "event_subscription/basilisk_event_subscription.h"
+#include "event_prefix/basilisk_event_prefix.h"
+#include "event_delay/basilisk_event_delay.h"
+#include "../inbox/basilisk_inbox.h"
 
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 
-/**
- * @brief Stores an event linked to an entity that stacked it.
- */
-typedef struct event_stacked {
-    /** Entity that stacked the event. Might be nullptr. */
-    basilisk_engine_entity *source;
-    /** Actual event. */
-    event ev;
-} event_stacked;
-
-// -------------------------------------------------------------------------------------------------
-
 /**
  * @brief Maintains lists of callbacks subscribed to events.
  */
 typedef struct event_broker {
     /** Collection of all lists of subscriptions. */
     RANGE(event_subscription_list) *subs;
+    /** Subscriptions to names ending with a '*', matching all event names starting with the same prefix. */
+    event_prefix_trie *prefixes;
+    /** Prefix subscriptions already resolved for some event names, sorted by name. Emptied when the prefixes change. */
+    RANGE(event_prefix_match) *prefix_cache;
+
+    /** Current generation of each subscription slot. A subscription is live while its slot is at its generation. */
+    RANGE(u32) *slot_generations;
+    /** Slots of unsubscribed handles, given again to new handles. Only used by the main thread. */
+    RANGE(u32) *free_slots;
+    /** First slot never given to a handle, shared with other threads. */
+    atomic_uint_least32_t next_fresh_slot;
+
+    /** Buffers used to send events to concurrent subscriptions. */
+    event_subscription_fanout fanout;
 } event_broker;
 
 // -------------------------------------------------------------------------------------------------
 
 /**
- * @brief Stacks events top be retreived later.
+ * @brief Fixed payload of the events of some name, declared once for all the events of this name.
+ */
+typedef struct event_type {
+    /** Name of the events of this type. */
+    identifier *event_name;
+    /** Number of bytes the data of each event must take. */
+    size_t payload_size;
+    /** Blocks holding the data of the events of this type, aligned as declared. */
+    event_payload_pool *pool;
+} event_type;
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Stacks events top be retreived later. Events are sent from the carried events first, then the LIFO stack,
+ * then the priority heap and finally the FIFO ring buffer, depending on the dispatch mode of their name. Events
+ * held by batched or coalescing channels join the ring buffer once everything else was sent.
  */
 typedef struct event_stack {
-    /** Actual stack implementation with a range. */
+    /** Actual stack implementation with a range, holding the events of LIFO channels. */
     RANGE(event_stacked) *stack_impl;
+    /** Events of FIFO channels. */
+    event_fifo *fifo;
+    /** Events of priority channels. */
+    event_heap *heap;
+    /** Events left over by a capped event phase, the next one to send at the end. */
+    RANGE(event_stacked) *carried;
+    /** Deferred and delayed events, not in the stack until their time has come. */
+    event_delay_queue *waiting;
+
+    /** Dispatch settings of the event names that are not sent in LIFO order, sorted by name. */
+    RANGE(event_channel) *channels;
+    /** Number of events held by the channels, updated as they hold and flush events. */
+    size_t held_count;
+    /** Sequence number of the next stacked event. */
+    u64 next_sequence;
+    /** Declared payloads of event names, sorted by name. */
+    RANGE(event_type) *types;
+
+    /** Events pushed from other threads, waiting to be moved to the range. */
+    mpsc_inbox *inbox;
 } event_stack;
 
 // -------------------------------------------------------------------------------------------------
@@ -53,10 +97,40 @@ typedef struct event_stack {
 // -------------------------------------------------------------------------------------------------
 
 /* Allocates an event from some user adta and a name. */
-static event event_create(const char *str_event_name, size_t event_data_size, const void *event_data, allocator alloc);
+static event event_create(identifier *event_name, size_t event_data_size, const void *event_data, bool is_borrowed, event_payload_pool *pool, allocator alloc);
+
+/* Replaces the borrowed data of an event by a copy owned by the event. */
+static void event_own_data(event *ev, allocator alloc);
+
+/* Computes a checksum of some bytes. */
+static u64 event_data_checksum(const void *data, size_t data_size);
+
+/* Forgets all resolved prefix subscriptions of an event broker. */
+static void event_broker_clear_prefix_cache(event_broker *broker, allocator alloc);
+
+/* Returns the prefix subscriptions matching an event name, resolving them if they are not cached yet. */
+static event_prefix_match *event_broker_get_prefix_match(event_broker *broker, identifier *event_name, allocator alloc);
+
+/* Returns the declared type of an event name, or nullptr if it has none. */
+static event_type *event_stack_find_type(const event_stack *stack, identifier *event_name);
+
+/* Checks that the data of an event fits the declared type of its name, if any. */
+static bool event_stack_is_well_typed(const event_stack *stack, const event *ev);
+
+/* Returns a copy of the settings of an event name, without its name and held events. */
+static event_channel event_stack_get_channel_settings(const event_stack *stack, const char *str_event_name, allocator alloc);
+
+/* Replaces the settings of an event name. */
+static void event_stack_replace_channel(event_stack *stack, event_channel new_channel, allocator alloc);
+
+/* Places an event in the collection matching the dispatch mode of its name. */
+static void event_stack_place(event_stack *stack, event_stacked item, allocator alloc);
+
+/* Removes the next event to send, ignoring the carried events. */
+static bool event_stack_take(event_stack *stack, event_stacked *out_item, allocator alloc);
 
-/* Removes all subcriptions with zero callacks registered. */
-static void event_broker_cleanup_empty_subscriptions(event_broker *broker, allocator alloc);
+/* Moves the events held by all channels to the FIFO ring buffer. */
+static bool event_stack_flush_held(event_stack *stack, allocator alloc);
 
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -77,7 +151,13 @@ event_broker *event_broker_create(allocator alloc)
     if (new_broker) {
         *new_broker = (event_broker) {
                 .subs = range_create_dynamic(alloc, sizeof(*new_broker->subs->data), BASILISK_COLLECTIONS_START_LENGTH),
+                .prefixes = event_prefix_trie_create(alloc),
+                .prefix_cache = range_create_dynamic(alloc, sizeof(*new_broker->prefix_cache->data), BASILISK_COLLECTIONS_START_LENGTH),
+                .slot_generations = range_create_dynamic(alloc, sizeof(*new_broker->slot_generations->data), BASILISK_COLLECTIONS_START_LENGTH),
+                .free_slots = range_create_dynamic(alloc, sizeof(*new_broker->free_slots->data), BASILISK_COLLECTIONS_START_LENGTH),
+                .fanout = event_subscription_fanout_create(alloc),
         };
+        atomic_init(&new_broker->next_fresh_slot, 0u);
     }
 
     return new_broker;
@@ -100,6 +180,15 @@ void event_broker_destroy(event_broker **broker, allocator alloc)
     }
 
     range_destroy_dynamic(alloc, &RANGE_TO_ANY((*broker)->subs));
+
+    event_broker_clear_prefix_cache(*broker, alloc);
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*broker)->prefix_cache));
+    event_prefix_trie_destroy(&(*broker)->prefixes, alloc);
+
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*broker)->slot_generations));
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*broker)->free_slots));
+    event_subscription_fanout_destroy(&(*broker)->fanout, alloc);
+
     alloc.free(alloc, *broker);
 
     *broker = nullptr;
@@ -122,6 +211,13 @@ event_stack *event_stack_create(allocator alloc)
     if (new_stack) {
         *new_stack = (event_stack) {
                 .stack_impl = range_create_dynamic(alloc, sizeof(*(new_stack->stack_impl->data)), BASILISK_COLLECTIONS_START_LENGTH),
+                .fifo = event_fifo_create(alloc),
+                .heap = event_heap_create(alloc),
+                .carried = range_create_dynamic(alloc, sizeof(*(new_stack->carried->data)), BASILISK_COLLECTIONS_START_LENGTH),
+                .waiting = event_delay_queue_create(alloc),
+                .channels = range_create_dynamic(alloc, sizeof(*(new_stack->channels->data)), BASILISK_COLLECTIONS_START_LENGTH),
+                .types = range_create_dynamic(alloc, sizeof(*(new_stack->types->data)), BASILISK_COLLECTIONS_START_LENGTH),
+                .inbox = mpsc_inbox_create(sizeof(event_stacked), alloc),
         };
     }
 
@@ -140,34 +236,112 @@ void event_stack_destroy(event_stack **stack, allocator alloc)
         return;
     }
 
+    event_stack_drain_inbox(*stack, nullptr, nullptr, alloc);
+    mpsc_inbox_destroy(&(*stack)->inbox, alloc);
+
     for (size_t i = 0u ; i < (*stack)->stack_impl->length ; i++) {
         event_destroy(&(*stack)->stack_impl->data[i].ev, alloc);
     }
+    for (size_t i = 0u ; i < (*stack)->carried->length ; i++) {
+        event_destroy(&(*stack)->carried->data[i].ev, alloc);
+    }
 
+    for (size_t i = 0u ; i < (*stack)->channels->length ; i++) {
+        event_channel_destroy((*stack)->channels->data + i, alloc);
+    }
+
+    event_delay_queue_destroy(&(*stack)->waiting, alloc);
+    event_heap_destroy(&(*stack)->heap, alloc);
+    event_fifo_destroy(&(*stack)->fifo, alloc);
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*stack)->channels));
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*stack)->carried));
     range_destroy_dynamic(alloc, &RANGE_TO_ANY((*stack)->stack_impl));
 
+    for (size_t i = 0u ; i < (*stack)->types->length ; i++) {
+        range_destroy_dynamic(alloc, &RANGE_TO_ANY((*stack)->types->data[i].event_name));
+        event_payload_pool_destroy(&(*stack)->types->data[i].pool, alloc);
+    }
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*stack)->types));
+
     alloc.free(alloc, *stack);
     *stack = nullptr;
 }
 
 // -------------------------------------------------------------------------------------------------
 
+/**
+ * @brief Reserves the handle of a subscription that will be made later, reusing the slot of a previous subscription
+ * if possible. The slot is not live until the subscription is made with the handle.
+ * Must be called from the thread running the engine.
+ *
+ * @param[inout] broker Broker that will store the subscription.
+ * @return u64
+ */
+u64 event_broker_reserve_handle(event_broker *broker)
+{
+    u32 slot = 0u;
+
+    if (!broker) {
+        return 0u;
+    }
+
+    if (broker->free_slots->length == 0u) {
+        return event_broker_reserve_handle_threadsafe(broker);
+    }
+
+    slot = broker->free_slots->data[broker->free_slots->length - 1u];
+    range_remove(RANGE_TO_ANY(broker->free_slots), broker->free_slots->length - 1u);
+
+    return event_subscription_handle_create(slot, broker->slot_generations->data[slot] + 1u);
+}
+
+/**
+ * @brief Reserves the handle of a subscription that will be made later, on a slot never used before.
+ * This function can be called from any thread.
+ *
+ * @param[inout] broker Broker that will store the subscription.
+ * @return u64
+ */
+u64 event_broker_reserve_handle_threadsafe(event_broker *broker)
+{
+    if (!broker) {
+        return 0u;
+    }
+
+    return event_subscription_handle_create((u32) atomic_fetch_add(&broker->next_fresh_slot, 1u), 1u);
+}
+
 /**
  * @brief Subscribes an entity and its callback to an event name.
  * When an event of this name will be published to the broker, the callback will be executed, receiving as arguments the entity data and event data.
+ * A name ending with a '*' subscribes the callback to all events whose name starts with the characters before the '*'.
  *
  * @param[inout] broker Broker to store the subscription.
  * @param[in] subscribed Entity that adds the subscription.
  * @param[in] target_event_name Event the entity subscribes the callback to.
+ * @param[in] handle Handle reserved for the subscription.
  * @param[in] subscription_data Callback data subscribed under the event.
  * @param[inout] alloc Allocator to use for eventual list creation or extension.
  */
-void event_broker_subscribe(event_broker *broker, basilisk_engine_entity *subscribed, identifier *target_event_name, basilisk_specific_event_subscription subscription_data, allocator alloc)
+void event_broker_subscribe(event_broker *broker, basilisk_engine_entity *subscribed, identifier *target_event_name, u64 handle, basilisk_specific_event_subscription subscription_data, allocator alloc)
 {
     size_t list_pos = 0u;
     event_subscription_list created_list = { 0u };
+    u32 slot = event_subscription_handle_slot(handle);
 
-    if (!broker) {
+    if (!broker || (handle == 0u)) {
+        return;
+    }
+
+    while (broker->slot_generations->length <= slot) {
+        broker->slot_generations = range_ensure_capacity(alloc, RANGE_TO_ANY(broker->slot_generations), 1);
+        range_insert_value(RANGE_TO_ANY(broker->slot_generations), broker->slot_generations->length, &(u32) { 0u });
+    }
+    broker->slot_generations->data[slot] = event_subscription_handle_generation(handle);
+
+    if (event_prefix_is_wildcard(target_event_name)) {
+        event_prefix_trie_subscribe(broker->prefixes, subscribed, target_event_name, handle, subscription_data, alloc);
+        event_broker_clear_prefix_cache(broker, alloc);
         return;
     }
 
@@ -177,122 +351,321 @@ void event_broker_subscribe(event_broker *broker, basilisk_engine_entity *subscr
         list_pos = sorted_range_insert_in(RANGE_TO_ANY(broker->subs), &identifier_compare, &created_list);
     }
 
-    event_subscription_list_append(broker->subs->data + list_pos, subscribed, subscription_data, alloc);
+    event_subscription_list_append(broker->subs->data + list_pos, subscribed, handle, subscription_data, alloc);
 }
 
 /**
- * @brief Removes an entity and its callback from a subscription to an event.
+ * @brief Revokes a subscription by moving its slot to the next generation, in constant time. The entry itself stays in
+ * its list until an event is published to the list. Unknown or already revoked handles are ignored.
  *
  * @param[inout] broker Broker currently storing the subscription.
- * @param[in] target Entity that subscribed the callback.
- * @param[in] target_event_name Event the callback is subscribed to.
- * @param[in] subscription_data Callback data previously subscribed to the event.
- * @param[inout] alloc Allocator used for the eventual list deletion.
+ * @param[in] handle Handle of the subscription.
+ * @param[inout] alloc Allocator used to keep track of the freed slot.
  */
-void event_broker_unsubscribe(event_broker *broker, basilisk_engine_entity *target, identifier *target_event_name, basilisk_specific_event_subscription subscription_data, allocator alloc)
+void event_broker_unsubscribe(event_broker *broker, u64 handle, allocator alloc)
 {
-    size_t list_pos = 0u;
+    u32 slot = event_subscription_handle_slot(handle);
 
-    if (!broker || !target || !target_event_name || !subscription_data.callback) {
+    if (!broker || (slot >= broker->slot_generations->length)) {
         return;
     }
 
-    if (sorted_range_find_in(RANGE_TO_ANY(broker->subs), &identifier_compare, &target_event_name, &list_pos)) {
-        event_subscription_list_remove(broker->subs->data + list_pos, target, subscription_data);
+    if (broker->slot_generations->data[slot] != event_subscription_handle_generation(handle)) {
+        return;
     }
 
-    event_broker_cleanup_empty_subscriptions(broker, alloc);
+    broker->slot_generations->data[slot] += 1u;
+    broker->free_slots = range_ensure_capacity(alloc, RANGE_TO_ANY(broker->free_slots), 1);
+    range_insert_value(RANGE_TO_ANY(broker->free_slots), broker->free_slots->length, &slot);
 }
 
 /**
- * @brief Removes all subscription that link back to some entity.
+ * @brief Publishes an event to all registered callbacks  that subscribed to its name, then to the callbacks subscribed
+ * to a prefix of its name, from the shortest prefix to the longest.
+ * The prefixes matching a name are resolved once and cached until the prefix subscriptions change.
+ * Concurrent callbacks are executed on the worker threads, and are all done when the function returns.
  *
- * @param[inout] broker Broker currently storing the subscriptions.
- * @param[in] target Entity that might have subscribed callbacks.
- * @param[inout] alloc Allocator used for the eventual list deletion.
+ * @param[inout] broker Target broker.
+ * @param[in] ev event sent to the callbacks.
+ * @param[inout] workers Threads executing the concurrent callbacks. If nullptr, they are executed by the calling thread.
+ * @param[inout] alloc Allocator used to cache the prefixes matching the event name.
  */
-void event_broker_unsubscribe_from_all(event_broker *broker, basilisk_engine_entity *target, allocator alloc)
+void event_broker_publish(event_broker *broker, event ev, worker_pool *workers, allocator alloc)
 {
-    size_t pos = 0u;
+    size_t list_pos = 0u;
+    event_prefix_match *match = nullptr;
 
-    if (!broker || !target) {
+    if (!broker) {
         return;
     }
 
-    for (size_t i = 0u ; i < broker->subs->length ; i++) {
-        event_subscription_list_remove_all_from(broker->subs->data + i, target);
+    broker->fanout.workers = workers;
+
+    if (sorted_range_find_in(RANGE_TO_ANY(broker->subs), &identifier_compare, &(ev.name), &list_pos)) {
+        event_subscription_list_publish(broker->subs->data + list_pos, ev, broker->slot_generations->data, &broker->fanout, alloc);
+        if (event_subscription_list_length(broker->subs->data + list_pos) == 0u) {
+            event_subscription_list_destroy(broker->subs->data + list_pos, alloc);
+            range_remove(RANGE_TO_ANY(broker->subs), list_pos);
+        }
+    }
+
+    if (event_prefix_trie_length(broker->prefixes) == 0u) {
+        return;
     }
 
-    event_broker_cleanup_empty_subscriptions(broker, alloc);
+    match = event_broker_get_prefix_match(broker, ev.name, alloc);
+    for (size_t i = 0u ; match && (i < match->lists->length) ; i++) {
+        event_subscription_list_publish(match->lists->data[i], ev, broker->slot_generations->data, &broker->fanout, alloc);
+    }
 }
 
+// -------------------------------------------------------------------------------------------------
+
 /**
- * @brief Publishes an event to all registered callbacks  that subscribed to its name.
+ * @brief Sets the order in which the events of some name are sent : LIFO (the default), FIFO, by priority or in
+ * batches. Events of this name already in the stack keep their place, and events held by the former settings are sent
+ * in FIFO order. The coalescing policy of the name is kept.
  *
- * @param[inout] broker Target broker.
- * @param[in] ev event sent to the callbacks.
+ * @param[inout] stack Target stack.
+ * @param[in] str_event_name Null-terminated string (copied) of the name of the events.
+ * @param[in] mode Order in which the events will be sent.
+ * @param[inout] alloc Allocator used for the copies.
  */
-void event_broker_publish(event_broker *broker, event ev)
+void event_stack_set_dispatch(event_stack *stack, const char *str_event_name, basilisk_event_dispatch_mode mode, allocator alloc)
 {
-    size_t list_pos = 0u;
+    event_channel current = { 0u };
 
-    if (!broker) {
+    if (!stack || !str_event_name) {
         return;
     }
 
-    if (sorted_range_find_in(RANGE_TO_ANY(broker->subs), &identifier_compare, &(ev.name), &list_pos)) {
-        event_subscription_list_publish(broker->subs->data + list_pos, ev);
+    current = event_stack_get_channel_settings(stack, str_event_name, alloc);
+    event_stack_replace_channel(stack, event_channel_create(str_event_name, mode, current.coalescing, alloc), alloc);
+}
+
+/**
+ * @brief Sets how the events of some name stacked by a same entity are merged while they wait to be sent : at most one
+ * of them is held, the first one, the last one, or one folding all of them with a reducer. Held events are sent in
+ * FIFO order once all other events were sent, whatever the dispatch mode of their name.
+ *
+ * @param[inout] stack Target stack.
+ * @param[in] str_event_name Null-terminated string (copied) of the name of the events.
+ * @param[in] coalescing How the events will be merged.
+ * @param[inout] alloc Allocator used for the copies.
+ */
+void event_stack_set_coalescing(event_stack *stack, const char *str_event_name, basilisk_specific_event_coalescing coalescing, allocator alloc)
+{
+    event_channel current = { 0u };
+
+    if (!stack || !str_event_name) {
+        return;
     }
+
+    current = event_stack_get_channel_settings(stack, str_event_name, alloc);
+    event_stack_replace_channel(stack, event_channel_create(str_event_name, current.mode, coalescing, alloc), alloc);
 }
 
-// -------------------------------------------------------------------------------------------------
+/**
+ * @brief Declares the type of the events of some name : all of them will carry data of the same size and alignment,
+ * taken from a pool of blocks of this size instead of being allocated one by one. Events whose data does not have the
+ * declared size are rejected when pushed. Declaring again the same type does nothing.
+ *
+ * @param[inout] stack Target stack.
+ * @param[in] str_event_name Null-terminated string (copied) of the name of the events.
+ * @param[in] payload_size Number of bytes of the data of each event.
+ * @param[in] payload_alignment Alignment of the data of each event, a power of two.
+ * @param[inout] alloc Allocator used for the copies and the pool.
+ * @return bool false if the name was already declared with another type, or if the type is invalid.
+ */
+bool event_stack_declare_type(event_stack *stack, const char *str_event_name, size_t payload_size, size_t payload_alignment, allocator alloc)
+{
+    event_type declared = { 0u };
+    event_type *existing = nullptr;
+
+    if (!stack || !str_event_name) {
+        return false;
+    }
+
+    declared.event_name = identifier_from_cstring(str_event_name, alloc);
+
+    existing = event_stack_find_type(stack, declared.event_name);
+    if (existing) {
+        range_destroy_dynamic(alloc, &RANGE_TO_ANY(declared.event_name));
+        return (existing->payload_size == payload_size) && (event_payload_pool_payload_alignment(existing->pool) == payload_alignment);
+    }
+
+    declared.payload_size = payload_size;
+    declared.pool = event_payload_pool_create(payload_size, payload_alignment, alloc);
+    if (!declared.pool) {
+        range_destroy_dynamic(alloc, &RANGE_TO_ANY(declared.event_name));
+        return false;
+    }
+
+    stack->types = range_ensure_capacity(alloc, RANGE_TO_ANY(stack->types), 1);
+    sorted_range_insert_in(RANGE_TO_ANY(stack->types), &identifier_compare, &declared);
+
+    return true;
+}
 
 /**
- * @brief Creates and pushes an event on top of the stack.
+ * @brief Creates and pushes an event in the stack, where it is placed according to the dispatch mode of its name.
+ * The data of events of a declared type is taken from the pool of the type.
  *
  * @param[inout] stack Target stack to populate.
  * @param[in] source Entity adding the event.
+ * @param[in] scope Root of the subtree of entities receiving the event, or nullptr to send it to all entities.
  * @param[in] str_event_name Null-terminated string (copied) of the name of the event.
- * @param[in] event_data_size Size, in bytes, of the event's data.
- * @param[in] event_data Event's data (copied) to stack.
+ * @param[in] event_data Event's data (copied, unless borrowed) and properties.
  * @param[inout] alloc Allocator used for the copies and eventual stack extension.
+ * @return bool false if the event was rejected because its data does not fit the declared type of its name.
+ */
+bool event_stack_push(event_stack *stack, basilisk_engine_entity *source, basilisk_engine_entity *scope, const char *str_event_name, basilisk_specific_event event_data, allocator alloc)
+{
+    event_stacked pushed = { 0u };
+    identifier *event_name = nullptr;
+    event_type *type = nullptr;
+
+    if (!stack || !source || !str_event_name) {
+        return true;
+    }
+
+    event_name = identifier_from_cstring(str_event_name, alloc);
+
+    type = event_stack_find_type(stack, event_name);
+    if (type && (type->payload_size != event_data.data_size)) {
+        range_destroy_dynamic(alloc, &RANGE_TO_ANY(event_name));
+        return false;
+    }
+
+    pushed = (event_stacked) {
+            .source = source,
+            .priority = (i32) event_data.priority,
+            .is_deferred = event_data.is_deferred,
+            .delay_ms = event_data.delay_ms,
+            .ev = event_create(event_name, event_data.data_size, event_data.data, event_data.is_borrowed, type ? type->pool : nullptr, alloc), };
+    pushed.ev.scope = scope;
+
+    event_stack_place(stack, pushed, alloc);
+
+    return true;
+}
+
+/**
+ * @brief Creates and pushes an event to the inbox of the stack.
+ * Unlike `event_stack_push()`, this function can be called from any thread : the event will be pushed in the stack
+ * on the next call to `event_stack_drain_inbox()`.
+ *
+ * @param[inout] stack Target stack to populate.
+ * @param[in] source Entity adding the event.
+ * @param[in] scope Root of the subtree of entities receiving the event, or nullptr to send it to all entities.
+ * @param[in] str_event_name Null-terminated string (copied) of the name of the event.
+ * @param[in] event_data Event's data (always copied, as the other thread has no frame to wait for) and properties.
+ * @param[inout] alloc Thread-safe allocator used for the copies.
  */
-void event_stack_push(event_stack *stack, basilisk_engine_entity *source, const char *str_event_name, size_t event_data_size, const void *event_data, allocator alloc)
+void event_stack_push_threadsafe(event_stack *stack, basilisk_engine_entity *source, basilisk_engine_entity *scope, const char *str_event_name, basilisk_specific_event event_data, allocator alloc)
 {
-    event new_event = { 0u };
+    event_stacked pushed = { 0u };
 
     if (!stack || !source || !str_event_name) {
         return;
     }
 
-    new_event = event_create(str_event_name, event_data_size, event_data, alloc);
+    pushed = (event_stacked) {
+            .source = source,
+            .priority = (i32) event_data.priority,
+            .is_deferred = event_data.is_deferred,
+            .delay_ms = event_data.delay_ms,
+            .is_input = event_data.is_input,
+            .ev = event_create(identifier_from_cstring(str_event_name, alloc), event_data.data_size, event_data.data, false, nullptr, alloc), };
+    pushed.ev.scope = scope;
 
-    stack->stack_impl = range_ensure_capacity(alloc, RANGE_TO_ANY(stack->stack_impl), 1);
-    range_insert_value(RANGE_TO_ANY(stack->stack_impl), stack->stack_impl->length, &(event_stacked) { .source = source, .ev = new_event });
+    mpsc_inbox_push(stack->inbox, &pushed, alloc);
 }
 
 /**
- * @brief Removes the newest event from the stack and returns it.
+ * @brief Moves the time of the stack forward by the duration of a frame, and places the events deferred since the last
+ * advance and the delayed events whose time has come. Events held back this way are placed in the order they become
+ * ready, and are sent by the event phase following the advance.
+ *
+ * @param[inout] stack Target stack.
+ * @param[in] elapsed_ms Milliseconds elapsed since the last advance.
+ * @param[inout] alloc Allocator used to extend the stack.
+ */
+void event_stack_advance(event_stack *stack, f64 elapsed_ms, allocator alloc)
+{
+    event_stacked released = { 0u };
+
+    if (!stack) {
+        return;
+    }
+
+    event_delay_queue_advance(stack->waiting, elapsed_ms, alloc);
+
+    while (event_delay_queue_pop_ready(stack->waiting, &released)) {
+        event_stack_place(stack, released, alloc);
+    }
+}
+
+/**
+ * @brief Moves all events received in the inbox of a stack to the stack, in the order they were received. Events whose
+ * data does not fit the declared type of their name are dropped. Input events are reported before being placed, so
+ * that the owner of the stack can record them in the order they reach the stack.
+ * Must be called from the thread owning the stack.
+ *
+ * @param[inout] stack Target stack.
+ * @param[in] on_input Function (can be null) called with each received input event placed in the stack.
+ * @param[inout] context Pointer passed to the input function.
+ * @param[inout] alloc Allocator used to extend the stack.
+ */
+void event_stack_drain_inbox(event_stack *stack, void (*on_input)(void *context, const event_stacked *item), void *context, allocator alloc)
+{
+    event_stacked received = { 0u };
+
+    if (!stack) {
+        return;
+    }
+
+    while (mpsc_inbox_pop(stack->inbox, &received, alloc)) {
+        if (event_stack_is_well_typed(stack, &received.ev)) {
+            if (received.is_input && on_input) {
+                on_input(context, &received);
+            }
+            event_stack_place(stack, received, alloc);
+        } else {
+            event_destroy(&received.ev, alloc);
+        }
+    }
+}
+
+/**
+ * @brief Removes the next event to send from the stack and returns it. Carried events are sent first, then the newest
+ * event of LIFO channels, then the event of highest priority of priority channels, then the oldest event of FIFO
+ * channels, and finally the events held by batched and coalescing channels.
  *
  * @param[inout] stack Stack to pop.
+ * @param[inout] alloc Allocator used to move the held events to the FIFO ring buffer.
  * @return event
  */
-event event_stack_pop(event_stack *stack)
+event event_stack_pop(event_stack *stack, allocator alloc)
 {
-    event returned_event = { 0u };
+    event_stacked returned = { 0u };
 
-    if (!stack || (stack->stack_impl->length == 0u)) {
+    if (!stack) {
         return (event) { 0u };
     }
 
-    returned_event = stack->stack_impl->data[stack->stack_impl->length - 1u].ev;
-    range_remove(RANGE_TO_ANY(stack->stack_impl), stack->stack_impl->length - 1u);
+    if (stack->carried->length > 0u) {
+        returned = stack->carried->data[stack->carried->length - 1u];
+        range_remove(RANGE_TO_ANY(stack->carried), stack->carried->length - 1u);
+    } else {
+        (void) event_stack_take(stack, &returned, alloc);
+    }
 
-    return returned_event;
+    return returned.ev;
 }
 
 /**
- * @brief Removes all avents from the stack that were sent by some entity.
+ * @brief Removes all avents from the stack that were sent by some entity, or scoped to its subtree.
  *
  * @param[inout] stack Stack to modify.
  * @param[in] source Entity that might have stacked events.
@@ -307,17 +680,75 @@ void event_stack_remove_events_of(event_stack *stack, basilisk_engine_entity *so
     }
 
     while (pos < stack->stack_impl->length) {
-        if (stack->stack_impl->data[pos].source == source) {
+        if (event_stacked_is_tied_to(stack->stack_impl->data + pos, source)) {
             event_destroy(&(stack->stack_impl->data[pos].ev), alloc);
             range_remove(RANGE_TO_ANY(stack->stack_impl), pos);
         } else {
             pos += 1u;
         }
     }
+
+    pos = 0u;
+    while (pos < stack->carried->length) {
+        if (event_stacked_is_tied_to(stack->carried->data + pos, source)) {
+            event_destroy(&(stack->carried->data[pos].ev), alloc);
+            range_remove(RANGE_TO_ANY(stack->carried), pos);
+        } else {
+            pos += 1u;
+        }
+    }
+
+    event_fifo_remove_events_of(stack->fifo, source, alloc);
+    event_heap_remove_events_of(stack->heap, source, alloc);
+    event_delay_queue_remove_events_of(stack->waiting, source, alloc);
+
+    for (size_t i = 0u ; i < stack->channels->length ; i++) {
+        stack->held_count -= event_channel_length(stack->channels->data + i);
+        event_channel_remove_events_of(stack->channels->data + i, source, alloc);
+        stack->held_count += event_channel_length(stack->channels->data + i);
+    }
 }
 
 /**
- * @brief Returns the number of stacked events.
+ * @brief Sets all events of the stack aside, in the order they would have been sent. Those events will be sent
+ * before any other, including the ones stacked afterwards. Used to postpone the end of an event phase to the next
+ * frame. Borrowed data is copied, as the entities that lent it may reuse it during their next frame.
+ *
+ * @param[inout] stack Target stack.
+ * @param[inout] alloc Allocator used to extend the set aside events.
+ */
+void event_stack_carry_over(event_stack *stack, allocator alloc)
+{
+    event_stacked taken = { 0u };
+    RANGE(event_stacked) *taken_events = nullptr;
+
+    if (!stack) {
+        return;
+    }
+
+    taken_events = range_create_dynamic(alloc, sizeof(*taken_events->data), BASILISK_COLLECTIONS_START_LENGTH);
+
+    while (event_stack_take(stack, &taken, alloc)) {
+        event_own_data(&taken.ev, alloc);
+        taken_events = range_ensure_capacity(alloc, RANGE_TO_ANY(taken_events), 1);
+        range_insert_value(RANGE_TO_ANY(taken_events), taken_events->length, &taken);
+    }
+
+    // the carried events are sent from the back : the first event taken goes last
+    for (size_t i = 0u ; i < (taken_events->length / 2u) ; i++) {
+        taken = taken_events->data[i];
+        taken_events->data[i] = taken_events->data[taken_events->length - 1u - i];
+        taken_events->data[taken_events->length - 1u - i] = taken;
+    }
+
+    stack->carried = range_ensure_capacity(alloc, RANGE_TO_ANY(stack->carried), taken_events->length);
+    range_insert_range(RANGE_TO_ANY(stack->carried), 0u, RANGE_TO_ANY(taken_events));
+
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY(taken_events));
+}
+
+/**
+ * @brief Returns the number of stacked events. Deferred and delayed events are not counted until their time has come.
  *
  * @param[in] stack Examined stack.
  * @return size_t
@@ -328,7 +759,69 @@ size_t event_stack_length(const event_stack *stack)
         return 0u;
     }
 
-    return stack->stack_impl->length;
+    return stack->stack_impl->length + stack->carried->length + event_fifo_length(stack->fifo) + event_heap_length(stack->heap) + stack->held_count;
+}
+
+/**
+ * @brief Checks if a stacked event was sent by some entity, or is scoped to the subtree of this entity. Such an event
+ * must not outlive the entity.
+ *
+ * @param[in] item Examined event.
+ * @param[in] entity Examined entity.
+ * @return bool
+ */
+bool event_stacked_is_tied_to(const event_stacked *item, const basilisk_engine_entity *entity)
+{
+    if (!item) {
+        return false;
+    }
+
+    return (item->source == entity) || (item->ev.scope == entity);
+}
+
+/**
+ * @brief Checks that the borrowed data of an event still has the bytes it had when the event was stacked. A change
+ * means that the entity that stacked the event reused or released its buffer before the event was sent. The check is
+ * only made in development mode (BASILISK_RELEASE unset), and owned data is always intact.
+ *
+ * @param[in] ev Examined event.
+ * @return bool
+ */
+bool event_is_borrow_intact(const event *ev)
+{
+#ifndef BASILISK_RELEASE
+    if (ev && ev->is_borrowed) {
+        return event_data_checksum(ev->data, ev->data_size) == ev->borrowed_checksum;
+    }
+#else
+    (void) ev;
+#endif
+
+    return true;
+}
+
+/**
+ * @brief Releases the data of an event, unless it is borrowed. Data taken from a pool is given back to it. The event is
+ * left without data, but keeps its size and count.
+ *
+ * @param[inout] ev Target event.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void event_release_data(event *ev, allocator alloc)
+{
+    if (!ev) {
+        return;
+    }
+
+    if (ev->data && !ev->is_borrowed && ev->pool) {
+        event_payload_pool_give_back(ev->pool, ev->data, alloc);
+    } else if (ev->data && !ev->is_borrowed) {
+        alloc.free(alloc, ev->data);
+    }
+
+    ev->data = nullptr;
+    ev->is_borrowed = false;
+    ev->pool = nullptr;
 }
 
 /**
@@ -344,10 +837,7 @@ void event_destroy(event *ev, allocator alloc)
     }
 
     range_destroy_dynamic(alloc, &RANGE_TO_ANY(ev->name));
-
-    if (ev->data) {
-        alloc.free(alloc, ev->data);
-    }
+    event_release_data(ev, alloc);
 
     *ev = (event) { 0u };
 }
@@ -357,22 +847,34 @@ void event_destroy(event *ev, allocator alloc)
 // -------------------------------------------------------------------------------------------------
 
 /**
- * @brief Creates an event from user data.
+ * @brief Creates an event from user data. Borrowed data is not copied : only the pointer is kept. Owned data is copied
+ * to a block of the pool of the event type if there is one, or to a new allocation otherwise.
  *
- * @param[in] str_event_name Name of the event.
+ * @param[in] event_name Name (moved) of the event.
  * @param[in] event_data_size Number of bytes taken by the event data.
  * @param[in] event_data Pointer to some foreign event data.
+ * @param[in] is_borrowed If set, the data is referenced instead of copied.
+ * @param[inout] pool Pool of the declared type of the event, or nullptr.
  * @param[inout] alloc Allocor used for the copies.
  * @return event
  */
-static event event_create(const char *str_event_name, size_t event_data_size, const void *event_data, allocator alloc)
+static event event_create(identifier *event_name, size_t event_data_size, const void *event_data, bool is_borrowed, event_payload_pool *pool, allocator alloc)
 {
     event new_event = (event) {
-            .name = identifier_from_cstring(str_event_name, alloc),
+            .name = event_name,
+            .count = 1u,
+            .pool = pool,
     };
 
-    if (event_data && (event_data_size > 0u)) {
-        new_event.data = alloc.malloc(alloc, event_data_size);
+    if (event_data && (event_data_size > 0u) && is_borrowed) {
+        new_event.data = (void *) event_data;
+        new_event.data_size = event_data_size;
+        new_event.is_borrowed = true;
+#ifndef BASILISK_RELEASE
+        new_event.borrowed_checksum = event_data_checksum(event_data, event_data_size);
+#endif
+    } else if (event_data && (event_data_size > 0u)) {
+        new_event.data = pool ? event_payload_pool_take(pool, alloc) : alloc.malloc(alloc, event_data_size);
         bytewise_copy(new_event.data, event_data, event_data_size);
         new_event.data_size = event_data_size;
     }
@@ -381,25 +883,272 @@ static event event_create(const char *str_event_name, size_t event_data_size, co
 }
 
 /**
- * @brief Removes all empty subscriptions (subscription lists with zero callbacks registered) from an event broker object.
+ * @brief Copies the borrowed data of an event so the event owns it, for events that must outlive the frame they were
+ * stacked in or whose data is modified while they wait. Does nothing to events already owning their data.
  *
- * @param[inout] broker Target broker to clean.
- * @param[inout] alloc Allocator used to destroy the empty subscription lists.
+ * @param[inout] ev Target event.
+ * @param[inout] alloc Allocator used for the copy.
  */
-static void event_broker_cleanup_empty_subscriptions(event_broker *broker, allocator alloc)
+static void event_own_data(event *ev, allocator alloc)
 {
-    size_t pos = 0u;
+    void *owned_data = nullptr;
 
-    if (!broker) {
+    if (!ev || !ev->is_borrowed) {
         return;
     }
 
-    while (pos < broker->subs->length) {
-        if (broker->subs->data[pos].subscription_list->length == 0u) {
-            event_subscription_list_destroy(broker->subs->data + pos, alloc);
-            range_remove(RANGE_TO_ANY(broker->subs), pos);
-        } else {
-            pos += 1u;
+    owned_data = ev->pool ? event_payload_pool_take(ev->pool, alloc) : alloc.malloc(alloc, ev->data_size);
+    bytewise_copy(owned_data, ev->data, ev->data_size);
+
+    ev->data = owned_data;
+    ev->is_borrowed = false;
+}
+
+/**
+ * @brief Computes a FNV-1a checksum of some bytes.
+ *
+ * @param[in] data Examined bytes.
+ * @param[in] data_size Number of bytes.
+ * @return u64
+ */
+static u64 event_data_checksum(const void *data, size_t data_size)
+{
+    u64 checksum = 0xcbf29ce484222325u;
+
+    for (size_t i = 0u ; i < data_size ; i++) {
+        checksum ^= ((const byte *) data)[i];
+        checksum *= 0x100000001b3u;
+    }
+
+    return checksum;
+}
+
+/**
+ * @brief Returns the declared type of an event name.
+ *
+ * @param[in] stack Examined stack.
+ * @param[in] event_name Name of the events.
+ * @return event_type * nullptr if the name has no declared type.
+ */
+static event_type *event_stack_find_type(const event_stack *stack, identifier *event_name)
+{
+    size_t type_pos = 0u;
+
+    if ((stack->types->length == 0u) || !sorted_range_find_in(RANGE_TO_ANY(stack->types), &identifier_compare, &event_name, &type_pos)) {
+        return nullptr;
+    }
+
+    return stack->types->data + type_pos;
+}
+
+/**
+ * @brief Checks that the data of an event has the size declared for its name. Events of names without a declared type
+ * are always well typed.
+ *
+ * @param[in] stack Examined stack.
+ * @param[in] ev Examined event.
+ * @return bool
+ */
+static bool event_stack_is_well_typed(const event_stack *stack, const event *ev)
+{
+    event_type *type = event_stack_find_type(stack, ev->name);
+
+    return !type || (type->payload_size == ev->data_size);
+}
+
+/**
+ * @brief Returns a copy of the dispatch mode and coalescing policy of an event name, which are LIFO and no coalescing if
+ * the name was never configured. The name and held events of the copy are not set.
+ *
+ * @param[in] stack Target stack.
+ * @param[in] str_event_name Null-terminated string of the name of the events.
+ * @param[inout] alloc Allocator used for a temporary copy of the name.
+ * @return event_channel
+ */
+static event_channel event_stack_get_channel_settings(const event_stack *stack, const char *str_event_name, allocator alloc)
+{
+    identifier *event_name = identifier_from_cstring(str_event_name, alloc);
+    event_channel settings = { .mode = BASILISK_EVENT_DISPATCH_LIFO, .coalescing = { .mode = BASILISK_EVENT_COALESCE_NONE }, };
+    size_t channel_pos = 0u;
+
+    if (event_name && sorted_range_find_in(RANGE_TO_ANY(stack->channels), &identifier_compare, &event_name, &channel_pos)) {
+        settings.mode = stack->channels->data[channel_pos].mode;
+        settings.coalescing = stack->channels->data[channel_pos].coalescing;
+    }
+
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY(event_name));
+
+    return settings;
+}
+
+/**
+ * @brief Replaces the settings of an event name. Events held by the former settings are moved to the FIFO ring buffer.
+ * Settings sending events in LIFO order without coalescing them are the default ones, and are not stored.
+ *
+ * @param[inout] stack Target stack.
+ * @param[in] new_channel Settings (moved) of the event name.
+ * @param[inout] alloc Allocator used to store the settings.
+ */
+static void event_stack_replace_channel(event_stack *stack, event_channel new_channel, allocator alloc)
+{
+    size_t channel_pos = 0u;
+
+    if (!new_channel.event_name) {
+        return;
+    }
+
+    if (sorted_range_find_in(RANGE_TO_ANY(stack->channels), &identifier_compare, &new_channel.event_name, &channel_pos)) {
+        stack->held_count -= event_channel_length(stack->channels->data + channel_pos);
+        (void) event_channel_flush(stack->channels->data + channel_pos, stack->fifo, alloc);
+        event_channel_destroy(stack->channels->data + channel_pos, alloc);
+        range_remove(RANGE_TO_ANY(stack->channels), channel_pos);
+    }
+
+    if ((new_channel.mode == BASILISK_EVENT_DISPATCH_LIFO) && (new_channel.coalescing.mode == BASILISK_EVENT_COALESCE_NONE)) {
+        event_channel_destroy(&new_channel, alloc);
+        return;
+    }
+
+    stack->channels = range_ensure_capacity(alloc, RANGE_TO_ANY(stack->channels), 1);
+    (void) sorted_range_insert_in(RANGE_TO_ANY(stack->channels), &identifier_compare, &new_channel);
+}
+
+/**
+ * @brief Places an event in the collection matching the dispatch mode of its name, and gives it its sequence number.
+ * Deferred and delayed events are held back instead, until the stack advances far enough.
+ *
+ * @param[inout] stack Target stack.
+ * @param[in] item Event (moved) to place.
+ * @param[inout] alloc Allocator used to extend the collections.
+ */
+static void event_stack_place(event_stack *stack, event_stacked item, allocator alloc)
+{
+    size_t channel_pos = 0u;
+    basilisk_event_dispatch_mode mode = BASILISK_EVENT_DISPATCH_LIFO;
+
+    if (item.is_deferred || (item.delay_ms > 0u)) {
+        event_own_data(&item.ev, alloc);
+        event_delay_queue_push(stack->waiting, item, alloc);
+        return;
+    }
+
+    item.sequence = stack->next_sequence;
+    stack->next_sequence += 1u;
+
+    if ((stack->channels->length > 0u) && sorted_range_find_in(RANGE_TO_ANY(stack->channels), &identifier_compare, &(item.ev.name), &channel_pos)) {
+        mode = stack->channels->data[channel_pos].mode;
+
+        if (stack->channels->data[channel_pos].held) {
+            event_own_data(&item.ev, alloc);
+            stack->held_count -= event_channel_length(stack->channels->data + channel_pos);
+            event_channel_hold(stack->channels->data + channel_pos, stack->fifo, item, alloc);
+            stack->held_count += event_channel_length(stack->channels->data + channel_pos);
+            return;
         }
     }
+
+    switch (mode) {
+        case BASILISK_EVENT_DISPATCH_FIFO:
+            event_fifo_push_back(stack->fifo, item, alloc);
+            break;
+
+        case BASILISK_EVENT_DISPATCH_PRIORITY:
+            event_heap_push(stack->heap, item, alloc);
+            break;
+
+
+        default:
+            stack->stack_impl = range_ensure_capacity(alloc, RANGE_TO_ANY(stack->stack_impl), 1);
+            range_insert_value(RANGE_TO_ANY(stack->stack_impl), stack->stack_impl->length, &item);
+            break;
+    }
+}
+
+/**
+ * @brief Removes the next event to send from the LIFO stack, the priority heap or the FIFO ring buffer, in this order,
+ * and returns true. When all three are empty, the events held by channels are moved to the ring buffer and the first one is
+ * returned. Returns false if there is nothing left to send. Carried events are ignored.
+ *
+ * @param[inout] stack Target stack.
+ * @param[out] out_item Outgoing event.
+ * @param[inout] alloc Allocator used to move the held events.
+ * @return bool
+ */
+static bool event_stack_take(event_stack *stack, event_stacked *out_item, allocator alloc)
+{
+    if (stack->stack_impl->length > 0u) {
+        *out_item = stack->stack_impl->data[stack->stack_impl->length - 1u];
+        range_remove(RANGE_TO_ANY(stack->stack_impl), stack->stack_impl->length - 1u);
+        return true;
+    }
+
+    return event_heap_pop(stack->heap, out_item)
+            || event_fifo_pop_front(stack->fifo, out_item)
+            || (event_stack_flush_held(stack, alloc) && event_fifo_pop_front(stack->fifo, out_item));
+}
+
+/**
+ * @brief Moves the events held by all batched and coalescing channels at the back of the FIFO ring buffer. Returns true
+ * if at least one event was moved.
+ *
+ * @param[inout] stack Target stack.
+ * @param[inout] alloc Allocator used to extend the ring buffer.
+ * @return bool
+ */
+static bool event_stack_flush_held(event_stack *stack, allocator alloc)
+{
+    bool has_flushed = false;
+
+    if (stack->held_count == 0u) {
+        return false;
+    }
+
+    for (size_t i = 0u ; i < stack->channels->length ; i++) {
+        has_flushed = event_channel_flush(stack->channels->data + i, stack->fifo, alloc) || has_flushed;
+    }
+    stack->held_count = 0u;
+
+    return has_flushed;
+}
+
+/**
+ * @brief Forgets all resolved prefix subscriptions of an event broker. Called each time the prefix subscriptions
+ * change, as the cached lists might not exist anymore.
+ *
+ * @param[inout] broker Target broker.
+ * @param[inout] alloc Allocator used for the free.
+ */
+static void event_broker_clear_prefix_cache(event_broker *broker, allocator alloc)
+{
+    if (!broker) {
+        return;
+    }
+
+    for (size_t i = 0u ; i < broker->prefix_cache->length ; i++) {
+        event_prefix_match_destroy(broker->prefix_cache->data + i, alloc);
+    }
+    range_clear(RANGE_TO_ANY(broker->prefix_cache));
+}
+
+/**
+ * @brief Returns the prefix subscriptions matching an event name. The first time a name is published after a change
+ * of the prefix subscriptions, the trie is walked and the result is cached.
+ *
+ * @param[inout] broker Target broker.
+ * @param[in] event_name Name of the published event.
+ * @param[inout] alloc Allocator used to cache the match.
+ * @return event_prefix_match *
+ */
+static event_prefix_match *event_broker_get_prefix_match(event_broker *broker, identifier *event_name, allocator alloc)
+{
+    size_t match_pos = 0u;
+    event_prefix_match created_match = { 0u };
+
+    if (!sorted_range_find_in(RANGE_TO_ANY(broker->prefix_cache), &identifier_compare, &event_name, &match_pos)) {
+        created_match = event_prefix_trie_match(broker->prefixes, event_name, alloc);
+        broker->prefix_cache = range_ensure_capacity(alloc, RANGE_TO_ANY(broker->prefix_cache), 1);
+        match_pos = sorted_range_insert_in(RANGE_TO_ANY(broker->prefix_cache), &identifier_compare, &created_match);
+    }
+
+    return broker->prefix_cache->data + match_pos;
 }
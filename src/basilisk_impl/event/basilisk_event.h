@@ -13,6 +13,8 @@
 
 #include "../basilisk_common.h"
 #include "../entity/basilisk_entity.h"
+#include "../worker_pool/basilisk_worker_pool.h"
+#include "event_pool/basilisk_event_pool.h"
 
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -21,7 +23,7 @@
 /* Opaque type to an object able to manage subscriptions to events. */
 typedef struct event_broker event_broker;
 
-/* OPaque type to a FILO collection of events. */
+/* OPaque type to a collection of events, sent in an order depending on their name. */
 typedef struct event_stack event_stack;
 
 // -------------------------------------------------------------------------------------------------
@@ -37,8 +39,40 @@ typedef struct event {
     size_t data_size;
     /** User-defined data the event is carrying. */
     void *data;
+    /** Number of events gathered in this one, each carrying data_size bytes of data. One if the event is not batched. */
+    size_t count;
+
+    /** Root of the subtree of entities the event is sent to. If nullptr, the event is sent to all entities. */
+    basilisk_engine_entity *scope;
+
+    /** If set, the data is owned by the entity that stacked the event and is not released with the event. */
+    bool is_borrowed;
+    /** Checksum of borrowed data when the event was stacked, to detect changes made before it is sent (development mode only). */
+    u64 borrowed_checksum;
+    /** Pool of the declared type of the event, its owned data being a block of the pool. nullptr for untyped events. */
+    event_payload_pool *pool;
 } event;
 
+/**
+ * @brief Stores an event linked to an entity that stacked it.
+ */
+typedef struct event_stacked {
+    /** Entity that stacked the event. Might be nullptr. */
+    basilisk_engine_entity *source;
+    /** Priority of the event, used by channels dispatching by priority. */
+    i32 priority;
+    /** Order in which the event was stacked, used to send events of equal priority in order. */
+    u64 sequence;
+    /** If set, the event waits for the next event phase before being placed in the stack. */
+    bool is_deferred;
+    /** Milliseconds the event waits before being placed in the stack. */
+    u64 delay_ms;
+    /** If set, the event brings data from outside of the engine and is recorded when it leaves the inbox. */
+    bool is_input;
+    /** Actual event. */
+    event ev;
+} event_stacked;
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -59,32 +93,65 @@ void event_stack_destroy(event_stack **stack, allocator alloc);
 
 // -------------------------------------------------------------------------------------------------
 
-/* Subscribes an event callback to an event name. Events sharing the name will be sent to the callback. */
-void event_broker_subscribe(event_broker *broker, basilisk_engine_entity *subscribed, identifier *target_event_name, basilisk_specific_event_subscription subscription_data, allocator alloc);
+/* Reserves the handle of a future subscription. */
+u64 event_broker_reserve_handle(event_broker *broker);
 
-/* Unsubscribes an event callback from the event broker. */
-void event_broker_unsubscribe(event_broker *broker, basilisk_engine_entity *target, identifier *target_event_name, basilisk_specific_event_subscription subscription_data, allocator alloc);
+/* Reserves the handle of a future subscription, from any thread. */
+u64 event_broker_reserve_handle_threadsafe(event_broker *broker);
 
-/* Unsubscribes all callbacks associated to an entity from all events. */
-void event_broker_unsubscribe_from_all(event_broker *broker, basilisk_engine_entity *target, allocator alloc);
+/* Subscribes an event callback to an event name. Events sharing the name will be sent to the callback. */
+void event_broker_subscribe(event_broker *broker, basilisk_engine_entity *subscribed, identifier *target_event_name, u64 handle, basilisk_specific_event_subscription subscription_data, allocator alloc);
+
+/* Unsubscribes an event callback from the event broker, by its handle. */
+void event_broker_unsubscribe(event_broker *broker, u64 handle, allocator alloc);
 
 /* Sends an event to callbacks registered to its name. */
-void event_broker_publish(event_broker *broker, event ev);
+void event_broker_publish(event_broker *broker, event ev, worker_pool *workers, allocator alloc);
 
 // -------------------------------------------------------------------------------------------------
 
-/* Builds and pushes an event on top of the stack. */
-void event_stack_push(event_stack *stack, basilisk_engine_entity *source, const char *str_event_name, size_t event_data_size, const void *event_data, allocator alloc);
+/* Sets the order in which the events of some name will be sent. */
+void event_stack_set_dispatch(event_stack *stack, const char *str_event_name, basilisk_event_dispatch_mode mode, allocator alloc);
+
+/* Sets how the events of some name sent by a same entity are merged. */
+void event_stack_set_coalescing(event_stack *stack, const char *str_event_name, basilisk_specific_event_coalescing coalescing, allocator alloc);
+
+/* Declares the type of the events of some name, fixing the size and alignment of their data. */
+bool event_stack_declare_type(event_stack *stack, const char *str_event_name, size_t payload_size, size_t payload_alignment, allocator alloc);
 
-/* Pop the most recent event from the stack and returns it. */
-event event_stack_pop(event_stack *stack);
+/* Builds and pushes an event in the stack. */
+bool event_stack_push(event_stack *stack, basilisk_engine_entity *source, basilisk_engine_entity *scope, const char *str_event_name, basilisk_specific_event event_data, allocator alloc);
+
+/* Builds and pushes an event to the inbox of the stack, from any thread. */
+void event_stack_push_threadsafe(event_stack *stack, basilisk_engine_entity *source, basilisk_engine_entity *scope, const char *str_event_name, basilisk_specific_event event_data, allocator alloc);
+
+/* Moves the stack forward in time, placing the deferred events and the delayed events whose time has come. */
+void event_stack_advance(event_stack *stack, f64 elapsed_ms, allocator alloc);
+
+/* Moves the events received in the inbox of the stack on top of the stack, reporting the input events. */
+void event_stack_drain_inbox(event_stack *stack, void (*on_input)(void *context, const event_stacked *item), void *context, allocator alloc);
+
+/* Pop the next event to send from the stack and returns it. */
+event event_stack_pop(event_stack *stack, allocator alloc);
 
 /* Remove all events tied to some entity. */
 void event_stack_remove_events_of(event_stack *stack, basilisk_engine_entity *source, allocator alloc);
 
+/* Sets all events of the stack aside, to be sent before any other event. */
+void event_stack_carry_over(event_stack *stack, allocator alloc);
+
 /* Returns the number of events in the stack. */
 size_t event_stack_length(const event_stack *stack);
 
+/* Checks if a stacked event was sent by an entity or is scoped to its subtree. */
+bool event_stacked_is_tied_to(const event_stacked *item, const basilisk_engine_entity *entity);
+
+/* Checks that the borrowed data of an event did not change since it was stacked. Always true with BASILISK_RELEASE set. */
+bool event_is_borrow_intact(const event *ev);
+
+/* Releases the data owned by an event, giving it back to its pool if it has one. */
+void event_release_data(event *ev, allocator alloc);
+
 /* Releases memory taken by an event and zeroes it out. */
 void event_destroy(event *ev, allocator alloc);
 
@@ -0,0 +1,674 @@
+/**
+ * @file basilisk_event_channel.c
+ * @author gabriel ()
+ * @brief Implementation file for the event channels settings and their collections.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "basilisk_event_channel.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Ring buffer of events. Events are stored contiguously from the head, wrapping around the end of the buffer.
+ */
+typedef struct event_fifo {
+    /** Buffer of capacity events. */
+    event_stacked *items;
+    /** Number of events the buffer can hold. */
+    size_t capacity;
+    /** Position of the oldest event in the buffer. */
+    size_t head;
+    /** Number of events in the buffer. */
+    size_t length;
+} event_fifo;
+
+/**
+ * @brief Binary heap of events. The root holds the event of highest priority, the oldest one among equals.
+ */
+typedef struct event_heap {
+    /** Events of the heap, each parent at (i - 1) / 2 of its children. */
+    RANGE(event_stacked) *items;
+} event_heap;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Merges an event into the event held for its sender, following a coalescing policy. */
+static void event_channel_coalesce(basilisk_specific_event_coalescing coalescing, event_stacked *held, event_stacked item, allocator alloc);
+
+/* Appends the data of an event to the batch held for its sender. */
+static void event_channel_append_to_batch(event_channel *channel, event_fifo *fifo, size_t batch_pos, event_stacked item, allocator alloc);
+
+/* Returns the number of events the data buffer of a batch can hold. */
+static size_t event_batch_capacity(size_t count);
+
+/* Doubles the capacity of a ring buffer, unwrapping its contents. */
+static bool event_fifo_grow(event_fifo *fifo, allocator alloc);
+
+/* Checks if an event must be sent before another in a heap. */
+static bool event_heap_is_before(const event_stacked *lhs, const event_stacked *rhs);
+
+/* Moves an event up the heap until its parent comes before it. */
+static void event_heap_sift_up(event_heap *heap, size_t pos);
+
+/* Moves an event down the heap until it comes before its children. */
+static void event_heap_sift_down(event_heap *heap, size_t pos);
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Creates the dispatch settings of an event name.
+ *
+ * @param[in] str_event_name Null-terminated string (copied) of the name of the events.
+ * @param[in] mode Order in which the events are sent.
+ * @param[in] coalescing How events of the same sender are merged while they wait to be sent.
+ * @param[inout] alloc Allocator used for the copy.
+ * @return event_channel
+ */
+event_channel event_channel_create(const char *str_event_name, basilisk_event_dispatch_mode mode, basilisk_specific_event_coalescing coalescing, allocator alloc)
+{
+    bool is_holding = (mode == BASILISK_EVENT_DISPATCH_BATCHED) || (coalescing.mode != BASILISK_EVENT_COALESCE_NONE);
+
+    if (!str_event_name) {
+        return (event_channel) { 0u };
+    }
+
+    return (event_channel) {
+            .event_name = identifier_from_cstring(str_event_name, alloc),
+            .mode = mode,
+            .coalescing = coalescing,
+            .held = (is_holding) ? range_create_dynamic(alloc, sizeof(event_stacked), BASILISK_COLLECTIONS_START_LENGTH) : nullptr,
+    };
+}
+
+/**
+ * @brief Releases the memory held by the settings of an event name and the events it still holds, zero-ing out the
+ * contents of the struct.
+ *
+ * @param[inout] channel Target settings.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void event_channel_destroy(event_channel *channel, allocator alloc)
+{
+    if (!channel) {
+        return;
+    }
+
+    if (channel->held) {
+        for (size_t i = 0u ; i < channel->held->length ; i++) {
+            event_destroy(&channel->held->data[i].ev, alloc);
+        }
+        range_destroy_dynamic(alloc, &RANGE_TO_ANY(channel->held));
+    }
+
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY(channel->event_name));
+
+    *channel = (event_channel) { 0u };
+}
+
+/**
+ * @brief Holds an event in a batched or coalescing channel, which keeps at most one event per sender and scope.
+ * The first event of a sender is held as-is. The next ones are merged into it according to the coalescing policy of
+ * the channel, or, if the channel does not coalesce events, appended to the batch of the sender. Events pushed to a
+ * channel that holds nothing go to the ring buffer.
+ *
+ * @param[inout] channel Target channel.
+ * @param[inout] fifo Ring buffer receiving the batches that cannot grow anymore.
+ * @param[in] item Event (moved) to hold.
+ * @param[inout] alloc Allocator used to extend the held events.
+ */
+void event_channel_hold(event_channel *channel, event_fifo *fifo, event_stacked item, allocator alloc)
+{
+    size_t held_pos = 0u;
+
+    if (!channel || !channel->held) {
+        event_fifo_push_back(fifo, item, alloc);
+        return;
+    }
+
+    while ((held_pos < channel->held->length) && ((channel->held->data[held_pos].source != item.source) || (channel->held->data[held_pos].ev.scope != item.ev.scope))) {
+        held_pos += 1u;
+    }
+
+    if (held_pos == channel->held->length) {
+        channel->held = range_ensure_capacity(alloc, RANGE_TO_ANY(channel->held), 1);
+        range_insert_value(RANGE_TO_ANY(channel->held), held_pos, &item);
+    } else if (channel->coalescing.mode != BASILISK_EVENT_COALESCE_NONE) {
+        event_channel_coalesce(channel->coalescing, channel->held->data + held_pos, item, alloc);
+    } else {
+        event_channel_append_to_batch(channel, fifo, held_pos, item, alloc);
+    }
+}
+
+/**
+ * @brief Moves all the events held by a channel at the back of a ring buffer, in the order they were first held.
+ * Returns true if at least one event was moved.
+ *
+ * @param[inout] channel Target channel.
+ * @param[inout] fifo Ring buffer receiving the held events.
+ * @param[inout] alloc Allocator used to extend the ring buffer.
+ * @return bool
+ */
+bool event_channel_flush(event_channel *channel, event_fifo *fifo, allocator alloc)
+{
+    bool has_flushed = false;
+
+    if (!channel || !channel->held) {
+        return false;
+    }
+
+    has_flushed = (channel->held->length > 0u);
+
+    for (size_t i = 0u ; i < channel->held->length ; i++) {
+        event_fifo_push_back(fifo, channel->held->data[i], alloc);
+    }
+    range_clear(RANGE_TO_ANY(channel->held));
+
+    return has_flushed;
+}
+
+/**
+ * @brief Removes the events a channel was holding for some entity, or for its subtree.
+ *
+ * @param[inout] channel Target channel.
+ * @param[in] source Entity that might have sent events.
+ * @param[inout] alloc Allocator used to release the memory taken by the events.
+ */
+void event_channel_remove_events_of(event_channel *channel, basilisk_engine_entity *source, allocator alloc)
+{
+    size_t pos = 0u;
+
+    if (!channel || !channel->held) {
+        return;
+    }
+
+    while (pos < channel->held->length) {
+        if (event_stacked_is_tied_to(channel->held->data + pos, source)) {
+            event_destroy(&channel->held->data[pos].ev, alloc);
+            range_remove(RANGE_TO_ANY(channel->held), pos);
+        } else {
+            pos += 1u;
+        }
+    }
+}
+
+/**
+ * @brief Returns the number of events a channel is holding.
+ *
+ * @param[in] channel Examined channel.
+ * @return size_t
+ */
+size_t event_channel_length(const event_channel *channel)
+{
+    if (!channel || !channel->held) {
+        return 0u;
+    }
+
+    return channel->held->length;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates an empty ring buffer of events.
+ *
+ * @param[inout] alloc Allocator used for the creation.
+ * @return event_fifo *
+ */
+event_fifo *event_fifo_create(allocator alloc)
+{
+    event_fifo *new_fifo = nullptr;
+
+    new_fifo = alloc.malloc(alloc, sizeof(*new_fifo));
+
+    if (!new_fifo) {
+        return nullptr;
+    }
+
+    *new_fifo = (event_fifo) { .capacity = BASILISK_COLLECTIONS_START_LENGTH, };
+    new_fifo->items = alloc.malloc(alloc, sizeof(*new_fifo->items) * new_fifo->capacity);
+
+    if (!new_fifo->items) {
+        alloc.free(alloc, new_fifo);
+        return nullptr;
+    }
+
+    return new_fifo;
+}
+
+/**
+ * @brief Releases the memory taken by a ring buffer and the events it still holds, and nullifies the pointer passed.
+ *
+ * @param[inout] fifo Object to destroy.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void event_fifo_destroy(event_fifo **fifo, allocator alloc)
+{
+    if (!fifo || !*fifo) {
+        return;
+    }
+
+    for (size_t i = 0u ; i < (*fifo)->length ; i++) {
+        event_destroy(&(*fifo)->items[((*fifo)->head + i) % (*fifo)->capacity].ev, alloc);
+    }
+
+    alloc.free(alloc, (*fifo)->items);
+    alloc.free(alloc, *fifo);
+    *fifo = nullptr;
+}
+
+/**
+ * @brief Appends an event at the back of a ring buffer, growing the buffer if it is full.
+ *
+ * @param[inout] fifo Target ring buffer.
+ * @param[in] item Event (moved) to append.
+ * @param[inout] alloc Allocator used to grow the buffer.
+ */
+void event_fifo_push_back(event_fifo *fifo, event_stacked item, allocator alloc)
+{
+    if (!fifo) {
+        return;
+    }
+
+    if ((fifo->length == fifo->capacity) && !event_fifo_grow(fifo, alloc)) {
+        event_destroy(&item.ev, alloc);
+        return;
+    }
+
+    fifo->items[(fifo->head + fifo->length) % fifo->capacity] = item;
+    fifo->length += 1u;
+}
+
+/**
+ * @brief Removes the oldest event of a ring buffer and returns true, or returns false if the buffer is empty.
+ *
+ * @param[inout] fifo Target ring buffer.
+ * @param[out] out_item Outgoing event.
+ * @return bool
+ */
+bool event_fifo_pop_front(event_fifo *fifo, event_stacked *out_item)
+{
+    if (!fifo || (fifo->length == 0u)) {
+        return false;
+    }
+
+    *out_item = fifo->items[fifo->head];
+    fifo->head = (fifo->head + 1u) % fifo->capacity;
+    fifo->length -= 1u;
+
+    return true;
+}
+
+/**
+ * @brief Removes all events of a ring buffer tied to some entity, keeping the order of the others.
+ *
+ * @param[inout] fifo Target ring buffer.
+ * @param[in] source Entity whose events are removed.
+ * @param[inout] alloc Allocator used to release the events.
+ */
+void event_fifo_remove_events_of(event_fifo *fifo, basilisk_engine_entity *source, allocator alloc)
+{
+    size_t kept = 0u;
+    event_stacked *item = nullptr;
+
+    if (!fifo) {
+        return;
+    }
+
+    for (size_t i = 0u ; i < fifo->length ; i++) {
+        item = fifo->items + ((fifo->head + i) % fifo->capacity);
+
+        if (event_stacked_is_tied_to(item, source)) {
+            event_destroy(&item->ev, alloc);
+        } else {
+            fifo->items[(fifo->head + kept) % fifo->capacity] = *item;
+            kept += 1u;
+        }
+    }
+
+    fifo->length = kept;
+}
+
+/**
+ * @brief Returns the number of events in a ring buffer.
+ *
+ * @param[in] fifo Target ring buffer.
+ * @return size_t
+ */
+size_t event_fifo_length(const event_fifo *fifo)
+{
+    if (!fifo) {
+        return 0u;
+    }
+
+    return fifo->length;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates an empty heap of events.
+ *
+ * @param[inout] alloc Allocator used for the creation.
+ * @return event_heap *
+ */
+event_heap *event_heap_create(allocator alloc)
+{
+    event_heap *new_heap = nullptr;
+
+    new_heap = alloc.malloc(alloc, sizeof(*new_heap));
+
+    if (new_heap) {
+        *new_heap = (event_heap) {
+                .items = range_create_dynamic(alloc, sizeof(*new_heap->items->data), BASILISK_COLLECTIONS_START_LENGTH),
+        };
+    }
+
+    return new_heap;
+}
+
+/**
+ * @brief Releases the memory taken by a heap and the events it still holds, and nullifies the pointer passed.
+ *
+ * @param[inout] heap Object to destroy.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void event_heap_destroy(event_heap **heap, allocator alloc)
+{
+    if (!heap || !*heap) {
+        return;
+    }
+
+    for (size_t i = 0u ; i < (*heap)->items->length ; i++) {
+        event_destroy(&(*heap)->items->data[i].ev, alloc);
+    }
+
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*heap)->items));
+    alloc.free(alloc, *heap);
+    *heap = nullptr;
+}
+
+/**
+ * @brief Inserts an event in a heap, in logarithmic time.
+ *
+ * @param[inout] heap Target heap.
+ * @param[in] item Event (moved) to insert.
+ * @param[inout] alloc Allocator used to extend the heap.
+ */
+void event_heap_push(event_heap *heap, event_stacked item, allocator alloc)
+{
+    if (!heap) {
+        return;
+    }
+
+    heap->items = range_ensure_capacity(alloc, RANGE_TO_ANY(heap->items), 1);
+    range_insert_value(RANGE_TO_ANY(heap->items), heap->items->length, &item);
+
+    event_heap_sift_up(heap, heap->items->length - 1u);
+}
+
+/**
+ * @brief Removes the event of highest priority from a heap, the oldest one among equals, and returns true. Returns
+ * false if the heap is empty.
+ *
+ * @param[inout] heap Target heap.
+ * @param[out] out_item Outgoing event.
+ * @return bool
+ */
+bool event_heap_pop(event_heap *heap, event_stacked *out_item)
+{
+    if (!heap || (heap->items->length == 0u)) {
+        return false;
+    }
+
+    *out_item = heap->items->data[0u];
+    heap->items->data[0u] = heap->items->data[heap->items->length - 1u];
+    range_remove(RANGE_TO_ANY(heap->items), heap->items->length - 1u);
+
+    event_heap_sift_down(heap, 0u);
+
+    return true;
+}
+
+/**
+ * @brief Removes all events of a heap tied to some entity, then rebuilds the heap.
+ *
+ * @param[inout] heap Target heap.
+ * @param[in] source Entity whose events are removed.
+ * @param[inout] alloc Allocator used to release the events.
+ */
+void event_heap_remove_events_of(event_heap *heap, basilisk_engine_entity *source, allocator alloc)
+{
+    size_t kept = 0u;
+
+    if (!heap) {
+        return;
+    }
+
+    for (size_t i = 0u ; i < heap->items->length ; i++) {
+        if (event_stacked_is_tied_to(heap->items->data + i, source)) {
+            event_destroy(&heap->items->data[i].ev, alloc);
+        } else {
+            heap->items->data[kept] = heap->items->data[i];
+            kept += 1u;
+        }
+    }
+
+    heap->items->length = kept;
+
+    for (size_t i = kept / 2u ; i > 0u ; i--) {
+        event_heap_sift_down(heap, i - 1u);
+    }
+}
+
+/**
+ * @brief Returns the number of events in a heap.
+ *
+ * @param[in] heap Target heap.
+ * @return size_t
+ */
+size_t event_heap_length(const event_heap *heap)
+{
+    if (!heap) {
+        return 0u;
+    }
+
+    return heap->items->length;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Merges an event into the one held for its sender. Keeping the first event drops the new one, keeping the last
+ * replaces the held event while keeping its place, and reducing calls the user reducer to fold the new data into the
+ * held data. Reducing events of different data sizes, or without a reducer, keeps the last one instead.
+ *
+ * @param[in] coalescing Coalescing policy of the channel.
+ * @param[inout] held Event held for the sender.
+ * @param[in] item Event (moved) merged into the held one.
+ * @param[inout] alloc Allocator used to release the merged event.
+ */
+static void event_channel_coalesce(basilisk_specific_event_coalescing coalescing, event_stacked *held, event_stacked item, allocator alloc)
+{
+    bool can_reduce = (coalescing.reducer != nullptr) && (held->ev.data_size == item.ev.data_size);
+
+    if ((coalescing.mode == BASILISK_EVENT_COALESCE_KEEP_FIRST) || ((coalescing.mode == BASILISK_EVENT_COALESCE_REDUCE) && can_reduce)) {
+        if (coalescing.mode == BASILISK_EVENT_COALESCE_REDUCE) {
+            coalescing.reducer(held->ev.data, item.ev.data);
+        }
+        event_destroy(&item.ev, alloc);
+        return;
+    }
+
+    item.sequence = held->sequence;
+    event_destroy(&held->ev, alloc);
+    *held = item;
+}
+
+/**
+ * @brief Appends the data of an event to the data of the batch held for its sender. If the data of the event is not of
+ * the same size as the data of the batch, the batch is moved to the ring buffer and the event starts a new one.
+ *
+ * @param[inout] channel Target channel.
+ * @param[inout] fifo Ring buffer receiving the batches that cannot grow anymore.
+ * @param[in] batch_pos Position of the batch of the sender in the held events.
+ * @param[in] item Event (moved) to append.
+ * @param[inout] alloc Allocator used to extend the batch.
+ */
+static void event_channel_append_to_batch(event_channel *channel, event_fifo *fifo, size_t batch_pos, event_stacked item, allocator alloc)
+{
+    event *batch = nullptr;
+    void *gathered_data = nullptr;
+
+    if (channel->held->data[batch_pos].ev.data_size != item.ev.data_size) {
+        event_fifo_push_back(fifo, channel->held->data[batch_pos], alloc);
+        channel->held->data[batch_pos] = item;
+        return;
+    }
+
+    batch = &channel->held->data[batch_pos].ev;
+
+    if ((batch->data_size > 0u) && ((batch->count + item.ev.count) > event_batch_capacity(batch->count))) {
+        gathered_data = alloc.malloc(alloc, batch->data_size * event_batch_capacity(batch->count + item.ev.count));
+        if (!gathered_data) {
+            event_destroy(&item.ev, alloc);
+            return;
+        }
+        bytewise_copy(gathered_data, batch->data, batch->data_size * batch->count);
+        event_release_data(batch, alloc);
+        batch->data = gathered_data;
+    }
+
+    if (batch->data_size > 0u) {
+        bytewise_copy((byte *) batch->data + (batch->data_size * batch->count), item.ev.data, item.ev.data_size * item.ev.count);
+    }
+    batch->count += item.ev.count;
+
+    event_destroy(&item.ev, alloc);
+}
+
+/**
+ * @brief Returns the number of events the data buffer of a batch can hold, the buffer growing by powers of two.
+ *
+ * @param[in] count Number of events in the batch.
+ * @return size_t
+ */
+static size_t event_batch_capacity(size_t count)
+{
+    size_t capacity = 1u;
+
+    while (capacity < count) {
+        capacity *= 2u;
+    }
+
+    return capacity;
+}
+
+/**
+ * @brief Doubles the capacity of a ring buffer. The events are moved to the start of the new buffer.
+ *
+ * @param[inout] fifo Target ring buffer.
+ * @param[inout] alloc Allocator used to reallocate the buffer.
+ * @return bool
+ */
+static bool event_fifo_grow(event_fifo *fifo, allocator alloc)
+{
+    event_stacked *new_items = nullptr;
+
+    new_items = alloc.malloc(alloc, sizeof(*new_items) * fifo->capacity * 2u);
+
+    if (!new_items) {
+        return false;
+    }
+
+    for (size_t i = 0u ; i < fifo->length ; i++) {
+        new_items[i] = fifo->items[(fifo->head + i) % fifo->capacity];
+    }
+
+    alloc.free(alloc, fifo->items);
+
+    fifo->items = new_items;
+    fifo->capacity *= 2u;
+    fifo->head = 0u;
+
+    return true;
+}
+
+/**
+ * @brief Checks if an event must be sent before another : the higher priority comes first, then the older event.
+ *
+ * @param[in] lhs Some event.
+ * @param[in] rhs Some other event.
+ * @return bool
+ */
+static bool event_heap_is_before(const event_stacked *lhs, const event_stacked *rhs)
+{
+    return (lhs->priority > rhs->priority) || ((lhs->priority == rhs->priority) && (lhs->sequence < rhs->sequence));
+}
+
+/**
+ * @brief Moves an event up the heap, swapping it with its parent, until its parent comes before it.
+ *
+ * @param[inout] heap Target heap.
+ * @param[in] pos Position of the moved event.
+ */
+static void event_heap_sift_up(event_heap *heap, size_t pos)
+{
+    event_stacked tmp = { 0u };
+    size_t parent = 0u;
+
+    while (pos > 0u) {
+        parent = (pos - 1u) / 2u;
+
+        if (!event_heap_is_before(heap->items->data + pos, heap->items->data + parent)) {
+            return;
+        }
+
+        tmp = heap->items->data[parent];
+        heap->items->data[parent] = heap->items->data[pos];
+        heap->items->data[pos] = tmp;
+        pos = parent;
+    }
+}
+
+/**
+ * @brief Moves an event down the heap, swapping it with its first child, until it comes before its children.
+ *
+ * @param[inout] heap Target heap.
+ * @param[in] pos Position of the moved event.
+ */
+static void event_heap_sift_down(event_heap *heap, size_t pos)
+{
+    event_stacked tmp = { 0u };
+    size_t first = pos;
+    size_t child = 0u;
+
+    do {
+        pos = first;
+
+        for (size_t i = 1u ; i <= 2u ; i++) {
+            child = (2u * pos) + i;
+            if ((child < heap->items->length) && event_heap_is_before(heap->items->data + child, heap->items->data + first)) {
+                first = child;
+            }
+        }
+
+        if (first != pos) {
+            tmp = heap->items->data[first];
+            heap->items->data[first] = heap->items->data[pos];
+            heap->items->data[pos] = tmp;
+        }
+    } while (first != pos);
+}
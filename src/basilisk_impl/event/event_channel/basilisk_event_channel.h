@@ -0,0 +1,105 @@
+/**
+ * @file basilisk_event_channel.h
+ * @author gabriel ()
+ * @brief Dispatch settings of event names, and the collections holding events dispatched in FIFO, priority or batched order.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef __EVENT_CHANNEL_H__
+#define __EVENT_CHANNEL_H__
+
+#include "../../basilisk_common.h"
+#include "../../event/basilisk_event.h"
+#include "../../entity/basilisk_entity.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Dispatch settings shared by all events of a name.
+ */
+typedef struct event_channel {
+    /** Name of the events of the channel. */
+    identifier *event_name;
+    /** Order in which the events of the channel are sent. */
+    basilisk_event_dispatch_mode mode;
+    /** How the events of a same sender are merged while they wait to be sent. */
+    basilisk_specific_event_coalescing coalescing;
+
+    /** Events of a batched or coalescing channel held so far, one per sending entity and scope. Null for other channels. */
+    RANGE(event_stacked) *held;
+} event_channel;
+
+/* Opaque type to a ring buffer of events, sent in the order they were pushed. */
+typedef struct event_fifo event_fifo;
+
+/* Opaque type to a binary heap of events, sent by decreasing priority. */
+typedef struct event_heap event_heap;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Creates the dispatch settings of an event name. */
+event_channel event_channel_create(const char *str_event_name, basilisk_event_dispatch_mode mode, basilisk_specific_event_coalescing coalescing, allocator alloc);
+
+/* Releases memory held by the settings of an event name and the events it gathered. */
+void event_channel_destroy(event_channel *channel, allocator alloc);
+
+/* Holds an event in a batched or coalescing channel, merging it with the event held for its sender. */
+void event_channel_hold(event_channel *channel, event_fifo *fifo, event_stacked item, allocator alloc);
+
+/* Moves the events held by a channel at the back of a ring buffer. */
+bool event_channel_flush(event_channel *channel, event_fifo *fifo, allocator alloc);
+
+/* Removes the events held by a channel for some entity. */
+void event_channel_remove_events_of(event_channel *channel, basilisk_engine_entity *source, allocator alloc);
+
+/* Returns the number of events held by a channel. */
+size_t event_channel_length(const event_channel *channel);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Allocates an empty ring buffer of events. */
+event_fifo *event_fifo_create(allocator alloc);
+
+/* Releases memory taken by a ring buffer and its events, and nullifies the pointer passed. */
+void event_fifo_destroy(event_fifo **fifo, allocator alloc);
+
+/* Appends an event at the back of a ring buffer. */
+void event_fifo_push_back(event_fifo *fifo, event_stacked item, allocator alloc);
+
+/* Removes the oldest event of a ring buffer. */
+bool event_fifo_pop_front(event_fifo *fifo, event_stacked *out_item);
+
+/* Removes all events of a ring buffer tied to some entity. */
+void event_fifo_remove_events_of(event_fifo *fifo, basilisk_engine_entity *source, allocator alloc);
+
+/* Returns the number of events in a ring buffer. */
+size_t event_fifo_length(const event_fifo *fifo);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Allocates an empty heap of events. */
+event_heap *event_heap_create(allocator alloc);
+
+/* Releases memory taken by a heap and its events, and nullifies the pointer passed. */
+void event_heap_destroy(event_heap **heap, allocator alloc);
+
+/* Inserts an event in a heap. */
+void event_heap_push(event_heap *heap, event_stacked item, allocator alloc);
+
+/* Removes the event of highest priority from a heap. */
+bool event_heap_pop(event_heap *heap, event_stacked *out_item);
+
+/* Removes all events of a heap tied to some entity. */
+void event_heap_remove_events_of(event_heap *heap, basilisk_engine_entity *source, allocator alloc);
+
+/* Returns the number of events in a heap. */
+size_t event_heap_length(const event_heap *heap);
+
+#endif
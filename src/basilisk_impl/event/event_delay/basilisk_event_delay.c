@@ -0,0 +1,381 @@
+/**
+ * @file basilisk_event_delay.c
+ * @author gabriel ()
+ * @brief Implementation file for the events waiting for a later event phase.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "basilisk_event_delay.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Event waiting for its delay to be over.
+ */
+typedef struct event_delayed {
+    /** Time of the queue at which the event is due. */
+    f64 due_ms;
+    /** Order in which the event was delayed, used to release events due at the same time in order. */
+    u64 order;
+    /** Actual event. */
+    event_stacked item;
+} event_delayed;
+
+/**
+ * @brief Collection of deferred events, in the order they were deferred.
+ */
+typedef RANGE(event_stacked) event_delay_bucket;
+
+/**
+ * @brief Events held back until a later event phase.
+ */
+typedef struct event_delay_queue {
+    /** Time elapsed since the creation of the queue, moved forward once per frame. */
+    f64 now_ms;
+    /** Order of the next delayed event. */
+    u64 next_order;
+
+    /** Events deferred since the last advance of the queue. */
+    event_delay_bucket *deferred;
+    /** Deferred events released by the last advance, not popped yet. */
+    event_delay_bucket *ready;
+    /** Position of the next event to pop in the released deferred events. */
+    size_t ready_pos;
+
+    /** Delayed events, each parent at (i - 1) / 2 of its children, the soonest due at the top. */
+    RANGE(event_delayed) *delayed;
+} event_delay_queue;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Checks if a delayed event must be released before another. */
+static bool event_delayed_is_before(const event_delayed *lhs, const event_delayed *rhs);
+
+/* Moves a delayed event up the heap until its parent is due before it. */
+static void event_delay_queue_sift_up(event_delay_queue *queue, size_t pos);
+
+/* Moves a delayed event down the heap until it is due before its children. */
+static void event_delay_queue_sift_down(event_delay_queue *queue, size_t pos);
+
+/* Removes the events tied to some entity from a bucket of deferred events. */
+static void event_delay_bucket_remove_events_of(event_delay_bucket *bucket, size_t from, basilisk_engine_entity *source, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates a queue without any waiting event.
+ *
+ * @param[inout] alloc Allocator used for the creation.
+ * @return event_delay_queue *
+ */
+event_delay_queue *event_delay_queue_create(allocator alloc)
+{
+    event_delay_queue *new_queue = nullptr;
+
+    new_queue = alloc.malloc(alloc, sizeof(*new_queue));
+
+    if (new_queue) {
+        *new_queue = (event_delay_queue) {
+                .now_ms = 0.,
+                .next_order = 0u,
+                .deferred = range_create_dynamic(alloc, sizeof(*new_queue->deferred->data), BASILISK_COLLECTIONS_START_LENGTH),
+                .ready = range_create_dynamic(alloc, sizeof(*new_queue->ready->data), BASILISK_COLLECTIONS_START_LENGTH),
+                .ready_pos = 0u,
+                .delayed = range_create_dynamic(alloc, sizeof(*new_queue->delayed->data), BASILISK_COLLECTIONS_START_LENGTH),
+        };
+    }
+
+    return new_queue;
+}
+
+/**
+ * @brief Releases the memory taken by a queue and all of its waiting events, and nullifies the pointer passed.
+ *
+ * @param[inout] queue Object to destroy.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void event_delay_queue_destroy(event_delay_queue **queue, allocator alloc)
+{
+    if (!queue || !*queue) {
+        return;
+    }
+
+    for (size_t i = 0u ; i < (*queue)->deferred->length ; i++) {
+        event_destroy(&(*queue)->deferred->data[i].ev, alloc);
+    }
+    for (size_t i = (*queue)->ready_pos ; i < (*queue)->ready->length ; i++) {
+        event_destroy(&(*queue)->ready->data[i].ev, alloc);
+    }
+    for (size_t i = 0u ; i < (*queue)->delayed->length ; i++) {
+        event_destroy(&(*queue)->delayed->data[i].item.ev, alloc);
+    }
+
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*queue)->deferred));
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*queue)->ready));
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*queue)->delayed));
+
+    alloc.free(alloc, *queue);
+    *queue = nullptr;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Holds an event back. An event with a delay is due once the queue moved forward by this delay from now, and
+ * any other event is released by the next advance of the queue. The event must own its data.
+ *
+ * @param[inout] queue Target queue.
+ * @param[in] item Event (moved) to hold back.
+ * @param[inout] alloc Allocator used to extend the queue.
+ */
+void event_delay_queue_push(event_delay_queue *queue, event_stacked item, allocator alloc)
+{
+    event_delayed delayed = { 0u };
+
+    if (!queue) {
+        return;
+    }
+
+    if (item.delay_ms == 0u) {
+        item.is_deferred = false;
+        queue->deferred = range_ensure_capacity(alloc, RANGE_TO_ANY(queue->deferred), 1);
+        range_insert_value(RANGE_TO_ANY(queue->deferred), queue->deferred->length, &item);
+        return;
+    }
+
+    delayed = (event_delayed) {
+            .due_ms = queue->now_ms + (f64) item.delay_ms,
+            .order = queue->next_order,
+            .item = item,
+    };
+    delayed.item.delay_ms = 0u;
+    delayed.item.is_deferred = false;
+    queue->next_order += 1u;
+
+    queue->delayed = range_ensure_capacity(alloc, RANGE_TO_ANY(queue->delayed), 1);
+    range_insert_value(RANGE_TO_ANY(queue->delayed), queue->delayed->length, &delayed);
+    event_delay_queue_sift_up(queue, queue->delayed->length - 1u);
+}
+
+/**
+ * @brief Moves the time of the queue forward. All events deferred until now become ready, as well as the delayed events
+ * whose time has come.
+ *
+ * @param[inout] queue Target queue.
+ * @param[in] elapsed_ms Milliseconds elapsed since the last advance.
+ * @param[inout] alloc Allocator used to gather the deferred events left ready by the last advance.
+ */
+void event_delay_queue_advance(event_delay_queue *queue, f64 elapsed_ms, allocator alloc)
+{
+    event_delay_bucket *swapped = nullptr;
+
+    if (!queue) {
+        return;
+    }
+
+    queue->now_ms += elapsed_ms;
+
+    if (queue->ready_pos < queue->ready->length) {
+        queue->ready = range_ensure_capacity(alloc, RANGE_TO_ANY(queue->ready), queue->deferred->length);
+        for (size_t i = 0u ; i < queue->deferred->length ; i++) {
+            range_insert_value(RANGE_TO_ANY(queue->ready), queue->ready->length, queue->deferred->data + i);
+        }
+        range_clear(RANGE_TO_ANY(queue->deferred));
+        return;
+    }
+
+    range_clear(RANGE_TO_ANY(queue->ready));
+    queue->ready_pos = 0u;
+
+    swapped = queue->ready;
+    queue->ready = queue->deferred;
+    queue->deferred = swapped;
+}
+
+/**
+ * @brief Removes the next ready event : the deferred events first, in the order they were deferred, then the delayed
+ * events whose time has come, the soonest due first.
+ *
+ * @param[inout] queue Target queue.
+ * @param[out] out_item Removed event.
+ * @return bool false if no event is ready.
+ */
+bool event_delay_queue_pop_ready(event_delay_queue *queue, event_stacked *out_item)
+{
+    if (!queue || !out_item) {
+        return false;
+    }
+
+    if (queue->ready_pos < queue->ready->length) {
+        *out_item = queue->ready->data[queue->ready_pos];
+        queue->ready_pos += 1u;
+        return true;
+    }
+
+    if ((queue->delayed->length == 0u) || (queue->delayed->data[0u].due_ms > queue->now_ms)) {
+        return false;
+    }
+
+    *out_item = queue->delayed->data[0u].item;
+    queue->delayed->data[0u] = queue->delayed->data[queue->delayed->length - 1u];
+    range_remove(RANGE_TO_ANY(queue->delayed), queue->delayed->length - 1u);
+    event_delay_queue_sift_down(queue, 0u);
+
+    return true;
+}
+
+/**
+ * @brief Removes and destroys all waiting events sent by an entity or scoped to its subtree.
+ *
+ * @param[inout] queue Target queue.
+ * @param[in] source Entity whose events are removed.
+ * @param[inout] alloc Allocator used to release the events.
+ */
+void event_delay_queue_remove_events_of(event_delay_queue *queue, basilisk_engine_entity *source, allocator alloc)
+{
+    size_t kept = 0u;
+
+    if (!queue || !source) {
+        return;
+    }
+
+    event_delay_bucket_remove_events_of(queue->deferred, 0u, source, alloc);
+    event_delay_bucket_remove_events_of(queue->ready, queue->ready_pos, source, alloc);
+
+    for (size_t i = 0u ; i < queue->delayed->length ; i++) {
+        if (event_stacked_is_tied_to(&queue->delayed->data[i].item, source)) {
+            event_destroy(&queue->delayed->data[i].item.ev, alloc);
+        } else {
+            queue->delayed->data[kept] = queue->delayed->data[i];
+            kept += 1u;
+        }
+    }
+
+    queue->delayed->length = kept;
+
+    for (size_t i = kept / 2u ; i > 0u ; i--) {
+        event_delay_queue_sift_down(queue, i - 1u);
+    }
+}
+
+/**
+ * @brief Returns the number of events waiting in a queue, ready or not.
+ *
+ * @param[in] queue Examined queue.
+ * @return size_t
+ */
+size_t event_delay_queue_length(const event_delay_queue *queue)
+{
+    if (!queue) {
+        return 0u;
+    }
+
+    return queue->deferred->length + (queue->ready->length - queue->ready_pos) + queue->delayed->length;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Checks if a delayed event must be released before another : the one due the soonest, or the one delayed
+ * first if they are due at the same time.
+ *
+ * @param[in] lhs Some delayed event.
+ * @param[in] rhs Some other delayed event.
+ * @return bool
+ */
+static bool event_delayed_is_before(const event_delayed *lhs, const event_delayed *rhs)
+{
+    return (lhs->due_ms < rhs->due_ms) || ((lhs->due_ms == rhs->due_ms) && (lhs->order < rhs->order));
+}
+
+/**
+ * @brief Moves a delayed event up the heap, swapping it with its parent, until its parent is due before it.
+ *
+ * @param[inout] queue Target queue.
+ * @param[in] pos Position of the moved event.
+ */
+static void event_delay_queue_sift_up(event_delay_queue *queue, size_t pos)
+{
+    event_delayed tmp = { 0u };
+    size_t parent = 0u;
+
+    while (pos > 0u) {
+        parent = (pos - 1u) / 2u;
+
+        if (!event_delayed_is_before(queue->delayed->data + pos, queue->delayed->data + parent)) {
+            return;
+        }
+
+        tmp = queue->delayed->data[parent];
+        queue->delayed->data[parent] = queue->delayed->data[pos];
+        queue->delayed->data[pos] = tmp;
+        pos = parent;
+    }
+}
+
+/**
+ * @brief Moves a delayed event down the heap, swapping it with its soonest child, until it is due before its children.
+ *
+ * @param[inout] queue Target queue.
+ * @param[in] pos Position of the moved event.
+ */
+static void event_delay_queue_sift_down(event_delay_queue *queue, size_t pos)
+{
+    event_delayed tmp = { 0u };
+    size_t first = pos;
+    size_t child = 0u;
+
+    do {
+        pos = first;
+
+        for (size_t i = 1u ; i <= 2u ; i++) {
+            child = (2u * pos) + i;
+            if ((child < queue->delayed->length) && event_delayed_is_before(queue->delayed->data + child, queue->delayed->data + first)) {
+                first = child;
+            }
+        }
+
+        if (first != pos) {
+            tmp = queue->delayed->data[first];
+            queue->delayed->data[first] = queue->delayed->data[pos];
+            queue->delayed->data[pos] = tmp;
+        }
+    } while (first != pos);
+}
+
+/**
+ * @brief Removes and destroys the events of a bucket sent by an entity or scoped to its subtree, keeping the order of
+ * the others.
+ *
+ * @param[inout] bucket Target bucket.
+ * @param[in] from Position of the first event examined. The events before it are left as is.
+ * @param[in] source Entity whose events are removed.
+ * @param[inout] alloc Allocator used to release the events.
+ */
+static void event_delay_bucket_remove_events_of(event_delay_bucket *bucket, size_t from, basilisk_engine_entity *source, allocator alloc)
+{
+    size_t kept = from;
+
+    for (size_t i = from ; i < bucket->length ; i++) {
+        if (event_stacked_is_tied_to(bucket->data + i, source)) {
+            event_destroy(&bucket->data[i].ev, alloc);
+        } else {
+            bucket->data[kept] = bucket->data[i];
+            kept += 1u;
+        }
+    }
+
+    bucket->length = kept;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file basilisk_event_delay.h
+ * @author gabriel ()
+ * @brief Hold events back until a later event phase : the next one, or the first one after some delay.
+ *
+ * Deferred events wait in a bucket emptied at the start of the next event phase. Delayed events wait in a heap ordered
+ * by the time they are due, so that each event phase only looks at the events whose time has come.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef __EVENT_DELAY_H__
+#define __EVENT_DELAY_H__
+
+#include "../../basilisk_common.h"
+#include "../../event/basilisk_event.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Opaque type to a collection of events waiting for a later event phase. */
+typedef struct event_delay_queue event_delay_queue;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Allocates an empty queue of waiting events. */
+event_delay_queue *event_delay_queue_create(allocator alloc);
+
+/* Releases memory taken by a queue and the events it holds, and nullifies the pointer passed. */
+void event_delay_queue_destroy(event_delay_queue **queue, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Holds an event back until the next event phase, or until its delay is over. */
+void event_delay_queue_push(event_delay_queue *queue, event_stacked item, allocator alloc);
+
+/* Moves the queue forward in time, making the deferred and due events ready. */
+void event_delay_queue_advance(event_delay_queue *queue, f64 elapsed_ms, allocator alloc);
+
+/* Removes the next ready event from the queue. */
+bool event_delay_queue_pop_ready(event_delay_queue *queue, event_stacked *out_item);
+
+/* Removes all events tied to some entity. */
+void event_delay_queue_remove_events_of(event_delay_queue *queue, basilisk_engine_entity *source, allocator alloc);
+
+/* Returns the number of events waiting in the queue. */
+size_t event_delay_queue_length(const event_delay_queue *queue);
+
+#endif
@@ -0,0 +1,220 @@
+/**
+ * @file basilisk_event_pool.c
+ * @author gabriel ()
+ * @brief Implementation file for the pools of event payloads.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdint.h>
+
+#include "basilisk_event_pool.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Blocks of a same size, carved from chunks allocated as the pool grows. Chunks are only released with the pool.
+ */
+typedef struct event_payload_pool {
+    /** Number of bytes asked for each block. */
+    size_t payload_size;
+    /** Alignment of each block, a power of two. */
+    size_t payload_alignment;
+    /** Number of bytes between two consecutive blocks of a chunk. */
+    size_t stride;
+    /** Number of blocks carved from all chunks. */
+    size_t blocks_count;
+
+    /** Memory allocated for the blocks, as returned by the allocator. */
+    RANGE(void *) *chunks;
+    /** Blocks not taken by an event. */
+    RANGE(void *) *free_blocks;
+} event_payload_pool;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Allocates a new chunk as large as all the previous ones, and carves it into free blocks. */
+static bool event_payload_pool_grow(event_payload_pool *pool, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates a pool of blocks of some size and alignment, without any block yet.
+ *
+ * @param[in] payload_size Number of bytes of each block.
+ * @param[in] payload_alignment Alignment of each block, a power of two. Zero stands for no alignment.
+ * @param[inout] alloc Allocator used for the creation.
+ * @return event_payload_pool *
+ */
+event_payload_pool *event_payload_pool_create(size_t payload_size, size_t payload_alignment, allocator alloc)
+{
+    event_payload_pool *new_pool = nullptr;
+
+    if ((payload_size == 0u) || ((payload_alignment & (payload_alignment - 1u)) != 0u)) {
+        return nullptr;
+    }
+
+    if (payload_alignment == 0u) {
+        payload_alignment = 1u;
+    }
+
+    new_pool = alloc.malloc(alloc, sizeof(*new_pool));
+
+    if (new_pool) {
+        *new_pool = (event_payload_pool) {
+                .payload_size = payload_size,
+                .payload_alignment = payload_alignment,
+                .stride = ((payload_size + payload_alignment - 1u) / payload_alignment) * payload_alignment,
+                .blocks_count = 0u,
+                .chunks = range_create_dynamic(alloc, sizeof(*new_pool->chunks->data), BASILISK_COLLECTIONS_START_LENGTH),
+                .free_blocks = range_create_dynamic(alloc, sizeof(*new_pool->free_blocks->data), BASILISK_COLLECTIONS_START_LENGTH),
+        };
+    }
+
+    return new_pool;
+}
+
+/**
+ * @brief Releases the memory taken by a pool and nullifies the pointer passed. Blocks still taken by events are
+ * released as well, and must not be used anymore.
+ *
+ * @param[inout] pool Object to destroy.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void event_payload_pool_destroy(event_payload_pool **pool, allocator alloc)
+{
+    if (!pool || !*pool) {
+        return;
+    }
+
+    for (size_t i = 0u ; i < (*pool)->chunks->length ; i++) {
+        alloc.free(alloc, (*pool)->chunks->data[i]);
+    }
+
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*pool)->chunks));
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*pool)->free_blocks));
+
+    alloc.free(alloc, *pool);
+    *pool = nullptr;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Takes a block from the free blocks of a pool. If none is left, the pool grows by as many blocks as it already
+ * holds.
+ *
+ * @param[inout] pool Target pool.
+ * @param[inout] alloc Allocator used to extend the pool.
+ * @return void *
+ */
+void *event_payload_pool_take(event_payload_pool *pool, allocator alloc)
+{
+    void *block = nullptr;
+
+    if (!pool) {
+        return nullptr;
+    }
+
+    if ((pool->free_blocks->length == 0u) && !event_payload_pool_grow(pool, alloc)) {
+        return nullptr;
+    }
+
+    block = pool->free_blocks->data[pool->free_blocks->length - 1u];
+    range_remove(RANGE_TO_ANY(pool->free_blocks), pool->free_blocks->length - 1u);
+
+    return block;
+}
+
+/**
+ * @brief Gives a block taken from a pool back to it, to be taken again by a later event.
+ *
+ * @param[inout] pool Pool the block was taken from.
+ * @param[in] block Given back block.
+ * @param[inout] alloc Allocator used to keep track of the block.
+ */
+void event_payload_pool_give_back(event_payload_pool *pool, void *block, allocator alloc)
+{
+    if (!pool || !block) {
+        return;
+    }
+
+    pool->free_blocks = range_ensure_capacity(alloc, RANGE_TO_ANY(pool->free_blocks), 1);
+    range_insert_value(RANGE_TO_ANY(pool->free_blocks), pool->free_blocks->length, &block);
+}
+
+/**
+ * @brief Returns the number of bytes of each block of a pool.
+ *
+ * @param[in] pool Examined pool.
+ * @return size_t
+ */
+size_t event_payload_pool_payload_size(const event_payload_pool *pool)
+{
+    if (!pool) {
+        return 0u;
+    }
+
+    return pool->payload_size;
+}
+
+/**
+ * @brief Returns the alignment of each block of a pool.
+ *
+ * @param[in] pool Examined pool.
+ * @return size_t
+ */
+size_t event_payload_pool_payload_alignment(const event_payload_pool *pool)
+{
+    if (!pool) {
+        return 0u;
+    }
+
+    return pool->payload_alignment;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates a new chunk holding as many blocks as the pool already has (or the default collection length for
+ * the first chunk), and adds its blocks to the free blocks. The chunk is over-allocated to align its first block.
+ *
+ * @param[inout] pool Target pool.
+ * @param[inout] alloc Allocator used for the chunk.
+ * @return bool
+ */
+static bool event_payload_pool_grow(event_payload_pool *pool, allocator alloc)
+{
+    size_t new_blocks_count = (pool->blocks_count > 0u) ? pool->blocks_count : BASILISK_COLLECTIONS_START_LENGTH;
+    void *chunk = nullptr;
+    uintptr_t first_block = 0u;
+
+    chunk = alloc.malloc(alloc, (pool->stride * new_blocks_count) + pool->payload_alignment - 1u);
+    if (!chunk) {
+        return false;
+    }
+
+    pool->chunks = range_ensure_capacity(alloc, RANGE_TO_ANY(pool->chunks), 1);
+    range_insert_value(RANGE_TO_ANY(pool->chunks), pool->chunks->length, &chunk);
+
+    first_block = ((uintptr_t) chunk + pool->payload_alignment - 1u) & ~((uintptr_t) pool->payload_alignment - 1u);
+
+    pool->free_blocks = range_ensure_capacity(alloc, RANGE_TO_ANY(pool->free_blocks), new_blocks_count);
+    for (size_t i = new_blocks_count ; i > 0u ; i--) {
+        range_insert_value(RANGE_TO_ANY(pool->free_blocks), pool->free_blocks->length, &(void *) { (void *) (first_block + ((i - 1u) * pool->stride)) });
+    }
+    pool->blocks_count += new_blocks_count;
+
+    return true;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file basilisk_event_pool.h
+ * @author gabriel ()
+ * @brief Pools of fixed-size blocks holding the payloads of typed events.
+ *
+ * Events of a declared type all carry a payload of the same size and alignment : their data is taken from a pool of
+ * blocks of this size, and given back to the pool when the event is released, instead of going through the allocator
+ * on each event.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef __EVENT_POOL_H__
+#define __EVENT_POOL_H__
+
+#include "../../basilisk_common.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Opaque type to a pool of blocks of a same size and alignment. */
+typedef struct event_payload_pool event_payload_pool;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Allocates an empty pool of blocks of some size and alignment. */
+event_payload_pool *event_payload_pool_create(size_t payload_size, size_t payload_alignment, allocator alloc);
+
+/* Releases memory taken by a pool and all of its blocks, and nullifies the pointer passed. */
+void event_payload_pool_destroy(event_payload_pool **pool, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Takes a free block from a pool, extending the pool if needed. */
+void *event_payload_pool_take(event_payload_pool *pool, allocator alloc);
+
+/* Gives a block back to the pool it was taken from. */
+void event_payload_pool_give_back(event_payload_pool *pool, void *block, allocator alloc);
+
+/* Returns the size of the blocks of a pool. */
+size_t event_payload_pool_payload_size(const event_payload_pool *pool);
+
+/* Returns the alignment of the blocks of a pool. */
+size_t event_payload_pool_payload_alignment(const event_payload_pool *pool);
+
+#endif
@@ -0,0 +1,334 @@
+/**
+ * @file basilisk_event_prefix.c
+ * @author gabriel ()
+ * @brief Implementation file for the trie of prefix subscriptions.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "basilisk_event_prefix.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Node of a trie of prefixes. The path of characters from the root to a node spells the prefix of the node.
+ */
+typedef struct event_prefix_node {
+    /** Last character of the prefix of the node. */
+    char key;
+    /** Callbacks subscribed to the prefix of the node. Its range is null until a callback subscribes. */
+    event_subscription_list subscriptions;
+    /** Nodes of the prefixes one character longer. */
+    RANGE(struct event_prefix_node *) *children;
+} event_prefix_node;
+
+/**
+ * @brief Trie of prefix subscriptions, whose root is the empty prefix.
+ */
+typedef struct event_prefix_trie {
+    /** Node of the empty prefix, matching all event names. */
+    event_prefix_node *root;
+    /** Number of subscriptions added to the trie. */
+    size_t length;
+} event_prefix_trie;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Allocates a node without subscriptions nor children. */
+static event_prefix_node *event_prefix_node_create(char key, allocator alloc);
+
+/* Releases memory taken by a node and all of its children. */
+static void event_prefix_node_destroy(event_prefix_node **node, allocator alloc);
+
+/* Returns the child of a node for some character, creating it if asked. */
+static event_prefix_node *event_prefix_node_get_child(event_prefix_node *node, char key, bool should_create, allocator alloc);
+
+/* Returns the node of the prefix of a wildcard name. */
+static event_prefix_node *event_prefix_trie_find(event_prefix_trie *trie, const identifier *wildcard_name, bool should_create, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Checks if an event name ends with a '*' : such a name stands for all the names starting with the characters
+ * before the '*'.
+ *
+ * @param[in] event_name Examined name.
+ * @return bool
+ */
+bool event_prefix_is_wildcard(const identifier *event_name)
+{
+    if (!event_name || (event_name->length < 2u)) {
+        return false;
+    }
+
+    return event_name->data[event_name->length - 2u] == '*';
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates a trie holding no prefix subscription.
+ *
+ * @param[inout] alloc Allocator used for the creation.
+ * @return event_prefix_trie *
+ */
+event_prefix_trie *event_prefix_trie_create(allocator alloc)
+{
+    event_prefix_trie *new_trie = nullptr;
+
+    new_trie = alloc.malloc(alloc, sizeof(*new_trie));
+
+    if (new_trie) {
+        *new_trie = (event_prefix_trie) {
+                .root = event_prefix_node_create('\0', alloc),
+                .length = 0u,
+        };
+    }
+
+    return new_trie;
+}
+
+/**
+ * @brief Releases the memory taken by a trie, its nodes and their subscriptions, and nullifies the pointer passed.
+ *
+ * @param[inout] trie Object to destroy.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void event_prefix_trie_destroy(event_prefix_trie **trie, allocator alloc)
+{
+    if (!trie || !*trie) {
+        return;
+    }
+
+    event_prefix_node_destroy(&(*trie)->root, alloc);
+
+    alloc.free(alloc, *trie);
+    *trie = nullptr;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Subscribes an entity and its callback to all events whose name starts with the prefix of a wildcard name,
+ * which is the name without its trailing '*'.
+ *
+ * @param[inout] trie Trie to store the subscription.
+ * @param[in] subscribed Entity that adds the subscription.
+ * @param[in] wildcard_name Name ending with a '*'.
+ * @param[in] handle Handle of the subscription, used to revoke it.
+ * @param[in] subscription_data Callback data subscribed under the prefix.
+ * @param[inout] alloc Allocator used to extend the trie.
+ */
+void event_prefix_trie_subscribe(event_prefix_trie *trie, basilisk_engine_entity *subscribed, const identifier *wildcard_name, u64 handle, basilisk_specific_event_subscription subscription_data, allocator alloc)
+{
+    event_prefix_node *node = nullptr;
+    size_t length_before = 0u;
+
+    if (!trie || !event_prefix_is_wildcard(wildcard_name)) {
+        return;
+    }
+
+    node = event_prefix_trie_find(trie, wildcard_name, true, alloc);
+    if (!node) {
+        return;
+    }
+
+    if (!node->subscriptions.subscription_list) {
+        node->subscriptions = event_subscription_list_create((identifier *) wildcard_name, alloc);
+    }
+
+    length_before = event_subscription_list_length(&node->subscriptions);
+    event_subscription_list_append(&node->subscriptions, subscribed, handle, subscription_data, alloc);
+    trie->length += event_subscription_list_length(&node->subscriptions) - length_before;
+}
+
+/**
+ * @brief Walks the trie along the characters of an event name to gather the subscription lists of all of its
+ * prefixes, from the empty prefix to the whole name.
+ *
+ * @param[in] trie Examined trie.
+ * @param[in] event_name Name (copied) of the event.
+ * @param[inout] alloc Allocator used for the match.
+ * @return event_prefix_match
+ */
+event_prefix_match event_prefix_trie_match(const event_prefix_trie *trie, const identifier *event_name, allocator alloc)
+{
+    event_prefix_match match = { 0u };
+    event_prefix_node *node = nullptr;
+    size_t name_pos = 0u;
+
+    if (!trie || !event_name) {
+        return (event_prefix_match) { 0u };
+    }
+
+    match = (event_prefix_match) {
+            .event_name = range_create_dynamic_from_copy_of(alloc, RANGE_TO_ANY(event_name)),
+            .lists = range_create_dynamic(alloc, sizeof(*match.lists->data), BASILISK_COLLECTIONS_START_LENGTH),
+    };
+
+    node = trie->root;
+    while (node) {
+        if (node->subscriptions.subscription_list && (event_subscription_list_length(&node->subscriptions) > 0u)) {
+            match.lists = range_ensure_capacity(alloc, RANGE_TO_ANY(match.lists), 1);
+            range_insert_value(RANGE_TO_ANY(match.lists), match.lists->length, &(event_subscription_list *) { &node->subscriptions });
+        }
+
+        node = ((name_pos + 1u) < event_name->length) ? event_prefix_node_get_child(node, event_name->data[name_pos], false, alloc) : nullptr;
+        name_pos += 1u;
+    }
+
+    return match;
+}
+
+/**
+ * @brief Returns the number of prefix subscriptions added to a trie. Revoked subscriptions are only dropped from their
+ * list when an event is published to it, and are still counted.
+ *
+ * @param[in] trie Examined trie.
+ * @return size_t
+ */
+size_t event_prefix_trie_length(const event_prefix_trie *trie)
+{
+    if (!trie) {
+        return 0u;
+    }
+
+    return trie->length;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Releases the memory held by a resolved match, zero-ing out the contents of the struct. The subscription lists
+ * are not owned by the match.
+ *
+ * @param[inout] match Target match.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void event_prefix_match_destroy(event_prefix_match *match, allocator alloc)
+{
+    if (!match) {
+        return;
+    }
+
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY(match->event_name));
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY(match->lists));
+
+    *match = (event_prefix_match) { 0u };
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates a trie node without subscriptions nor children.
+ *
+ * @param[in] key Last character of the prefix of the node.
+ * @param[inout] alloc Allocator used for the creation.
+ * @return event_prefix_node *
+ */
+static event_prefix_node *event_prefix_node_create(char key, allocator alloc)
+{
+    event_prefix_node *new_node = nullptr;
+
+    new_node = alloc.malloc(alloc, sizeof(*new_node));
+
+    if (new_node) {
+        *new_node = (event_prefix_node) {
+                .key = key,
+                .subscriptions = { 0u },
+                .children = range_create_dynamic(alloc, sizeof(*new_node->children->data), BASILISK_COLLECTIONS_START_LENGTH),
+        };
+    }
+
+    return new_node;
+}
+
+/**
+ * @brief Releases the memory taken by a node, its subscriptions and all of its children, and nullifies the pointer
+ * passed.
+ *
+ * @param[inout] node Node to destroy.
+ * @param[inout] alloc Allocator used for the free.
+ */
+static void event_prefix_node_destroy(event_prefix_node **node, allocator alloc)
+{
+    if (!node || !*node) {
+        return;
+    }
+
+    for (size_t i = 0u ; i < (*node)->children->length ; i++) {
+        event_prefix_node_destroy((*node)->children->data + i, alloc);
+    }
+
+    if ((*node)->subscriptions.subscription_list) {
+        event_subscription_list_destroy(&(*node)->subscriptions, alloc);
+    }
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*node)->children));
+
+    alloc.free(alloc, *node);
+    *node = nullptr;
+}
+
+/**
+ * @brief Returns the child of a node whose prefix is one character longer. Nodes have few children : they are
+ * searched linearly.
+ *
+ * @param[inout] node Parent node.
+ * @param[in] key Character following the prefix of the parent.
+ * @param[in] should_create If set, the child is created if it does not exist.
+ * @param[inout] alloc Allocator used for the creation.
+ * @return event_prefix_node *
+ */
+static event_prefix_node *event_prefix_node_get_child(event_prefix_node *node, char key, bool should_create, allocator alloc)
+{
+    event_prefix_node *child = nullptr;
+
+    for (size_t i = 0u ; i < node->children->length ; i++) {
+        if (node->children->data[i]->key == key) {
+            return node->children->data[i];
+        }
+    }
+
+    if (!should_create) {
+        return nullptr;
+    }
+
+    child = event_prefix_node_create(key, alloc);
+    if (child) {
+        node->children = range_ensure_capacity(alloc, RANGE_TO_ANY(node->children), 1);
+        range_insert_value(RANGE_TO_ANY(node->children), node->children->length, &child);
+    }
+
+    return child;
+}
+
+/**
+ * @brief Returns the node of the prefix of a wildcard name, which is the name without its trailing '*'.
+ *
+ * @param[inout] trie Examined trie.
+ * @param[in] wildcard_name Name ending with a '*'.
+ * @param[in] should_create If set, the missing nodes are created.
+ * @param[inout] alloc Allocator used for the creation.
+ * @return event_prefix_node *
+ */
+static event_prefix_node *event_prefix_trie_find(event_prefix_trie *trie, const identifier *wildcard_name, bool should_create, allocator alloc)
+{
+    event_prefix_node *node = trie->root;
+
+    for (size_t i = 0u ; node && ((i + 2u) < wildcard_name->length) ; i++) {
+        node = event_prefix_node_get_child(node, wildcard_name->data[i], should_create, alloc);
+    }
+
+    return node;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file basilisk_event_prefix.h
+ * @author gabriel ()
+ * @brief Subscriptions to all events whose name starts with some prefix, stored in a trie of characters.
+ *
+ * A subscription to a name ending with a '*' receives all events whose name starts with the characters before the '*'.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef __EVENT_PREFIX_H__
+#define __EVENT_PREFIX_H__
+
+#include "../../basilisk_common.h"
+#include "../../event/basilisk_event.h"
+#include "../../entity/basilisk_entity.h"
+#include "../event_subscription/basilisk_event_subscription.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Opaque type to a trie of prefix subscriptions. */
+typedef struct event_prefix_trie event_prefix_trie;
+
+/**
+ * @brief Prefix subscriptions matching an event name, resolved once and kept until the prefix subscriptions change.
+ */
+typedef struct event_prefix_match {
+    /** Name of the events matched. */
+    identifier *event_name;
+    /** Non-owned subscription lists of the prefixes of the name, from the shortest prefix to the longest. */
+    RANGE(event_subscription_list *) *lists;
+} event_prefix_match;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Checks if an event name ends with the '*' wildcard. */
+bool event_prefix_is_wildcard(const identifier *event_name);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Allocates an empty trie of prefix subscriptions. */
+event_prefix_trie *event_prefix_trie_create(allocator alloc);
+
+/* Releases memory taken by a trie and all its subscriptions, and nullifies the pointer passed. */
+void event_prefix_trie_destroy(event_prefix_trie **trie, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Subscribes a callback to all events starting with the prefix of a wildcard name. */
+void event_prefix_trie_subscribe(event_prefix_trie *trie, basilisk_engine_entity *subscribed, const identifier *wildcard_name, u64 handle, basilisk_specific_event_subscription subscription_data, allocator alloc);
+
+/* Resolves the subscription lists of all prefixes of an event name. */
+event_prefix_match event_prefix_trie_match(const event_prefix_trie *trie, const identifier *event_name, allocator alloc);
+
+/* Returns the number of prefix subscriptions added to a trie. */
+size_t event_prefix_trie_length(const event_prefix_trie *trie);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Releases memory held by a resolved match. */
+void event_prefix_match_destroy(event_prefix_match *match, allocator alloc);
+
+#endif
@@ -19,6 +19,24 @@
 /* Compares two event subscriptions to order the entries in the list. */
 static i32 event_subscription_compare(const void *lhs, const void *rhs);
 
+/* Removes the entries whose handle was revoked from a list, keeping the order of the others. */
+static void event_subscription_list_compact(event_subscription_list *list, const u32 *slot_generations);
+
+/* Checks that the data of an event matches a subscription filter. */
+static bool event_filter_matches(basilisk_event_filter filter, const byte *event_data, size_t data_size);
+
+/* Sends the events of a batch matching the filter of a subscription, in runs of consecutive matching events. */
+static void event_subscription_publish_filtered(const event_subscription *sub, event ev);
+
+/* Sends an event to a subscription, applying its filter. */
+static void event_subscription_deliver(const event_subscription *sub, event ev);
+
+/* Executes the pending deliveries to concurrent subscriptions and waits for all of them. */
+static void event_subscription_fanout_run(event_subscription_fanout *fanout, allocator alloc);
+
+/* Worker task sending an event to a concurrent subscription. */
+static void event_subscription_delivery_task(void *task_args);
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -71,75 +89,45 @@ void event_subscription_list_destroy(event_subscription_list *list, allocator al
  *
  * @param[inout] list List receiving the new pair.
  * @param[in] subscribed Entity subscribing a callback to the event.
+ * @param[in] handle Handle of the subscription, used to revoke it.
  * @param[in] subscription_data Data about the function called to receive the event.
  * @param[inout] alloc Allocator used to eventually extend the list.
  */
-void event_subscription_list_append(event_subscription_list *list, basilisk_engine_entity *subscribed, basilisk_specific_event_subscription subscription_data, allocator alloc)
+void event_subscription_list_append(event_subscription_list *list, basilisk_engine_entity *subscribed, u64 handle, basilisk_specific_event_subscription subscription_data, allocator alloc)
 {
-    if (!list || !subscribed || !subscription_data.callback) {
+    if (!list || !subscribed || (!subscription_data.callback && !subscription_data.batch_callback && !subscription_data.trampoline)) {
         return;
     }
 
     list->subscription_list = range_ensure_capacity(alloc, RANGE_TO_ANY(list->subscription_list), 1);
     sorted_range_insert_in(RANGE_TO_ANY(list->subscription_list), &event_subscription_compare, &(event_subscription) {
             .index = subscription_data.index,
+            .handle = handle,
             .subscribed = subscribed,
             .subscription_data = subscription_data, });
 }
 
-/**
- * @brief Removes an entry from the list.
- *
- * @param[inout] list List containing the element to remove.
- * @param[in] subscribed Entity that subscribed a callback.
- * @param[in] subscription_data Data about the function called to receive the event.
- */
-void event_subscription_list_remove(event_subscription_list *list, basilisk_engine_entity *subscribed, basilisk_specific_event_subscription subscription_data)
-{
-    if (!list || !subscribed) {
-        return;
-    }
-
-    sorted_range_remove_from(RANGE_TO_ANY(list->subscription_list), &event_subscription_compare, &(event_subscription) {
-            .index = subscription_data.index,
-            .subscribed = subscribed,
-            .subscription_data = subscription_data, });
-}
-
-/**
- * @brief Removes all entries that are linked to an entity.
- *
- * @param[inout] list List containing the elements to remove.
- * @param[in] subscribed Entity that subscribed a (some) callback(s).
- */
-void event_subscription_list_remove_all_from(event_subscription_list *list, basilisk_engine_entity *subscribed)
-{
-    // size_t subs_index = 0u;
-    size_t pos = 0u;
-
-    if (!list || !subscribed) {
-        return;
-    }
-
-    while (pos < list->subscription_list->length) {
-        if (list->subscription_list->data[pos].subscribed == subscribed) {
-            range_remove(RANGE_TO_ANY(list->subscription_list), pos);
-        } else {
-            pos += 1u;
-        }
-    }
-}
-
 // -------------------------------------------------------------------------------------------------
 
 /**
  * @brief Sends an event to the list. The name of the event is not checked to match the one expected by the list.
- * All callbacks of the list are called, receiving their entity data and the event data.
+ * All callbacks of the list are called, receiving their entity data and the event data. A batched event is received
+ * whole by batch callbacks, and one event after the other by plain callbacks. A scoped event is only sent to the
+ * callbacks of entities in its subtree. Callbacks with a filter only receive the events matching it, without being
+ * called for the others.
+ * Entries unsubscribed since the last publication are only marked by the generation of their slot : they are removed
+ * from the list here, before any callback is called.
+ * Consecutive concurrent subscriptions are sent the event together on the worker threads, and all of them are done
+ * before the next subscription is sent the event, so the order given by the indexes still holds between runs. A run
+ * never holds two subscriptions of the same entity : the second one waits for the next run.
  *
  * @param[in] list List containing the callbacks.
  * @param[inout] ev Event sent to the list.
+ * @param[in] slot_generations Current generation of each subscription slot, indexed by slot.
+ * @param[inout] fanout Buffers used for concurrent subscriptions. If nullptr, all callbacks are executed in order.
+ * @param[inout] alloc Allocator used to extend the buffers of the fanout.
  */
-void event_subscription_list_publish(event_subscription_list *list, event ev)
+void event_subscription_list_publish(event_subscription_list *list, event ev, const u32 *slot_generations, event_subscription_fanout *fanout, allocator alloc)
 {
     event_subscription tmp_sub = { 0u };
 
@@ -147,12 +135,28 @@ void event_subscription_list_publish(event_subscription_list *list, event ev)
         return;
     }
 
+    event_subscription_list_compact(list, slot_generations);
+
     for (size_t i = 0u ; i < list->subscription_list->length ; i++) {
         tmp_sub = list->subscription_list->data[i];
-        if (tmp_sub.subscription_data.callback) {
-            basilisk_engine_entity_send_event(tmp_sub.subscribed, tmp_sub.subscription_data, ev.data);
+        if (ev.scope && !basilisk_engine_entity_is_in_subtree(tmp_sub.subscribed, ev.scope)) {
+            continue;
+        }
+
+        if (fanout && tmp_sub.subscription_data.is_concurrent) {
+            if (basilisk_engine_entity_get_fanout_run(tmp_sub.subscribed) == fanout->run) {
+                event_subscription_fanout_run(fanout, alloc);
+            }
+            basilisk_engine_entity_set_fanout_run(tmp_sub.subscribed, fanout->run);
+            fanout->deliveries = range_ensure_capacity(alloc, RANGE_TO_ANY(fanout->deliveries), 1);
+            range_insert_value(RANGE_TO_ANY(fanout->deliveries), fanout->deliveries->length, &(event_subscription_delivery) { .sub = tmp_sub, .ev = ev });
+        } else {
+            event_subscription_fanout_run(fanout, alloc);
+            event_subscription_deliver(&tmp_sub, ev);
         }
     }
+
+    event_subscription_fanout_run(fanout, alloc);
 }
 
 /**
@@ -170,6 +174,82 @@ size_t event_subscription_list_length(const event_subscription_list *list)
     return list->subscription_list->length;
 }
 
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Creates the buffers used to send events to concurrent subscriptions. The worker threads are set by the owner
+ * of the fanout.
+ *
+ * @param[inout] alloc Allocator used for the creation.
+ * @return event_subscription_fanout
+ */
+event_subscription_fanout event_subscription_fanout_create(allocator alloc)
+{
+    event_subscription_fanout new_fanout = { 0u };
+
+    new_fanout = (event_subscription_fanout) {
+            .workers = nullptr,
+            .run = 1u,
+            .deliveries = range_create_dynamic(alloc, sizeof(*new_fanout.deliveries->data), BASILISK_COLLECTIONS_START_LENGTH),
+    };
+
+    return new_fanout;
+}
+
+/**
+ * @brief Releases the buffers used to send events to concurrent subscriptions, zero-ing out the contents of the
+ * struct. No delivery must be pending.
+ *
+ * @param[inout] fanout Target fanout.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void event_subscription_fanout_destroy(event_subscription_fanout *fanout, allocator alloc)
+{
+    if (!fanout) {
+        return;
+    }
+
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY(fanout->deliveries));
+
+    *fanout = (event_subscription_fanout) { 0u };
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Builds a subscription handle. Generations start at one, so a zero handle is never valid.
+ *
+ * @param[in] slot Slot of the subscription.
+ * @param[in] generation Generation of the slot when the subscription was made.
+ * @return u64
+ */
+u64 event_subscription_handle_create(u32 slot, u32 generation)
+{
+    return ((u64) generation << 32u) | (u64) slot;
+}
+
+/**
+ * @brief Returns the slot of a subscription handle.
+ *
+ * @param[in] handle Examined handle.
+ * @return u32
+ */
+u32 event_subscription_handle_slot(u64 handle)
+{
+    return (u32) (handle & 0xFFFFFFFFu);
+}
+
+/**
+ * @brief Returns the generation of a subscription handle.
+ *
+ * @param[in] handle Examined handle.
+ * @return u32
+ */
+u32 event_subscription_handle_generation(u64 handle)
+{
+    return (u32) (handle >> 32u);
+}
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -181,3 +261,167 @@ static i32 event_subscription_compare(const void *lhs, const void *rhs)
 
     return (prio_lhs > prio_rhs) - (prio_lhs < prio_rhs);
 }
+
+/**
+ * @brief Removes the entries whose slot moved to another generation since they subscribed, in one pass that keeps
+ * the order of the remaining entries.
+ *
+ * @param[inout] list Compacted list.
+ * @param[in] slot_generations Current generation of each subscription slot, indexed by slot.
+ */
+static void event_subscription_list_compact(event_subscription_list *list, const u32 *slot_generations)
+{
+    size_t kept = 0u;
+    u64 handle = 0u;
+
+    if (!slot_generations) {
+        return;
+    }
+
+    for (size_t i = 0u ; i < list->subscription_list->length ; i++) {
+        handle = list->subscription_list->data[i].handle;
+        if (slot_generations[event_subscription_handle_slot(handle)] == event_subscription_handle_generation(handle)) {
+            list->subscription_list->data[kept] = list->subscription_list->data[i];
+            kept += 1u;
+        }
+    }
+
+    list->subscription_list->length = kept;
+}
+
+/**
+ * @brief Reads a key of 1, 2, 4 or 8 bytes in some event data and checks that its masked value is the one expected by
+ * a filter. Events too short to hold the key do not match.
+ *
+ * @param[in] filter Examined filter.
+ * @param[in] event_data Data of a single event.
+ * @param[in] data_size Number of bytes of data of the event.
+ * @return bool
+ */
+static bool event_filter_matches(basilisk_event_filter filter, const byte *event_data, size_t data_size)
+{
+    u8 key_8 = 0u;
+    u16 key_16 = 0u;
+    u32 key_32 = 0u;
+    u64 key = 0u;
+
+    if (!event_data || (filter.offset > data_size) || (filter.size > (data_size - filter.offset))) {
+        return false;
+    }
+
+    switch (filter.size) {
+        case sizeof(u8):
+            bytewise_copy(&key_8, event_data + filter.offset, sizeof(key_8));
+            key = key_8;
+            break;
+
+        case sizeof(u16):
+            bytewise_copy(&key_16, event_data + filter.offset, sizeof(key_16));
+            key = key_16;
+            break;
+
+        case sizeof(u32):
+            bytewise_copy(&key_32, event_data + filter.offset, sizeof(key_32));
+            key = key_32;
+            break;
+
+        case sizeof(u64):
+            bytewise_copy(&key, event_data + filter.offset, sizeof(key));
+            break;
+
+        default:
+            return false;
+    }
+
+    return (key & filter.mask) == filter.value;
+}
+
+/**
+ * @brief Sends the events of a (maybe batched) event matching the filter of a subscription. Consecutive matching
+ * events are sent together, so a batch callback receives contiguous runs of the batch and the subscription's callbacks
+ * are never called for events not matching the filter.
+ *
+ * @param[in] sub Subscription with a filter.
+ * @param[in] ev Event sent to the subscription.
+ */
+static void event_subscription_publish_filtered(const event_subscription *sub, event ev)
+{
+    size_t run_start = 0u;
+    size_t run_length = 0u;
+
+    for (size_t i = 0u ; i < ev.count ; i++) {
+        if (event_filter_matches(sub->subscription_data.filter, (byte *) ev.data + (i * ev.data_size), ev.data_size)) {
+            run_start = (run_length == 0u) ? i : run_start;
+            run_length += 1u;
+        } else if (run_length > 0u) {
+            basilisk_engine_entity_send_event(sub->subscribed, sub->subscription_data, (byte *) ev.data + (run_start * ev.data_size), ev.data_size, run_length);
+            run_length = 0u;
+        }
+    }
+
+    if (run_length > 0u) {
+        basilisk_engine_entity_send_event(sub->subscribed, sub->subscription_data, (byte *) ev.data + (run_start * ev.data_size), ev.data_size, run_length);
+    }
+}
+
+/**
+ * @brief Sends an event to a subscription, through its filter if it has one.
+ *
+ * @param[in] sub Target subscription.
+ * @param[in] ev Event sent to the subscription.
+ */
+static void event_subscription_deliver(const event_subscription *sub, event ev)
+{
+    if (sub->subscription_data.filter.size > 0u) {
+        event_subscription_publish_filtered(sub, ev);
+    } else {
+        basilisk_engine_entity_send_event(sub->subscribed, sub->subscription_data, ev.data, ev.data_size, ev.count);
+    }
+}
+
+/**
+ * @brief Hands the pending deliveries to the worker threads and blocks until all of them are done, the calling thread
+ * helping in the meantime. Without worker threads, the deliveries are made in order by the calling thread.
+ *
+ * @param[inout] fanout Target fanout. Can be nullptr.
+ * @param[inout] alloc Allocator used to hand the tasks to the workers.
+ */
+static void event_subscription_fanout_run(event_subscription_fanout *fanout, allocator alloc)
+{
+    if (!fanout || (fanout->deliveries->length == 0u)) {
+        return;
+    }
+
+    // the entities marked by this run are free to join the next one
+    fanout->run += 1u;
+
+    if (!fanout->workers) {
+        for (size_t i = 0u ; i < fanout->deliveries->length ; i++) {
+            event_subscription_delivery_task(fanout->deliveries->data + i);
+        }
+        range_clear(RANGE_TO_ANY(fanout->deliveries));
+        return;
+    }
+
+    for (size_t i = 0u ; i < fanout->deliveries->length ; i++) {
+        worker_pool_submit(fanout->workers, (worker_task) {
+                .routine = &event_subscription_delivery_task,
+                .args = fanout->deliveries->data + i,
+                .group = &fanout->group, }, alloc);
+    }
+
+    worker_pool_wait(fanout->workers, &fanout->group);
+    range_clear(RANGE_TO_ANY(fanout->deliveries));
+}
+
+/**
+ * @brief Worker task sending an event to a concurrent subscription.
+ *
+ * @param[inout] task_args Delivery trusted to be an event_subscription_delivery.
+ */
+static void event_subscription_delivery_task(void *task_args)
+{
+    event_subscription_delivery *delivery = (event_subscription_delivery *) task_args;
+
+    event_subscription_deliver(&delivery->sub, delivery->ev);
+}
@@ -14,6 +14,7 @@
 #include "../../basilisk_common.h"
 #include "../../event/basilisk_event.h"
 #include "../../entity/basilisk_entity.h"
+#include "../../worker_pool/basilisk_worker_pool.h"
 
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -25,6 +26,8 @@
 typedef struct event_subscription {
 
     i32 index;
+    /** Handle of the subscription, holding its slot in the lower bits and its generation in the upper bits. */
+    u64 handle;
     /** Reference to an entity thye callback is linked to */
     basilisk_engine_entity *subscribed;
     /** Pointer to some callback function to execute code on an event reception. */
@@ -42,6 +45,30 @@ typedef struct event_subscription_list{
     RANGE(event_subscription) *subscription_list;
 } event_subscription_list;
 
+/**
+ * @brief Concurrent subscription receiving an event on a worker thread.
+ */
+typedef struct event_subscription_delivery {
+    /** Copy of the subscription. */
+    event_subscription sub;
+    /** Non-owned event sent to the subscription. */
+    event ev;
+} event_subscription_delivery;
+
+/**
+ * @brief Sends events to runs of concurrent subscriptions on worker threads.
+ */
+typedef struct event_subscription_fanout {
+    /** Non-owned threads executing the concurrent callbacks. If nullptr, they are executed by the publishing thread. */
+    worker_pool *workers;
+    /** Group of the tasks of the current run of concurrent callbacks. */
+    worker_task_group group;
+    /** Number of the current run, marked on the entities it delivers to. Starts at one, as entities start unmarked. */
+    u64 run;
+    /** Deliveries of the current run, reused from one run to the next. */
+    RANGE(event_subscription_delivery) *deliveries;
+} event_subscription_fanout;
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -55,18 +82,31 @@ void event_subscription_list_destroy(event_subscription_list *list, allocator al
 // -------------------------------------------------------------------------------------------------
 
 /* Inserts a new entry in the callback list. */
-void event_subscription_list_append(event_subscription_list *list, basilisk_engine_entity *subscribed, basilisk_specific_event_subscription subscription_data, allocator alloc);
+void event_subscription_list_append(event_subscription_list *list, basilisk_engine_entity *subscribed, u64 handle, basilisk_specific_event_subscription subscription_data, allocator alloc);
 
-/* Removes an entry from the callback list. */
-void event_subscription_list_remove(event_subscription_list *list, basilisk_engine_entity *subscribed, basilisk_specific_event_subscription subscription_data);
+// -------------------------------------------------------------------------------------------------
 
-/* Removes all entries tied to some entity. */
-void event_subscription_list_remove_all_from(event_subscription_list *list, basilisk_engine_entity *subscribed);
+/* Publishes an event to a callback list, dropping the revoked entries. The event is trusted to be of the right name as the one of the list. */
+void event_subscription_list_publish(event_subscription_list *list, event ev, const u32 *slot_generations, event_subscription_fanout *fanout, allocator alloc);
 
 // -------------------------------------------------------------------------------------------------
 
-/* Publishes an event to a callback list. The event is trusted to be of the right name as the one of the list. */
-void event_subscription_list_publish(event_subscription_list *list, event ev);
+/* Creates the buffers used to send events to concurrent subscriptions. */
+event_subscription_fanout event_subscription_fanout_create(allocator alloc);
+
+/* Releases the buffers used to send events to concurrent subscriptions. */
+void event_subscription_fanout_destroy(event_subscription_fanout *fanout, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Builds a subscription handle from a slot and a generation. */
+u64 event_subscription_handle_create(u32 slot, u32 generation);
+
+/* Returns the slot of a subscription handle. */
+u32 event_subscription_handle_slot(u64 handle);
+
+/* Returns the generation of a subscription handle. */
+u32 event_subscription_handle_generation(u64 handle);
 
 /* Returns the number of callbacks in a list. */
 size_t event_subscription_list_length(const event_subscription_list *list);
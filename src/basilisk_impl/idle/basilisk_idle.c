@@ -0,0 +1,312 @@
+/**
+ * @file basilisk_idle.c
+ * @author gabriel ()
+ * @brief Implementation file for the idle task queue.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "basilisk_idle.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/// Weight of the last measured slice in the estimated duration of a task's slices, when the slice was shorter than estimated.
+#define IDLE_QUEUE_ESTIMATE_DECAY (0.25)
+/// Milliseconds kept free before the deadline to absorb the imprecision of the sleep that follows.
+#define IDLE_QUEUE_SAFETY_MARGIN_MS (0.5)
+/// Number of consecutive runs of the queue a task can be skipped in before one of its slices is executed regardless of the deadline.
+#define IDLE_QUEUE_SKIPPED_RUNS_MAX (60u)
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Single idle task tied to an entity, followed by its data.
+ */
+typedef struct idle_task {
+    /** Entity the task works for. */
+    basilisk_engine_entity *source;
+    /** Function executing a slice of the task. */
+    bool (*routine)(basilisk_entity *self_data, void *task_data);
+    /** Expected duration of a slice, in milliseconds. Raised at once by a longer slice, lowered slowly by shorter ones
+    and by each run of the queue skipping the task. */
+    f64 estimate_ms;
+    /** Number of consecutive runs of the queue that skipped the task. */
+    size_t skipped_runs;
+    /** Last run of the queue that skipped the task. */
+    u64 skipped_run;
+    /** Copy of the task's data. */
+    byte data[];
+} idle_task;
+
+/**
+ * @brief Collection of idle tasks executed in turn.
+ */
+typedef struct idle_queue {
+    /** Tasks, in the order they were pushed. */
+    RANGE(idle_task *) *tasks;
+    /** Index of the next task to execute. */
+    size_t next_task;
+    /** Number of times the queue was run. */
+    u64 runs;
+} idle_queue;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Removes a task from the queue and releases it. */
+static void idle_queue_release(idle_queue *queue, size_t index, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates an empty idle task queue.
+ *
+ * @param[inout] alloc Allocator used for the creation.
+ * @return idle_queue *
+ */
+idle_queue *idle_queue_create(allocator alloc)
+{
+    idle_queue *new_queue = nullptr;
+
+    new_queue = alloc.malloc(alloc, sizeof(*new_queue));
+
+    if (new_queue) {
+        *new_queue = (idle_queue) {
+                .tasks = range_create_dynamic(alloc, sizeof(*new_queue->tasks->data), BASILISK_COLLECTIONS_START_LENGTH),
+        };
+    }
+
+    return new_queue;
+}
+
+/**
+ * @brief Releases the memory taken by an idle task queue and its remaining tasks, and nullifies the pointer passed.
+ *
+ * @param[inout] queue Object to destroy.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void idle_queue_destroy(idle_queue **queue, allocator alloc)
+{
+    if (!queue || !*queue) {
+        return;
+    }
+
+    for (size_t i = 0u ; i < (*queue)->tasks->length ; i++) {
+        alloc.free(alloc, (*queue)->tasks->data[i]);
+    }
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*queue)->tasks));
+
+    alloc.free(alloc, *queue);
+    *queue = nullptr;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Copies a task and its data, ties it to an entity and appends it to the queue. The duration of its slices is
+ * estimated from the hint of the task until a slice is measured.
+ *
+ * @param[inout] queue Target queue.
+ * @param[in] source Entity the task works for.
+ * @param[in] task_data Description of the task. Its data is copied.
+ * @param[inout] alloc Allocator used for the copy.
+ */
+void idle_queue_push(idle_queue *queue, basilisk_engine_entity *source, basilisk_specific_idle_task task_data, allocator alloc)
+{
+    idle_task *new_task = nullptr;
+
+    if (!queue || !task_data.routine) {
+        return;
+    }
+
+    new_task = alloc.malloc(alloc, sizeof(*new_task) + task_data.data_size);
+
+    if (!new_task) {
+        return;
+    }
+
+    // the first slice is only started if it fits in the time left, as would the following ones
+    *new_task = (idle_task) {
+            .source = source,
+            .routine = task_data.routine,
+            .estimate_ms = (f64) ((task_data.slice_ms > 0u) ? task_data.slice_ms : BASILISK_IDLE_SLICE_MS),
+    };
+
+    if (task_data.data && (task_data.data_size > 0u)) {
+        bytewise_copy(new_task->data, task_data.data, task_data.data_size);
+    }
+
+    queue->tasks = range_ensure_capacity(alloc, RANGE_TO_ANY(queue->tasks), 1);
+    range_insert_value(RANGE_TO_ANY(queue->tasks), queue->tasks->length, &new_task);
+}
+
+/**
+ * @brief Removes and releases all tasks tied to an entity.
+ *
+ * @param[inout] queue Target queue.
+ * @param[in] source Entity whose tasks are removed.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void idle_queue_remove_tasks_of(idle_queue *queue, basilisk_engine_entity *source, allocator alloc)
+{
+    if (!queue) {
+        return;
+    }
+
+    for (size_t i = queue->tasks->length ; i > 0u ; i--) {
+        if (queue->tasks->data[i - 1u]->source == source) {
+            idle_queue_release(queue, i - 1u, alloc);
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Executes slices of the tasks in turn, resuming from where the last call stopped, as long as the next slice
+ * is expected to end before the deadline. A task is skipped when its slices are expected to take too long, and the
+ * function returns once no task fits in the remaining time. A task whose routine returns false is finished and
+ * released.
+ * Each call skipping a task lowers the estimated duration of its slices, so that a task measured once on a long slice
+ * gets another chance. A task skipped by too many consecutive calls is given a slice regardless of the deadline ; the
+ * function returns the number of such slices.
+ *
+ * @param[inout] queue Target queue.
+ * @param[in] deadline_ms Point in time, from time_monotonic_ms(), before which the slices must end.
+ * @param[inout] alloc Allocator used to release the finished tasks.
+ * @return size_t
+ */
+size_t idle_queue_run_until(idle_queue *queue, f64 deadline_ms, allocator alloc)
+{
+    size_t skipped = 0u;
+    size_t forced_slices = 0u;
+    f64 slice_start = 0.;
+    f64 slice_duration = 0.;
+    idle_task *task = nullptr;
+    bool has_more_work = false;
+
+    if (!queue) {
+        return 0u;
+    }
+
+    queue->runs += 1u;
+
+    while ((queue->tasks->length > 0u) && (skipped < queue->tasks->length)) {
+        queue->next_task %= queue->tasks->length;
+        task = queue->tasks->data[queue->next_task];
+
+        slice_start = time_monotonic_ms();
+        if ((task->skipped_runs < IDLE_QUEUE_SKIPPED_RUNS_MAX) && ((slice_start + task->estimate_ms + IDLE_QUEUE_SAFETY_MARGIN_MS) > deadline_ms)) {
+            // a task seen several times by the same run is only counted once
+            if (task->skipped_run != queue->runs) {
+                task->skipped_run = queue->runs;
+                task->skipped_runs += 1u;
+                task->estimate_ms *= (1. - IDLE_QUEUE_ESTIMATE_DECAY);
+            }
+            queue->next_task += 1u;
+            skipped += 1u;
+            continue;
+        }
+
+        if (task->skipped_runs >= IDLE_QUEUE_SKIPPED_RUNS_MAX) {
+            forced_slices += 1u;
+        }
+        task->skipped_runs = 0u;
+
+        has_more_work = task->routine(basilisk_engine_entity_get_specific_data(task->source), task->data);
+        slice_duration = time_monotonic_ms() - slice_start;
+
+        if (slice_duration > task->estimate_ms) {
+            task->estimate_ms = slice_duration;
+        } else {
+            task->estimate_ms += (slice_duration - task->estimate_ms) * IDLE_QUEUE_ESTIMATE_DECAY;
+        }
+
+        if (has_more_work) {
+            queue->next_task += 1u;
+        } else {
+            idle_queue_release(queue, queue->next_task, alloc);
+        }
+        skipped = 0u;
+    }
+
+    return forced_slices;
+}
+
+/**
+ * @brief Executes one slice of each task in turn, resuming from where the last run stopped, without measuring them
+ * nor looking at the time : as many slices are executed as there were tasks when the pass started. Used when frames
+ * have no deadline, as when replaying a session. A task whose routine returns false is finished and released.
+ *
+ * @param[inout] queue Target queue.
+ * @param[inout] alloc Allocator used to release the finished tasks.
+ */
+void idle_queue_run_pass(idle_queue *queue, allocator alloc)
+{
+    size_t slices_left = 0u;
+    idle_task *task = nullptr;
+
+    if (!queue) {
+        return;
+    }
+
+    slices_left = queue->tasks->length;
+
+    while ((slices_left > 0u) && (queue->tasks->length > 0u)) {
+        queue->next_task %= queue->tasks->length;
+        task = queue->tasks->data[queue->next_task];
+
+        if (task->routine(basilisk_engine_entity_get_specific_data(task->source), task->data)) {
+            queue->next_task += 1u;
+        } else {
+            idle_queue_release(queue, queue->next_task, alloc);
+        }
+        slices_left -= 1u;
+    }
+}
+
+/**
+ * @brief Returns the number of tasks in the queue.
+ *
+ * @param[in] queue Target queue.
+ * @return size_t
+ */
+size_t idle_queue_length(const idle_queue *queue)
+{
+    if (!queue) {
+        return 0u;
+    }
+
+    return queue->tasks->length;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Removes a task from the queue, keeping the order of the others, and releases its memory.
+ *
+ * @param[inout] queue Target queue.
+ * @param[in] index Position of the task in the queue.
+ * @param[inout] alloc Allocator used for the free.
+ */
+static void idle_queue_release(idle_queue *queue, size_t index, allocator alloc)
+{
+    alloc.free(alloc, queue->tasks->data[index]);
+    range_remove(RANGE_TO_ANY(queue->tasks), index);
+
+    if (queue->next_task > index) {
+        queue->next_task -= 1u;
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * @file basilisk_idle.h
+ * @author gabriel ()
+ * @brief Run low-priority entity work in the time left before the end of a frame.
+ *
+ * Idle tasks are executed in slices, in turn. The duration of a task's slices is measured, and a slice is only
+ * started if it is expected to end before the frame's deadline, so that idle work does not delay the next frame. A task
+ * that never fits is still given a slice once in a while. Frames without a deadline, as when replaying a session, give
+ * one slice to each task.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef __IDLE_H__
+#define __IDLE_H__
+
+#include "../basilisk_common.h"
+#include "../entity/basilisk_entity.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Opaque type to a collection of idle tasks. */
+typedef struct idle_queue idle_queue;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Allocates an idle task queue and returns a pointer to it. */
+idle_queue *idle_queue_create(allocator alloc);
+
+/* Releases memory taken by an idle task queue and its tasks, and nullifies the pointer passed. */
+void idle_queue_destroy(idle_queue **queue, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Copies a task tied to an entity at the end of the queue. */
+void idle_queue_push(idle_queue *queue, basilisk_engine_entity *source, basilisk_specific_idle_task task_data, allocator alloc);
+
+/* Removes all tasks tied to an entity. */
+void idle_queue_remove_tasks_of(idle_queue *queue, basilisk_engine_entity *source, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Executes slices of the tasks in turn, as long as they are expected to end before some deadline, and returns the number of slices forced past it. */
+size_t idle_queue_run_until(idle_queue *queue, f64 deadline_ms, allocator alloc);
+
+/* Executes one slice of each task, however long they take. */
+void idle_queue_run_pass(idle_queue *queue, allocator alloc);
+
+/* Returns the number of tasks in the queue. */
+size_t idle_queue_length(const idle_queue *queue);
+
+#endif
@@ -0,0 +1,167 @@
+/**
+ * @file basilisk_inbox.c
+ * @author gabriel ()
+ * @brief Implementation file for the lock-free multi-producer single-consumer inbox.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdatomic.h>
+
+#include "basilisk_inbox.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Link of the inbox list, followed by the item it carries.
+ */
+typedef struct mpsc_inbox_node {
+    /** Next (newer) node in the list. */
+    _Atomic(struct mpsc_inbox_node *) next;
+    /** Copy of the item. */
+    byte item[];
+} mpsc_inbox_node;
+
+/**
+ * @brief Linked list of items. The consumer owns a stub node at the tail of the list whose item was already
+ * consumed ; producers append nodes at the head.
+ */
+typedef struct mpsc_inbox {
+    /** Size, in bytes, of the items carried by the inbox. */
+    size_t item_size;
+    /** Newest node, swapped by producers. */
+    _Atomic(mpsc_inbox_node *) head;
+    /** Oldest node, already consumed, only touched by the consumer. */
+    mpsc_inbox_node *tail;
+} mpsc_inbox;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates an empty inbox carrying items of some size.
+ * The allocator is used from all producer threads and must be thread-safe, as the system allocator is.
+ *
+ * @param[in] item_size Size, in bytes, of a single item.
+ * @param[inout] alloc Allocator used for the creation.
+ * @return mpsc_inbox *
+ */
+mpsc_inbox *mpsc_inbox_create(size_t item_size, allocator alloc)
+{
+    mpsc_inbox *new_inbox = nullptr;
+    mpsc_inbox_node *stub = nullptr;
+
+    stub = alloc.malloc(alloc, sizeof(*stub) + item_size);
+    if (!stub) {
+        return nullptr;
+    }
+
+    new_inbox = alloc.malloc(alloc, sizeof(*new_inbox));
+    if (!new_inbox) {
+        alloc.free(alloc, stub);
+        return nullptr;
+    }
+
+    atomic_init(&stub->next, nullptr);
+
+    *new_inbox = (mpsc_inbox) { .item_size = item_size, .tail = stub, };
+    atomic_init(&new_inbox->head, stub);
+
+    return new_inbox;
+}
+
+/**
+ * @brief Releases the memory taken by an inbox and nullifies the pointer passed. Items still in the inbox are
+ * dropped : drain them beforehand if they own memory.
+ *
+ * @param[inout] inbox Object to destroy.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void mpsc_inbox_destroy(mpsc_inbox **inbox, allocator alloc)
+{
+    mpsc_inbox_node *node = nullptr;
+    mpsc_inbox_node *next = nullptr;
+
+    if (!inbox || !*inbox) {
+        return;
+    }
+
+    node = (*inbox)->tail;
+    while (node) {
+        next = atomic_load_explicit(&node->next, memory_order_acquire);
+        alloc.free(alloc, node);
+        node = next;
+    }
+
+    alloc.free(alloc, *inbox);
+    *inbox = nullptr;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Appends a copy of an item at the head of the inbox. Safe to call concurrently from any number of threads.
+ *
+ * @param[inout] inbox Target inbox.
+ * @param[in] item Item (copied) of the size given at the inbox creation.
+ * @param[inout] alloc Thread-safe allocator used to create the node.
+ */
+void mpsc_inbox_push(mpsc_inbox *inbox, const void *item, allocator alloc)
+{
+    mpsc_inbox_node *node = nullptr;
+    mpsc_inbox_node *previous = nullptr;
+
+    if (!inbox || !item) {
+        return;
+    }
+
+    node = alloc.malloc(alloc, sizeof(*node) + inbox->item_size);
+    if (!node) {
+        return;
+    }
+
+    atomic_init(&node->next, nullptr);
+    bytewise_copy(node->item, item, inbox->item_size);
+
+    previous = atomic_exchange_explicit(&inbox->head, node, memory_order_acq_rel);
+    atomic_store_explicit(&previous->next, node, memory_order_release);
+}
+
+/**
+ * @brief Removes the oldest item of the inbox, copying it to the given location, and returns true. If the inbox is
+ * empty, or if the oldest item is still being appended by a producer, the function returns false.
+ * Only one thread may consume an inbox.
+ *
+ * @param[inout] inbox Target inbox.
+ * @param[out] out_item Outgoing item.
+ * @param[inout] alloc Allocator used to release the consumed node.
+ * @return bool
+ */
+bool mpsc_inbox_pop(mpsc_inbox *inbox, void *out_item, allocator alloc)
+{
+    mpsc_inbox_node *stub = nullptr;
+    mpsc_inbox_node *next = nullptr;
+
+    if (!inbox || !out_item) {
+        return false;
+    }
+
+    stub = inbox->tail;
+    next = atomic_load_explicit(&stub->next, memory_order_acquire);
+
+    if (!next) {
+        return false;
+    }
+
+    bytewise_copy(out_item, next->item, inbox->item_size);
+    inbox->tail = next;
+    alloc.free(alloc, stub);
+
+    return true;
+}
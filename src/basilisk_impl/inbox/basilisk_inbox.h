@@ -0,0 +1,45 @@
+/**
+ * @file basilisk_inbox.h
+ * @author gabriel ()
+ * @brief Hand fixed-size items from any thread to a single consumer thread, without locks.
+ *
+ * The inbox is an intrusive multi-producer single-consumer linked queue : producers only perform an atomic exchange
+ * to append an item, and the consumer walks the list without synchronizing with them.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef __INBOX_H__
+#define __INBOX_H__
+
+#include "../basilisk_common.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Opaque type to a multi-producer single-consumer FIFO collection of items. */
+typedef struct mpsc_inbox mpsc_inbox;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Allocates an inbox carrying items of a fixed size. */
+mpsc_inbox *mpsc_inbox_create(size_t item_size, allocator alloc);
+
+/* Releases memory taken by an inbox and its remaining items, and nullifies the pointer passed. */
+void mpsc_inbox_destroy(mpsc_inbox **inbox, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Appends a copy of an item to the inbox. Can be called from any thread. */
+void mpsc_inbox_push(mpsc_inbox *inbox, const void *item, allocator alloc);
+
+/* Removes the oldest item of the inbox and copies it out. Must only be called from the consumer thread. */
+bool mpsc_inbox_pop(mpsc_inbox *inbox, void *out_item, allocator alloc);
+
+#endif
@@ -0,0 +1,270 @@
+/**
+ * @file basilisk_job.c
+ * @author gabriel ()
+ * @brief Implementation file for the entity job system.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdatomic.h>
+
+#include "basilisk_job.h"
+
+#include "../inbox/basilisk_inbox.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Single job tied to an entity, followed by its data.
+ */
+typedef struct job {
+    /** Non-owned reference to the system the job was submitted to. */
+    job_system *system;
+    /** Entity receiving the completion callback. Only touched by the main thread. */
+    basilisk_engine_entity *source;
+    /** Set from the main thread when the job's entity is removed. */
+    atomic_bool is_cancelled;
+
+    /** Function executed on a worker thread. */
+    void (*routine)(void *job_data);
+    /** Function executed on the main thread once the routine is done. */
+    void (*on_done)(basilisk_entity *self_data, void *job_data);
+
+    /** Size, in bytes, of the job's data. */
+    size_t data_size;
+    /** Copy of the job's data. */
+    byte data[];
+} job;
+
+/**
+ * @brief Collection of jobs running on a worker pool.
+ */
+typedef struct job_system {
+    /** Non-owned pool executing the jobs. */
+    worker_pool *workers;
+    /** Thread-safe copy of the engine's allocator, used by the workers to send finished jobs. */
+    allocator alloc;
+
+    /** Jobs submitted and not collected yet. Only touched by the main thread. */
+    RANGE(job *) *in_flight;
+    /** Jobs whose routine returned, waiting to be collected. */
+    mpsc_inbox *finished;
+} job_system;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Executes a job on a worker thread and sends it to the finished jobs. */
+static void job_run(void *task_args);
+
+/* Removes a job from the jobs in flight and releases it. */
+static void job_system_release(job_system *jobs, job *target, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates an empty job system submitting its jobs to some worker pool.
+ * The allocator is used from the worker threads and must be thread-safe, as the system allocator is.
+ *
+ * @param[inout] workers Non-owned pool executing the jobs.
+ * @param[inout] alloc Allocator used for the creation.
+ * @return job_system *
+ */
+job_system *job_system_create(worker_pool *workers, allocator alloc)
+{
+    job_system *new_jobs = nullptr;
+
+    new_jobs = alloc.malloc(alloc, sizeof(*new_jobs));
+
+    if (!new_jobs) {
+        return nullptr;
+    }
+
+    *new_jobs = (job_system) {
+            .workers = workers,
+            .alloc = alloc,
+            .in_flight = range_create_dynamic(alloc, sizeof(*new_jobs->in_flight->data), BASILISK_COLLECTIONS_START_LENGTH),
+            .finished = mpsc_inbox_create(sizeof(job *), alloc),
+    };
+
+    return new_jobs;
+}
+
+/**
+ * @brief Releases the memory taken by a job system and its jobs, and nullifies the pointer passed. The worker pool
+ * must not be running any job of the system anymore : cancel the jobs and wait for the pool beforehand.
+ *
+ * @param[inout] jobs Object to destroy.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void job_system_destroy(job_system **jobs, allocator alloc)
+{
+    if (!jobs || !*jobs) {
+        return;
+    }
+
+    for (size_t i = 0u ; i < (*jobs)->in_flight->length ; i++) {
+        alloc.free(alloc, (*jobs)->in_flight->data[i]);
+    }
+
+    mpsc_inbox_destroy(&(*jobs)->finished, alloc);
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY((*jobs)->in_flight));
+
+    alloc.free(alloc, *jobs);
+    *jobs = nullptr;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Copies a job and its data, ties it to an entity and hands it to the worker pool.
+ * Must be called from the main thread.
+ *
+ * @param[inout] jobs Target job system.
+ * @param[in] source Entity receiving the completion callback.
+ * @param[in] job_data Job description. Its data is copied.
+ * @param[inout] alloc Allocator used to copy the job.
+ */
+void job_system_submit(job_system *jobs, basilisk_engine_entity *source, basilisk_specific_job job_data, allocator alloc)
+{
+    job *new_job = nullptr;
+
+    if (!jobs || !job_data.routine) {
+        return;
+    }
+
+    new_job = alloc.malloc(alloc, sizeof(*new_job) + job_data.data_size);
+
+    if (!new_job) {
+        return;
+    }
+
+    *new_job = (job) {
+            .system = jobs,
+            .source = source,
+            .routine = job_data.routine,
+            .on_done = job_data.on_done,
+            .data_size = job_data.data_size,
+    };
+    atomic_init(&new_job->is_cancelled, false);
+
+    if (job_data.data && (job_data.data_size > 0u)) {
+        bytewise_copy(new_job->data, job_data.data, job_data.data_size);
+    }
+
+    jobs->in_flight = range_ensure_capacity(alloc, RANGE_TO_ANY(jobs->in_flight), 1);
+    range_insert_value(RANGE_TO_ANY(jobs->in_flight), jobs->in_flight->length, &new_job);
+
+    worker_pool_submit(jobs->workers, (worker_task) { .routine = &job_run, .args = new_job, }, alloc);
+}
+
+/**
+ * @brief Flags all jobs tied to an entity as cancelled : their routine will be skipped if it did not start yet, and
+ * their completion callback will never be executed. If no entity is given, all jobs are cancelled.
+ * Must be called from the main thread.
+ *
+ * @param[inout] jobs Target job system.
+ * @param[in] source Entity whose jobs are cancelled. Can be nullptr.
+ */
+void job_system_cancel_jobs_of(job_system *jobs, basilisk_engine_entity *source)
+{
+    if (!jobs) {
+        return;
+    }
+
+    for (size_t i = 0u ; i < jobs->in_flight->length ; i++) {
+        if (!source || (jobs->in_flight->data[i]->source == source)) {
+            atomic_store(&jobs->in_flight->data[i]->is_cancelled, true);
+            jobs->in_flight->data[i]->source = nullptr;
+        }
+    }
+}
+
+/**
+ * @brief Executes, in order of completion, the completion callback of all jobs that finished since the last call,
+ * then releases them. Cancelled jobs are released silently. Must be called from the main thread.
+ *
+ * @param[inout] jobs Target job system.
+ * @param[inout] alloc Allocator used to release the jobs.
+ */
+void job_system_collect(job_system *jobs, allocator alloc)
+{
+    job *finished_job = nullptr;
+
+    if (!jobs) {
+        return;
+    }
+
+    while (mpsc_inbox_pop(jobs->finished, &finished_job, alloc)) {
+        if (!atomic_load(&finished_job->is_cancelled)) {
+            basilisk_engine_entity_send_job_result(finished_job->source, finished_job->on_done, finished_job->data);
+        }
+        job_system_release(jobs, finished_job, alloc);
+    }
+}
+
+/**
+ * @brief Returns the number of jobs submitted and not collected yet, including running and cancelled ones.
+ *
+ * @param[in] jobs Target job system.
+ * @return size_t
+ */
+size_t job_system_length(const job_system *jobs)
+{
+    if (!jobs) {
+        return 0u;
+    }
+
+    return jobs->in_flight->length;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Executes the routine of a job if it was not cancelled, then sends the job to the finished jobs of its system.
+ * Runs on a worker thread.
+ *
+ * @param[inout] task_args Job to execute.
+ */
+static void job_run(void *task_args)
+{
+    job *target = (job *) task_args;
+
+    if (!atomic_load(&target->is_cancelled)) {
+        target->routine(target->data);
+    }
+
+    mpsc_inbox_push(target->system->finished, &target, target->system->alloc);
+}
+
+/**
+ * @brief Removes a job from the jobs in flight of a system and releases its memory.
+ *
+ * @param[inout] jobs Target job system.
+ * @param[inout] target Released job.
+ * @param[inout] alloc Allocator used for the free.
+ */
+static void job_system_release(job_system *jobs, job *target, allocator alloc)
+{
+    size_t pos = 0u;
+
+    while ((pos < jobs->in_flight->length) && (jobs->in_flight->data[pos] != target)) {
+        pos += 1u;
+    }
+
+    if (pos < jobs->in_flight->length) {
+        range_remove(RANGE_TO_ANY(jobs->in_flight), pos);
+    }
+
+    alloc.free(alloc, target);
+}
@@ -0,0 +1,55 @@
+/**
+ * @file basilisk_job.h
+ * @author gabriel ()
+ * @brief Run work submitted by entities on worker threads, and hand the results back on the main thread.
+ *
+ * Jobs are executed by the engine's worker pool. Finished jobs are collected by the main thread through a lock-free
+ * inbox, so that their completion callback is executed at a known point of the frame. A job tied to an entity that
+ * is removed before its completion is cancelled : its routine is skipped if it did not start yet, and its completion
+ * callback is never executed.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef __JOB_H__
+#define __JOB_H__
+
+#include "../basilisk_common.h"
+#include "../entity/basilisk_entity.h"
+#include "../worker_pool/basilisk_worker_pool.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Opaque type to a collection of jobs running on a worker pool. */
+typedef struct job_system job_system;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Allocates a job system submitting its jobs to some worker pool. */
+job_system *job_system_create(worker_pool *workers, allocator alloc);
+
+/* Releases memory taken by a job system and nullifies the pointer passed. */
+void job_system_destroy(job_system **jobs, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Copies a job tied to an entity and hands it to the worker pool. */
+void job_system_submit(job_system *jobs, basilisk_engine_entity *source, basilisk_specific_job job_data, allocator alloc);
+
+/* Cancels all jobs tied to an entity, or all jobs if no entity is given. */
+void job_system_cancel_jobs_of(job_system *jobs, basilisk_engine_entity *source);
+
+/* Executes the completion callbacks of the jobs that finished since the last call and releases them. */
+void job_system_collect(job_system *jobs, allocator alloc);
+
+/* Returns the number of jobs submitted and not collected yet. */
+size_t job_system_length(const job_system *jobs);
+
+#endif
@@ -0,0 +1,398 @@
+/**
+ * @file basilisk_message.c
+ * @author gabriel ()
+ * @brief Implementation file for the mailboxes of entities and the post office delivering their messages.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "basilisk_message.h"
+#include "../inbox/basilisk_inbox.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Message sent to an entity, allocated with its data in a single block.
+ */
+typedef struct message {
+    /** Next message of the same mailbox. */
+    struct message *next;
+
+    /** User-defined identifier of the message. */
+    unsigned long message_id;
+    /** Number of bytes of data carried by the message. */
+    size_t data_size;
+    /** Data carried by the message. */
+    byte data[];
+} message;
+
+/**
+ * @brief Message sent from another thread, waiting in the inbox of the post office.
+ */
+typedef struct message_posted {
+    /** Mailbox receiving the message. */
+    message_mailbox *target;
+    /** Actual message. */
+    message *posted;
+} message_posted;
+
+/**
+ * @brief Serves the mailboxes holding messages in turn, one message at a time.
+ */
+typedef struct message_post_office {
+    /** Mailbox served next. */
+    message_mailbox *first_pending;
+    /** Mailbox served last. */
+    message_mailbox *last_pending;
+
+    /** Number of messages in all mailboxes. */
+    size_t length;
+
+    /** Messages sent from other threads, waiting to be put in their mailbox. */
+    mpsc_inbox *inbox;
+} message_post_office;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Allocates a message and copies its data. */
+static message *message_create(unsigned long message_id, const void *data, size_t data_size, allocator alloc);
+
+/* Appends a message to a mailbox, and queues the mailbox to be served if it was empty. */
+static void message_post_office_put(message_post_office *office, message_mailbox *target, message *sent);
+
+/* Removes a mailbox from the mailboxes to serve. */
+static void message_post_office_unlink(message_post_office *office, message_mailbox *mailbox);
+
+/* Adds a mailbox at the end of the mailboxes to serve. */
+static void message_post_office_link(message_post_office *office, message_mailbox *mailbox);
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Creates an empty mailbox for an entity.
+ *
+ * @param[in] owner Entity receiving the messages.
+ * @return message_mailbox
+ */
+message_mailbox message_mailbox_create(basilisk_engine_entity *owner)
+{
+    return (message_mailbox) { .owner = owner, };
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates a post office with no mailbox to serve.
+ *
+ * @param[inout] alloc Allocator used for the creation.
+ * @return message_post_office *
+ */
+message_post_office *message_post_office_create(allocator alloc)
+{
+    message_post_office *new_office = nullptr;
+
+    new_office = alloc.malloc(alloc, sizeof(*new_office));
+
+    if (new_office) {
+        *new_office = (message_post_office) {
+                .inbox = mpsc_inbox_create(sizeof(message_posted), alloc),
+        };
+    }
+
+    return new_office;
+}
+
+/**
+ * @brief Releases the memory taken by a post office and the messages still waiting in mailboxes, and nullifies the
+ * pointer passed.
+ *
+ * @param[inout] office Object to destroy.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void message_post_office_destroy(message_post_office **office, allocator alloc)
+{
+    if (!office || !*office) {
+        return;
+    }
+
+    message_post_office_drain_inbox(*office, alloc);
+    mpsc_inbox_destroy(&(*office)->inbox, alloc);
+
+    while ((*office)->first_pending) {
+        message_post_office_discard(*office, (*office)->first_pending, alloc);
+    }
+
+    alloc.free(alloc, *office);
+    *office = nullptr;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Puts a copy of some message at the end of a mailbox. Must be called from the thread owning the post office.
+ *
+ * @param[inout] office Post office serving the mailbox.
+ * @param[inout] target Mailbox receiving the message.
+ * @param[in] message_id User-defined identifier of the message.
+ * @param[in] data Data (copied) carried by the message. Might be nullptr.
+ * @param[in] data_size Number of bytes of data.
+ * @param[inout] alloc Allocator used for the copy.
+ */
+void message_post_office_send(message_post_office *office, message_mailbox *target, unsigned long message_id, const void *data, size_t data_size, allocator alloc)
+{
+    message *sent = nullptr;
+
+    if (!office || !target) {
+        return;
+    }
+
+    sent = message_create(message_id, data, data_size, alloc);
+
+    if (sent) {
+        message_post_office_put(office, target, sent);
+    }
+}
+
+/**
+ * @brief Puts a copy of some message in the inbox of the post office.
+ * Unlike `message_post_office_send()`, this function can be called from any thread : the message will be put in its
+ * mailbox on the next call to `message_post_office_drain_inbox()`.
+ *
+ * @param[inout] office Post office serving the mailbox.
+ * @param[inout] target Mailbox receiving the message.
+ * @param[in] message_id User-defined identifier of the message.
+ * @param[in] data Data (copied) carried by the message. Might be nullptr.
+ * @param[in] data_size Number of bytes of data.
+ * @param[inout] alloc Thread-safe allocator used for the copy.
+ */
+void message_post_office_send_threadsafe(message_post_office *office, message_mailbox *target, unsigned long message_id, const void *data, size_t data_size, allocator alloc)
+{
+    message *sent = nullptr;
+
+    if (!office || !target) {
+        return;
+    }
+
+    sent = message_create(message_id, data, data_size, alloc);
+
+    if (sent) {
+        mpsc_inbox_push(office->inbox, &(message_posted) { .target = target, .posted = sent, }, alloc);
+    }
+}
+
+/**
+ * @brief Moves all messages received in the inbox of the post office to their mailbox, in the order they were
+ * received. Must be called from the thread owning the post office.
+ *
+ * @param[inout] office Target post office.
+ * @param[inout] alloc Allocator used by the inbox.
+ */
+void message_post_office_drain_inbox(message_post_office *office, allocator alloc)
+{
+    message_posted received = { 0u };
+
+    if (!office) {
+        return;
+    }
+
+    while (mpsc_inbox_pop(office->inbox, &received, alloc)) {
+        message_post_office_put(office, received.target, received.posted);
+    }
+}
+
+/**
+ * @brief Delivers the oldest message of the next mailbox to serve to the entity owning it, then destroys the message.
+ * Mailboxes are served in turn, one message at a time. Returns false if there was no message to deliver.
+ *
+ * @param[inout] office Target post office.
+ * @param[inout] alloc Allocator used to release the message.
+ * @return bool
+ */
+bool message_post_office_deliver(message_post_office *office, allocator alloc)
+{
+    message_mailbox *served = nullptr;
+    message *delivered = nullptr;
+
+    if (!office || !office->first_pending) {
+        return false;
+    }
+
+    served = office->first_pending;
+    delivered = served->first;
+
+    served->first = delivered->next;
+    if (!served->first) {
+        served->last = nullptr;
+    }
+    office->length -= 1u;
+
+    message_post_office_unlink(office, served);
+    if (served->first) {
+        message_post_office_link(office, served);
+    }
+
+    basilisk_engine_entity_send_message(served->owner, delivered->message_id, (delivered->data_size > 0u) ? delivered->data : nullptr);
+
+    alloc.free(alloc, delivered);
+
+    return true;
+}
+
+/**
+ * @brief Destroys all messages of a mailbox, including the ones still in the inbox of the post office, and stops
+ * serving it. Used when the entity owning the mailbox is removed.
+ *
+ * @param[inout] office Post office serving the mailbox.
+ * @param[inout] mailbox Target mailbox.
+ * @param[inout] alloc Allocator used to release the messages.
+ */
+void message_post_office_discard(message_post_office *office, message_mailbox *mailbox, allocator alloc)
+{
+    message *next = nullptr;
+
+    if (!office || !mailbox) {
+        return;
+    }
+
+    message_post_office_drain_inbox(office, alloc);
+
+    if (mailbox->first) {
+        message_post_office_unlink(office, mailbox);
+    }
+
+    while (mailbox->first) {
+        next = mailbox->first->next;
+        alloc.free(alloc, mailbox->first);
+        mailbox->first = next;
+        office->length -= 1u;
+    }
+
+    mailbox->last = nullptr;
+}
+
+/**
+ * @brief Returns the number of messages waiting in all mailboxes served by the post office.
+ *
+ * @param[in] office Examined post office.
+ * @return size_t
+ */
+size_t message_post_office_length(const message_post_office *office)
+{
+    if (!office) {
+        return 0u;
+    }
+
+    return office->length;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates a message in a single block with a copy of its data.
+ *
+ * @param[in] message_id User-defined identifier of the message.
+ * @param[in] data Data (copied) carried by the message. Might be nullptr.
+ * @param[in] data_size Number of bytes of data.
+ * @param[inout] alloc Allocator used for the creation.
+ * @return message *
+ */
+static message *message_create(unsigned long message_id, const void *data, size_t data_size, allocator alloc)
+{
+    message *new_message = nullptr;
+
+    if (!data) {
+        data_size = 0u;
+    }
+
+    new_message = alloc.malloc(alloc, sizeof(*new_message) + data_size);
+
+    if (new_message) {
+        *new_message = (message) {
+                .next = nullptr,
+                .message_id = message_id,
+                .data_size = data_size,
+        };
+
+        if (data_size > 0u) {
+            bytewise_copy(new_message->data, data, data_size);
+        }
+    }
+
+    return new_message;
+}
+
+/**
+ * @brief Appends a message at the end of a mailbox. A mailbox that was empty is queued at the end of the mailboxes
+ * to serve.
+ *
+ * @param[inout] office Post office serving the mailbox.
+ * @param[inout] target Mailbox receiving the message.
+ * @param[in] sent Message (moved) to append.
+ */
+static void message_post_office_put(message_post_office *office, message_mailbox *target, message *sent)
+{
+    if (target->last) {
+        target->last->next = sent;
+    } else {
+        target->first = sent;
+        message_post_office_link(office, target);
+    }
+
+    target->last = sent;
+    office->length += 1u;
+}
+
+/**
+ * @brief Removes a mailbox from the list of mailboxes to serve.
+ *
+ * @param[inout] office Target post office.
+ * @param[inout] mailbox Mailbox trusted to be in the list.
+ */
+static void message_post_office_unlink(message_post_office *office, message_mailbox *mailbox)
+{
+    if (mailbox->previous_pending) {
+        mailbox->previous_pending->next_pending = mailbox->next_pending;
+    } else {
+        office->first_pending = mailbox->next_pending;
+    }
+
+    if (mailbox->next_pending) {
+        mailbox->next_pending->previous_pending = mailbox->previous_pending;
+    } else {
+        office->last_pending = mailbox->previous_pending;
+    }
+
+    mailbox->previous_pending = nullptr;
+    mailbox->next_pending = nullptr;
+}
+
+/**
+ * @brief Adds a mailbox at the end of the list of mailboxes to serve.
+ *
+ * @param[inout] office Target post office.
+ * @param[inout] mailbox Mailbox trusted not to be in the list.
+ */
+static void message_post_office_link(message_post_office *office, message_mailbox *mailbox)
+{
+    mailbox->previous_pending = office->last_pending;
+    mailbox->next_pending = nullptr;
+
+    if (office->last_pending) {
+        office->last_pending->next_pending = mailbox;
+    } else {
+        office->first_pending = mailbox;
+    }
+
+    office->last_pending = mailbox;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file basilisk_message.h
+ * @author gabriel ()
+ * @brief Send messages directly from an entity to another, without going through the event broker.
+ *
+ * Each entity owns a mailbox. Mailboxes holding messages are linked in a post office, which delivers the messages
+ * during the event phase : sending and delivering a message are both done in constant time.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef __MESSAGE_H__
+#define __MESSAGE_H__
+
+#include "../basilisk_common.h"
+#include "../entity/basilisk_entity.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Opaque type to a message waiting in a mailbox. */
+typedef struct message message;
+
+/* Opaque type to an object delivering the messages of all mailboxes. */
+typedef struct message_post_office message_post_office;
+
+/**
+ * @brief Messages sent to an entity and not yet delivered. A mailbox holding messages is linked to the other mailboxes
+ * waiting for the post office.
+ */
+typedef struct message_mailbox {
+    /** Entity receiving the messages. */
+    basilisk_engine_entity *owner;
+
+    /** Oldest message of the mailbox, delivered first. */
+    message *first;
+    /** Newest message of the mailbox. */
+    message *last;
+
+    /** Mailbox served before this one by the post office. */
+    struct message_mailbox *previous_pending;
+    /** Mailbox served after this one by the post office. */
+    struct message_mailbox *next_pending;
+} message_mailbox;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Creates an empty mailbox for an entity. */
+message_mailbox message_mailbox_create(basilisk_engine_entity *owner);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Allocates a post office and returns a pointer to it. */
+message_post_office *message_post_office_create(allocator alloc);
+
+/* Releases memory taken by a post office and the messages of all mailboxes, and nullifies the pointer passed. */
+void message_post_office_destroy(message_post_office **office, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Puts a message in a mailbox. */
+void message_post_office_send(message_post_office *office, message_mailbox *target, unsigned long message_id, const void *data, size_t data_size, allocator alloc);
+
+/* Puts a message in the inbox of the post office, from any thread. */
+void message_post_office_send_threadsafe(message_post_office *office, message_mailbox *target, unsigned long message_id, const void *data, size_t data_size, allocator alloc);
+
+/* Moves the messages received in the inbox of the post office to their mailbox. */
+void message_post_office_drain_inbox(message_post_office *office, allocator alloc);
+
+/* Delivers the next message to the entity owning its mailbox. */
+bool message_post_office_deliver(message_post_office *office, allocator alloc);
+
+/* Destroys the messages of a mailbox and stops serving it. */
+void message_post_office_discard(message_post_office *office, message_mailbox *mailbox, allocator alloc);
+
+/* Returns the number of messages waiting to be delivered. */
+size_t message_post_office_length(const message_post_office *office);
+
+#endif
@@ -0,0 +1,435 @@
+/**
+ * @file basilisk_recorder.c
+ * @author gabriel ()
+ * @brief Implementation file for the recording and replay of sessions.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "basilisk_recorder.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/// Bytes starting a recording file.
+#define RECORDER_MAGIC ("BSKR")
+/// Version of the layout of the recording file.
+#define RECORDER_VERSION (2u)
+
+/**
+ * @brief Kinds of records found in a recording file, each written as a leading byte.
+ */
+typedef enum recorder_record_tag {
+    RECORDER_RECORD_FRAME = 'F',        /// start of a frame, followed by its duration
+    RECORDER_RECORD_EVENT = 'E',        /// input event stacked during or after the frame, followed by its name, scope, properties and data
+    RECORDER_RECORD_RECEIVED_EVENT = 'R', /// input event received from another thread, with the same layout
+    RECORDER_RECORD_COMMANDS = 'C',     /// end of a frame, followed by the number of commands it processed
+} recorder_record_tag;
+
+/**
+ * @brief Recording file opened for writing or reading.
+ */
+typedef struct recorder {
+    /** Opened recording file. */
+    FILE *file;
+    /** If set, the file is read to replay a session. */
+    bool is_replaying;
+} recorder;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Reads the tag of the next record if it is the expected one. */
+static bool recorder_read_tag(recorder *rec, recorder_record_tag expected_tag);
+
+/* Writes a string preceded by its length. */
+static void recorder_write_string(recorder *rec, const char *str);
+
+/* Reads a string preceded by its length. */
+static bool recorder_read_string(recorder *rec, identifier **out_str, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Opens a recording file. A new recording overwrites the file and starts with a header ; a replayed recording
+ * must start with a header of the same version.
+ *
+ * @param[in] str_path Path to the recording file.
+ * @param[in] is_replaying If set, the file is read instead of written.
+ * @param[inout] alloc Allocator used for the creation.
+ * @return recorder *
+ */
+recorder *recorder_create(const char *str_path, bool is_replaying, allocator alloc)
+{
+    recorder *new_rec = nullptr;
+    FILE *file = nullptr;
+    char magic[sizeof(RECORDER_MAGIC)] = { 0u };
+    u32 version = RECORDER_VERSION;
+
+    if (!str_path) {
+        return nullptr;
+    }
+
+    file = fopen(str_path, (is_replaying) ? "rb" : "wb");
+    if (!file) {
+        return nullptr;
+    }
+
+    if (is_replaying) {
+        if ((fread(magic, sizeof(magic), 1u, file) != 1u) || (fread(&version, sizeof(version), 1u, file) != 1u)
+                || (strcmp(magic, RECORDER_MAGIC) != 0) || (version != RECORDER_VERSION)) {
+            fclose(file);
+            return nullptr;
+        }
+    } else {
+        (void) fwrite(RECORDER_MAGIC, sizeof(RECORDER_MAGIC), 1u, file);
+        (void) fwrite(&version, sizeof(version), 1u, file);
+    }
+
+    new_rec = alloc.malloc(alloc, sizeof(*new_rec));
+    if (new_rec) {
+        *new_rec = (recorder) {
+                .file = file,
+                .is_replaying = is_replaying,
+        };
+    } else {
+        fclose(file);
+    }
+
+    return new_rec;
+}
+
+/**
+ * @brief Closes a recording file, flushing what was written, and nullifies the pointer passed.
+ *
+ * @param[inout] rec Object to destroy.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void recorder_destroy(recorder **rec, allocator alloc)
+{
+    if (!rec || !*rec) {
+        return;
+    }
+
+    fclose((*rec)->file);
+
+    alloc.free(alloc, *rec);
+    *rec = nullptr;
+}
+
+/**
+ * @brief Checks if a recording is read to replay a session, instead of written.
+ *
+ * @param[in] rec Examined recorder.
+ * @return bool
+ */
+bool recorder_is_replaying(const recorder *rec)
+{
+    if (!rec) {
+        return false;
+    }
+
+    return rec->is_replaying;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Writes the start of a frame and the duration given to it.
+ *
+ * @param[inout] rec Recorder writing a session.
+ * @param[in] frame_ms Duration of the frame, in milliseconds.
+ */
+void recorder_write_frame(recorder *rec, f64 frame_ms)
+{
+    if (!rec || rec->is_replaying) {
+        return;
+    }
+
+    (void) fputc(RECORDER_RECORD_FRAME, rec->file);
+    (void) fwrite(&frame_ms, sizeof(frame_ms), 1u, rec->file);
+}
+
+/**
+ * @brief Writes an input event of the current frame : its name, the path of its scope, its properties and data. Events
+ * received from other threads are written apart from the ones stacked during the frame, since they reach the stack at
+ * another point of the frame.
+ *
+ * @param[inout] rec Recorder writing a session.
+ * @param[in] is_received If set, the event was received from another thread at the start of the frame.
+ * @param[in] str_event_name Name of the event.
+ * @param[in] str_scope_path Path from the root entity to the root of the event's scope, or nullptr for a global event.
+ * @param[in] event_data Properties and data of the event.
+ */
+void recorder_write_event(recorder *rec, bool is_received, const char *str_event_name, const char *str_scope_path, basilisk_specific_event event_data)
+{
+    i32 priority = (i32) event_data.priority;
+    u8 is_deferred = (u8) event_data.is_deferred;
+    u64 delay_ms = (u64) event_data.delay_ms;
+    u64 data_size = (event_data.data) ? (u64) event_data.data_size : 0u;
+
+    if (!rec || rec->is_replaying || !str_event_name) {
+        return;
+    }
+
+    (void) fputc((is_received) ? RECORDER_RECORD_RECEIVED_EVENT : RECORDER_RECORD_EVENT, rec->file);
+    recorder_write_string(rec, str_event_name);
+    recorder_write_string(rec, (str_scope_path) ? str_scope_path : "");
+    (void) fwrite(&priority, sizeof(priority), 1u, rec->file);
+    (void) fwrite(&is_deferred, sizeof(is_deferred), 1u, rec->file);
+    (void) fwrite(&delay_ms, sizeof(delay_ms), 1u, rec->file);
+    (void) fwrite(&data_size, sizeof(data_size), 1u, rec->file);
+    if (data_size > 0u) {
+        (void) fwrite(event_data.data, 1u, (size_t) data_size, rec->file);
+    }
+}
+
+/**
+ * @brief Writes the number of commands processed during the current frame, which closes the frame.
+ *
+ * @param[inout] rec Recorder writing a session.
+ * @param[in] commands_count Number of commands processed.
+ */
+void recorder_write_commands(recorder *rec, size_t commands_count)
+{
+    u64 count = (u64) commands_count;
+
+    if (!rec || rec->is_replaying) {
+        return;
+    }
+
+    (void) fputc(RECORDER_RECORD_COMMANDS, rec->file);
+    (void) fwrite(&count, sizeof(count), 1u, rec->file);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Reads the start of the next frame and the duration given to it. Returns false at the end of the recording.
+ *
+ * @param[inout] rec Recorder replaying a session.
+ * @param[out] out_frame_ms Duration of the frame, in milliseconds.
+ * @return bool
+ */
+bool recorder_read_frame(recorder *rec, f64 *out_frame_ms)
+{
+    if (!rec || !rec->is_replaying || !out_frame_ms || !recorder_read_tag(rec, RECORDER_RECORD_FRAME)) {
+        return false;
+    }
+
+    return fread(out_frame_ms, sizeof(*out_frame_ms), 1u, rec->file) == 1u;
+}
+
+/**
+ * @brief Reads the next input event of the current frame, among the events received from other threads or the events
+ * stacked during the frame. Returns false once all such events of the frame were read, or if the event could not be
+ * read. The name, scope path and data read are allocated and owned by the caller.
+ *
+ * @param[inout] rec Recorder replaying a session.
+ * @param[in] is_received If set, the events received from other threads are read.
+ * @param[out] out_event_name Name of the event.
+ * @param[out] out_scope_path Path from the root entity to the root of the event's scope, nullptr for a global event.
+ * @param[out] out_event_data Properties and data of the event.
+ * @param[inout] alloc Allocator used for the name, scope path and data.
+ * @return bool
+ */
+bool recorder_read_event(recorder *rec, bool is_received, identifier **out_event_name, identifier **out_scope_path, basilisk_specific_event *out_event_data, allocator alloc)
+{
+    i32 priority = 0;
+    u8 is_deferred = 0u;
+    u64 delay_ms = 0u;
+    u64 data_size = 0u;
+    identifier *event_name = nullptr;
+    identifier *scope_path = nullptr;
+    void *data = nullptr;
+
+    if (!rec || !rec->is_replaying || !out_event_name || !out_scope_path || !out_event_data
+            || !recorder_read_tag(rec, (is_received) ? RECORDER_RECORD_RECEIVED_EVENT : RECORDER_RECORD_EVENT)) {
+        return false;
+    }
+
+    if (!recorder_read_string(rec, &event_name, alloc)) {
+        return false;
+    }
+
+    if (!recorder_read_string(rec, &scope_path, alloc)
+            || (fread(&priority, sizeof(priority), 1u, rec->file) != 1u)
+            || (fread(&is_deferred, sizeof(is_deferred), 1u, rec->file) != 1u)
+            || (fread(&delay_ms, sizeof(delay_ms), 1u, rec->file) != 1u)
+            || (fread(&data_size, sizeof(data_size), 1u, rec->file) != 1u)) {
+        range_destroy_dynamic(alloc, &RANGE_TO_ANY(event_name));
+        if (scope_path) {
+            range_destroy_dynamic(alloc, &RANGE_TO_ANY(scope_path));
+        }
+        return false;
+    }
+
+    if (data_size > 0u) {
+        data = alloc.malloc(alloc, (size_t) data_size);
+        if (!data || (fread(data, 1u, (size_t) data_size, rec->file) != (size_t) data_size)) {
+            if (data) {
+                alloc.free(alloc, data);
+            }
+            range_destroy_dynamic(alloc, &RANGE_TO_ANY(event_name));
+            range_destroy_dynamic(alloc, &RANGE_TO_ANY(scope_path));
+            return false;
+        }
+    }
+
+    // an empty scope path stands for a global event
+    if (scope_path->length <= 1u) {
+        range_destroy_dynamic(alloc, &RANGE_TO_ANY(scope_path));
+        scope_path = nullptr;
+    }
+
+    *out_event_name = event_name;
+    *out_scope_path = scope_path;
+    *out_event_data = (basilisk_specific_event) {
+            .is_detached = true,
+            .is_deferred = (is_deferred != 0u),
+            .priority = (int) priority,
+            .delay_ms = (unsigned long) delay_ms,
+            .data_size = (unsigned long) data_size,
+            .data = data,
+    };
+
+    return true;
+}
+
+/**
+ * @brief Reads the number of commands processed during the current frame of the original session, which closes the
+ * frame.
+ *
+ * @param[inout] rec Recorder replaying a session.
+ * @param[out] out_commands_count Number of commands processed.
+ * @return bool
+ */
+bool recorder_read_commands(recorder *rec, size_t *out_commands_count)
+{
+    u64 count = 0u;
+
+    if (!rec || !rec->is_replaying || !out_commands_count || !recorder_read_tag(rec, RECORDER_RECORD_COMMANDS)) {
+        return false;
+    }
+
+    if (fread(&count, sizeof(count), 1u, rec->file) != 1u) {
+        return false;
+    }
+
+    *out_commands_count = (size_t) count;
+
+    return true;
+}
+
+/**
+ * @brief Checks if a replayed recording was read up to its end. Reading functions also return false on a record they
+ * do not expect : a recording whose next record is left unread after the replay is damaged, or was written by another
+ * version of the engine.
+ *
+ * @param[inout] rec Recorder replaying a session.
+ * @return bool
+ */
+bool recorder_is_at_end(recorder *rec)
+{
+    int tag = EOF;
+
+    if (!rec || !rec->is_replaying) {
+        return true;
+    }
+
+    tag = fgetc(rec->file);
+    if (tag == EOF) {
+        return true;
+    }
+
+    (void) ungetc(tag, rec->file);
+
+    return false;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Reads the tag of the next record and returns true if it is the expected one. Otherwise, the tag is left in
+ * the file for the next read.
+ *
+ * @param[inout] rec Recorder replaying a session.
+ * @param[in] expected_tag Kind of record expected.
+ * @return bool
+ */
+static bool recorder_read_tag(recorder *rec, recorder_record_tag expected_tag)
+{
+    int tag = fgetc(rec->file);
+
+    if (tag == EOF) {
+        return false;
+    }
+
+    if (tag != (int) expected_tag) {
+        (void) ungetc(tag, rec->file);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Writes a string, without its terminating '\0', preceded by its length.
+ *
+ * @param[inout] rec Recorder writing a session.
+ * @param[in] str Null-terminated string.
+ */
+static void recorder_write_string(recorder *rec, const char *str)
+{
+    u32 length = (u32) strlen(str);
+
+    (void) fwrite(&length, sizeof(length), 1u, rec->file);
+    (void) fwrite(str, 1u, length, rec->file);
+}
+
+/**
+ * @brief Reads a string preceded by its length into a new identifier. Returns false if the string could not be
+ * allocated or read, in which case nothing is left to release.
+ *
+ * @param[inout] rec Recorder replaying a session.
+ * @param[out] out_str Outgoing identifier, owned by the caller.
+ * @param[inout] alloc Allocator used for the identifier.
+ * @return bool
+ */
+static bool recorder_read_string(recorder *rec, identifier **out_str, allocator alloc)
+{
+    u32 length = 0u;
+    identifier *str = nullptr;
+
+    if (fread(&length, sizeof(length), 1u, rec->file) != 1u) {
+        return false;
+    }
+
+    str = range_create_dynamic(alloc, sizeof(*str->data), (size_t) length + 1u);
+    if (!str) {
+        return false;
+    }
+
+    if (fread(str->data, 1u, length, rec->file) != length) {
+        range_destroy_dynamic(alloc, &RANGE_TO_ANY(str));
+        return false;
+    }
+
+    str->data[length] = '\0';
+    str->length = (size_t) length + 1u;
+
+    *out_str = str;
+    return true;
+}
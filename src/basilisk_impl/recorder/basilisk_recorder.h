@@ -0,0 +1,67 @@
+/**
+ * @file basilisk_recorder.h
+ * @author gabriel ()
+ * @brief Record what comes into the engine from the outside world to a binary file, and read it back to replay a
+ * session.
+ *
+ * A recording is a header followed by one block per frame : the frame duration, the input events received from other
+ * threads, the input events stacked during the frame, and the number of commands processed by the frame. Input events
+ * stacked between two frames, by idle tasks for instance, follow the block of the first frame.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef __RECORDER_H__
+#define __RECORDER_H__
+
+#include "../basilisk_common.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Opaque type to a recording file opened for writing or reading. */
+typedef struct recorder recorder;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Opens a recording file, to write a new recording or to replay an existing one. */
+recorder *recorder_create(const char *str_path, bool is_replaying, allocator alloc);
+
+/* Closes a recording file and nullifies the pointer passed. */
+void recorder_destroy(recorder **rec, allocator alloc);
+
+/* Checks if a recording is read instead of written. */
+bool recorder_is_replaying(const recorder *rec);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Writes the start of a frame. */
+void recorder_write_frame(recorder *rec, f64 frame_ms);
+
+/* Writes an input event stacked during the current frame, or received from another thread. */
+void recorder_write_event(recorder *rec, bool is_received, const char *str_event_name, const char *str_scope_path, basilisk_specific_event event_data);
+
+/* Writes the number of commands processed by the current frame, closing it. */
+void recorder_write_commands(recorder *rec, size_t commands_count);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Reads the start of the next frame. */
+bool recorder_read_frame(recorder *rec, f64 *out_frame_ms);
+
+/* Reads the next input event of the current frame stacked during the frame, or received from another thread. */
+bool recorder_read_event(recorder *rec, bool is_received, identifier **out_event_name, identifier **out_scope_path, basilisk_specific_event *out_event_data, allocator alloc);
+
+/* Reads the number of commands processed by the current frame. */
+bool recorder_read_commands(recorder *rec, size_t *out_commands_count);
+
+/* Checks if a replayed recording was read up to its end. */
+bool recorder_is_at_end(recorder *rec);
+
+#endif
@@ -109,17 +109,34 @@ bool resource_manager_touch(resource_manager *res_manager, const char *str_stora
     return resource_storage_check(res_manager->storages->data[found_storage_index], str_res_path, alloc);
 }
 
+/**
+ * @brief Reads all resources of a storage file in memory, without going through the storage object : the function can
+ * be called from any thread. See `resource_storage_prefetch()`.
+ *
+ * @param[in] str_storage_path Path to the storage file.
+ * @param[in] on_progress Function (can be null) called after each prefetched resource.
+ * @param[inout] context Pointer passed to the progress function.
+ * @return bool false if the storage file could not be read.
+ */
+bool resource_manager_prefetch(const char *str_storage_path, void (*on_progress)(void *context, size_t prefetched_count, size_t resources_count), void *context)
+{
+    return resource_storage_prefetch(str_storage_path, on_progress, context);
+}
+
 /**
  * @brief Returns a resource from a storage, provided it exists and was loaded (see `resource_manager_add_supplicant()` and
- * `resource_manager_remove_supplicant()`).
+ * `resource_manager_remove_supplicant()`). The entity is marked as holding the resource until it releases it (see
+ * `resource_manager_release()`) or stops using the storage.
  *
  * @param[in] res_manager Resource storage managing the storage and resource.
  * @param[in] str_storage_path Path to the storage file containing the resource.
  * @param[in] str_res_path Path to the resource file.
+ * @param[in] entity Entity holding the resource.
  * @param[out] out_size Outgoing value, containing the number of bytes the function returned.
- * @return void *
+ * @param[inout] alloc Allocator used to register the holder.
+ * @return const void *
  */
-void *resource_manager_fetch(resource_manager *res_manager, const char *str_storage_path, const char *str_res_path, size_t *out_size)
+const void *resource_manager_fetch(resource_manager *res_manager, const char *str_storage_path, const char *str_res_path, basilisk_entity *entity, size_t *out_size, allocator alloc)
 {
     size_t found_storage_index = 0u;
     u32 storage_name_hash = 0u;
@@ -131,12 +148,38 @@ void *resource_manager_fetch(resource_manager *res_manager, const char *str_stor
     storage_name_hash = hash_jenkins_one_at_a_time((const byte *) str_storage_path, c_string_length(str_storage_path, false), 0u);
 
     if (sorted_range_find_in(RANGE_TO_ANY(res_manager->storages), &hash_compare_doubleref, &(u32 *) { &storage_name_hash }, &found_storage_index)) {
-        return resource_storage_get(res_manager->storages->data[found_storage_index], str_res_path, out_size);
+        return resource_storage_acquire(res_manager->storages->data[found_storage_index], str_res_path, entity, out_size, alloc);
     }
 
     return nullptr;
 }
 
+/**
+ * @brief Marks an entity as no longer holding a resource it fetched. The resource is unmapped if no other entity holds
+ * it, while the other resources of its storage stay available.
+ *
+ * @param[in] res_manager Resource storage managing the storage and resource.
+ * @param[in] str_storage_path Path to the storage file containing the resource.
+ * @param[in] str_res_path Path to the resource file.
+ * @param[in] entity Entity releasing the resource.
+ * @param[inout] alloc Allocator used to forget the holder.
+ */
+void resource_manager_release(resource_manager *res_manager, const char *str_storage_path, const char *str_res_path, basilisk_entity *entity, allocator alloc)
+{
+    size_t found_storage_index = 0u;
+    u32 storage_name_hash = 0u;
+
+    if (!res_manager || !str_res_path || !str_storage_path) {
+        return;
+    }
+
+    storage_name_hash = hash_jenkins_one_at_a_time((const byte *) str_storage_path, c_string_length(str_storage_path, false), 0u);
+
+    if (sorted_range_find_in(RANGE_TO_ANY(res_manager->storages), &hash_compare_doubleref, &(u32 *) { &storage_name_hash }, &found_storage_index)) {
+        resource_storage_release(res_manager->storages->data[found_storage_index], str_res_path, entity, alloc);
+    }
+}
+
 /**
  * @brief Adds an entity as using a storage. If the storage was previously unloaded, it will be loaded to provide this
  * new supplicant with the resources it might want.
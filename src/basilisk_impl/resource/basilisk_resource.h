@@ -38,13 +38,19 @@ void resource_manager_destroy(resource_manager **res_manager, allocator alloc);
 /* Checks that a resource is accessible in a storage file, and creates a spot for it to be loaded and unloaded. */
 bool resource_manager_touch(resource_manager *res_manager, const char *str_storage_path, const char *str_res_path, allocator alloc);
 
-/* Tries to get a resource from a storage file and returns it. The resource needs to exist and its storage needs to have at least one supplicant (to be loaded). */
-void *resource_manager_fetch(resource_manager *res_manager, const char *str_storage_path, const char *str_res_path, size_t *out_size);
+/* Reads all resources of a storage file in memory so that fetching them does not wait for the disk. Can be called from any thread. */
+bool resource_manager_prefetch(const char *str_storage_path, void (*on_progress)(void *context, size_t prefetched_count, size_t resources_count), void *context);
+
+/* Tries to get a resource from a storage file and returns it, marking an entity as holding it. The resource needs to exist and its storage needs to have at least one supplicant (to be loaded). */
+const void *resource_manager_fetch(resource_manager *res_manager, const char *str_storage_path, const char *str_res_path, basilisk_entity *entity, size_t *out_size, allocator alloc);
+
+/* Marks an entity as no longer holding a resource. If it was the last holder, the resource is unmapped. */
+void resource_manager_release(resource_manager *res_manager, const char *str_storage_path, const char *str_res_path, basilisk_entity *entity, allocator alloc);
 
 /* Registers an entity as using a storage, adding it as a supplicant to the storage. If it is the first supplicant, the storage is loaded. */
 void resource_manager_add_supplicant(resource_manager *res_manager, const char *str_storage_path, basilisk_entity *entity, allocator alloc);
 
-/* Removes an entity as using a storage. If it was the last supplicant, the storage is unloaded. */
+/* Removes an entity as using a storage, releasing the resources it holds. If it was the last supplicant, the storage is unloaded. */
 void resource_manager_remove_supplicant(resource_manager *res_manager, basilisk_entity *entity, allocator alloc);
 
 // -------------------------------------------------------------------------------------------------
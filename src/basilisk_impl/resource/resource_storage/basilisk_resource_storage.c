@@ -12,11 +12,25 @@
 
 #include <ustd/sorting.h>
 
+#include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "basilisk_resource_storage.h"
 
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/// Characters at the start of all storage files.
+#define STORAGE_FILE_MAGIC "BSKS"
+/// Version of the storage file layout, changed each time the layout changes.
+#define STORAGE_FILE_VERSION (3u)
+/// Alignment of the resources and of the table of contents in a storage file.
+#define STORAGE_FILE_ALIGNMENT (16u)
 
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -28,18 +42,50 @@
  */
 typedef RANGE(byte) file_data_array;
 
+/**
+ * @brief Header found at the start of a storage file.
+ */
+typedef struct storage_file_header {
+    /** Always STORAGE_FILE_MAGIC, without its null terminator. */
+    char magic[4u];
+    /** Version of the layout of the file. */
+    u32 version;
+} storage_file_header;
+
+/**
+ * @brief Footer found at the end of a storage file, locating its table of contents.
+ */
+typedef struct storage_file_footer {
+    /** Position of the table of contents in the file, in bytes. */
+    u64 toc_offset;
+    /** Number of entries in the table of contents. */
+    u64 toc_length;
+} storage_file_footer;
+
 /**
  * @brief Resource header presenting information about a resource in a storage file.
- * This layout can be found directly in the storage file and is also used in the program memory.
- * Needs to subtype the `u32` type for ordering.
+ * This layout can be found directly in the table of contents of the storage file, sorted by hash, and is also used in
+ * the program memory. Needs to subtype the `u32` type for ordering.
  */
 typedef struct resource_item_header {
     /** Hash of the path that led to the original resource file and used to access a resource from user code. */
     u32 str_path_hash;
+    /** Flags of the resource, reserved for later layouts. Always zero. */
+    u32 flags;
+    /** Position of the resource in the storage file, in bytes. */
+    u64 offset;
     /** Size of the resource, in bytes. */
-    size_t data_size;
+    u64 data_size;
+    /** Last modification time of the resource file when it was written to the storage file, in seconds. */
+    i64 source_mtime;
 } resource_item_header;
 
+/**
+ * @typedef storage_file_toc
+ * @brief Table of contents of a storage file, read in memory.
+ */
+typedef RANGE(resource_item_header) storage_file_toc;
+
 /**
  * @brief Describes a codebase-exclusive data layout for a resource found in a file.
  */
@@ -47,8 +93,14 @@ typedef struct resource_item_deserialized {
     /** Resource information pulled from the storage file. */
     resource_item_header header;
 
-    /** Pointer to some allocated memory containing the resource's bytes. */
-    void *data;
+    /** Pointer to the resource's bytes in its mapping, or nullptr while the resource is not mapped. */
+    const void *data;
+    /** Read-only mapping of the pages of the storage file holding the resource, or nullptr. */
+    void *mapping;
+    /** Number of bytes of the mapping. */
+    size_t mapping_size;
+    /** Entities holding the resource while it is mapped, ordered by address, or nullptr. */
+    RANGE(basilisk_entity *) *holders;
 } resource_item_deserialized;
 
 /**
@@ -65,6 +117,8 @@ typedef struct resource_storage {
     const char *file_path; // TODO (low prio, all code paths require static strings) : use an identifier or path or RANGE(char)
     /** Collection of resources, ordered by their hash. */
     RANGE(resource_item_deserialized) *items;
+    /** Storage file kept open while the storage is loaded, to map resources from it, or -1. */
+    int file_descriptor;
 
     /** Collection of entities that are using the resources of this storage. */
     RANGE(basilisk_entity *) *supplicants;
@@ -83,8 +137,41 @@ static void resource_storage_load(resource_storage *storage, allocator alloc);
 /* De-allocates memory used to store resources, removing resources data from the object. */
 static void resource_storage_unload(resource_storage *storage, allocator alloc);
 
-/* Copies the contents of a file at the end of a resource storage file. */
-static bool storage_file_append(const char *storage_file_path, const char *res_path, allocator alloc);
+/* Maps the pages of a storage file holding a single resource. */
+static bool resource_item_map(resource_item_deserialized *item, int storage_fd, allocator alloc);
+
+/* Unmaps a resource and forgets its holders. */
+static void resource_item_unmap(resource_item_deserialized *item, allocator alloc);
+
+/* Removes an entity from the holders of a resource, unmapping the resource if it was the last one. */
+static void resource_item_release(resource_item_deserialized *item, basilisk_entity *entity, allocator alloc);
+
+/* Maps a storage file read-only in memory. */
+static void *storage_file_map(const char *storage_file_path, size_t *out_mapping_size);
+
+/* Checks the header of a mapped storage file and returns its footer. */
+static storage_file_footer storage_mapping_footer(const void *mapping, size_t mapping_size);
+
+/* Writes an empty storage file, with a header and an empty table of contents. */
+static bool storage_file_initialize(const char *storage_file_path);
+
+/* Checks the header of an opened storage file and reads its footer. */
+static bool storage_file_read_footer(FILE *storage_file, storage_file_footer *out_footer);
+
+/* Searches the table of contents of an opened storage file for a resource. */
+static bool storage_file_find(FILE *storage_file, storage_file_footer footer, u32 str_path_hash, resource_item_header *out_header);
+
+/* Reads the table of contents of an opened storage file. */
+static storage_file_toc *storage_file_read_toc(FILE *storage_file, storage_file_footer footer, allocator alloc);
+
+/* Writes zeroes to a storage file up to the next aligned position. */
+static u64 storage_file_pad(FILE *storage_file, u64 position);
+
+/* Writes the contents of a file to a resource storage file, unless it did not change since it was last written. */
+static bool storage_file_update(const char *storage_file_path, const char *res_path, allocator alloc);
+
+/* Rewrites a storage file without the resources replaced since it was written. */
+static bool storage_file_compact(const char *storage_file_path, allocator alloc);
 
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -93,7 +180,8 @@ static bool storage_file_append(const char *storage_file_path, const char *res_p
 /**
  * @brief Creates a data storage object meant to load, store, service and release resources present in a single storage file.
  * In nominal (development -- with no compilation switch) mode, calling this function will not only create the object, but also
- * create or empty the given storage file. On failure to do this, the function will abort the object creation, and will return nullptr.
+ * create the given storage file with a header and an empty table of contents, unless a storage file of the current layout
+ * version already exists there : it is then kept, so that unchanged resources are not written again. On failure to do this, the function will abort the object creation, and will return nullptr.
  * With BASILISK_RELEASE set, this function will just check that the given file can be opened in read mode. On failure, the
  * object will not be created and the function will return nullptr.
  *
@@ -113,16 +201,27 @@ resource_storage *resource_storage_create(const char *str_storage_path, allocato
     }
 
 #ifndef BASILISK_RELEASE
+    storage_file_footer footer = { 0u };
+    bool is_valid = false;
+
     (void) mkdir(BASILISK_RESOURCE_STORAGES_FOLDER, S_IRWXU);
-    storage_file = fopen(str_storage_path, "w");
-#else
-    storage_file = fopen(str_storage_path, "r");
-#endif
 
+    storage_file = fopen(str_storage_path, "rb");
+    if (storage_file) {
+        is_valid = storage_file_read_footer(storage_file, &footer);
+        fclose(storage_file);
+    }
+
+    if (!is_valid && !storage_file_initialize(str_storage_path)) {
+        return nullptr;
+    }
+#else
+    storage_file = fopen(str_storage_path, "rb");
     if (!storage_file) {
         return nullptr;
     }
     fclose(storage_file);
+#endif
 
     new_storage = alloc.malloc(alloc, sizeof(*new_storage));
     if (new_storage) {
@@ -130,6 +229,7 @@ resource_storage *resource_storage_create(const char *str_storage_path, allocato
         *new_storage = (resource_storage) {
                 .storage_name_hash = hash_jenkins_one_at_a_time((const byte *) str_storage_path, c_string_length(str_storage_path, false), 0u),
                 .file_path = str_storage_path,
+                .file_descriptor = -1,
                 .items = range_create_dynamic(alloc, sizeof(*new_storage->items->data), BASILISK_COLLECTIONS_START_LENGTH),
                 .supplicants = range_create_dynamic(alloc, sizeof(*new_storage->supplicants->data), BASILISK_COLLECTIONS_START_LENGTH),
         };
@@ -164,9 +264,11 @@ void resource_storage_destroy(resource_storage **storage_data, allocator alloc)
 
 /**
  * @brief Checks that a resource (by its path) exists in a storage file.
- * In nominal (development -- with no compilation switch) mode, this function will try to load the file present at the given path
- * and append it to the storage file associated to the storage object. With BASILISK_RELEASE set, this step is skipped.
+ * In nominal (development -- with no compilation switch) mode, this function will write the file present at the given path
+ * to the storage file associated to the storage object, if its size or modification time changed since it was last
+ * written there. With BASILISK_RELEASE set, this step is skipped.
  * Then, the function will check that the resource is present in the storage file and return true if it finds it and false if not.
+ * The resource is searched by a binary search in the table of contents of the file, without reading the resources.
  *
  * @param[inout] storage_data Storage object.
  * @param[in] str_path Path to the resource used to either update or identify the checked resource.
@@ -176,7 +278,7 @@ void resource_storage_destroy(resource_storage **storage_data, allocator alloc)
 bool resource_storage_check(resource_storage *storage_data, const char *str_path, allocator alloc)
 {
     FILE *storage_file = nullptr;
-    resource_item_header item_header = { 0u };
+    storage_file_footer footer = { 0u };
     u32 str_path_hash = 0u;
     bool found = false;
 
@@ -185,23 +287,19 @@ bool resource_storage_check(resource_storage *storage_data, const char *str_path
     }
 
 #ifndef BASILISK_RELEASE
-    if (!storage_file_append(storage_data->file_path, str_path, alloc)) {
+    if (!storage_file_update(storage_data->file_path, str_path, alloc)) {
         return false;
     }
 #endif
 
     str_path_hash = hash_jenkins_one_at_a_time((const byte *) str_path, c_string_length(str_path, false), 0u);
 
-    storage_file = fopen(storage_data->file_path, "r");
+    storage_file = fopen(storage_data->file_path, "rb");
     if (!storage_file) {
         return false;
     }
 
-    while (!found && !feof(storage_file)) {
-        (void) fread(&item_header, sizeof(item_header), 1, storage_file);
-        found = (item_header.str_path_hash == str_path_hash);
-        fseek(storage_file, (long int) item_header.data_size, SEEK_CUR);
-    }
+    found = storage_file_read_footer(storage_file, &footer) && storage_file_find(storage_file, footer, str_path_hash, nullptr);
 
     fclose(storage_file);
 
@@ -211,17 +309,22 @@ bool resource_storage_check(resource_storage *storage_data, const char *str_path
 // -------------------------------------------------------------------------------------------------
 
 /**
- * @brief Returns the resource data and size associated to a path in a storage object. If the storage has no supplicant
- * entity, the storage object had not have loaded its associated storage file yet, and will return nullptr, regardless of
- * the resource existence.
+ * @brief Returns the resource data and size associated to a path in a storage object, and marks an entity as holding
+ * the resource. If the storage has no supplicant entity, the storage object had not have loaded its table of contents
+ * yet, and will return nullptr, regardless of the resource existence.
+ * Only the pages of the storage file holding the resource are mapped, when the resource is first acquired : the other
+ * resources of the storage are not touched. The resource stays mapped until its last holder releases it.
  *
  * @param[inout] storage_data Target storage data the resource was declared to.
  * @param[in] str_path Path to the resource file, used to identify the resource.
+ * @param[in] entity Entity holding the resource.
  * @param[out] out_size Outgoing size of the returned data, in bytes.
- * @return void *
+ * @param[inout] alloc Allocator used to register the holder.
+ * @return const void *
  */
-void *resource_storage_get(resource_storage *storage_data, const char *str_path, size_t *out_size)
+const void *resource_storage_acquire(resource_storage *storage_data, const char *str_path, basilisk_entity *entity, size_t *out_size, allocator alloc)
 {
+    resource_item_deserialized *item = nullptr;
     u32 str_path_hash = 0u;
     size_t data_index = 0u;
 
@@ -229,25 +332,113 @@ void *resource_storage_get(resource_storage *storage_data, const char *str_path,
         *out_size = 0u;
     }
 
-    if (!storage_data || !str_path) {
+    if (!storage_data || !str_path || !entity) {
         return nullptr;
     }
 
     str_path_hash = hash_jenkins_one_at_a_time((const byte *) str_path, c_string_length(str_path, false), 0u);
 
+    if (!sorted_range_find_in(RANGE_TO_ANY(storage_data->items), &hash_compare, &str_path_hash, &data_index)) {
+        return nullptr;
+    }
+
+    item = storage_data->items->data + data_index;
+
+    if (!item->mapping && !resource_item_map(item, storage_data->file_descriptor, alloc)) {
+        return nullptr;
+    }
+
+    if (!sorted_range_find_in(RANGE_TO_ANY(item->holders), &raw_pointer_compare, &entity, nullptr)) {
+        item->holders = range_ensure_capacity(alloc, RANGE_TO_ANY(item->holders), 1);
+        sorted_range_insert_in(RANGE_TO_ANY(item->holders), &raw_pointer_compare, &entity);
+    }
+
+    if (out_size) {
+        *out_size = item->header.data_size;
+    }
+    return item->data;
+}
+
+/**
+ * @brief Removes an entity from the holders of a resource. If the entity was its last holder, the resource is unmapped,
+ * while the storage stays loaded for its other resources.
+ *
+ * @param[inout] storage_data Target storage data the resource was declared to.
+ * @param[in] str_path Path to the resource file, used to identify the resource.
+ * @param[in] entity Entity releasing the resource.
+ * @param[inout] alloc Allocator used to forget the holders.
+ */
+void resource_storage_release(resource_storage *storage_data, const char *str_path, basilisk_entity *entity, allocator alloc)
+{
+    u32 str_path_hash = 0u;
+    size_t data_index = 0u;
+
+    if (!storage_data || !str_path || !entity) {
+        return;
+    }
+
+    str_path_hash = hash_jenkins_one_at_a_time((const byte *) str_path, c_string_length(str_path, false), 0u);
+
     if (sorted_range_find_in(RANGE_TO_ANY(storage_data->items), &hash_compare, &str_path_hash, &data_index)) {
-        if (out_size) {
-            *out_size = storage_data->items->data[data_index].header.data_size;
+        resource_item_release(storage_data->items->data + data_index, entity, alloc);
+    }
+}
+
+/**
+ * @brief Reads all resources of a storage file, one page after the other, so that the operating system keeps them in
+ * its page cache. The file is mapped by the function itself and unmapped before it returns : no storage object is
+ * touched, and the function can run on a worker thread while storages are loaded and unloaded. Resources fetched from
+ * a loaded storage during the prefetch only wait for their own pages to be read.
+ *
+ * @param[in] str_storage_path Path to the storage file.
+ * @param[in] on_progress Function (can be null) called after each prefetched resource, with the number of resources
+ * prefetched so far and the number of resources in the storage.
+ * @param[inout] context Pointer passed to the progress function.
+ * @return bool false if the file could not be mapped.
+ */
+bool resource_storage_prefetch(const char *str_storage_path, void (*on_progress)(void *context, size_t prefetched_count, size_t resources_count), void *context)
+{
+    void *mapping = nullptr;
+    size_t mapping_size = 0u;
+    storage_file_footer footer = { 0u };
+    resource_item_header item_header = { 0u };
+    size_t page_size = 0u;
+    volatile byte sink = 0u;
+
+    if (!str_storage_path) {
+        return false;
+    }
+
+    mapping = storage_file_map(str_storage_path, &mapping_size);
+    if (!mapping) {
+        return false;
+    }
+
+    footer = storage_mapping_footer(mapping, mapping_size);
+    page_size = (size_t) sysconf(_SC_PAGESIZE);
+
+    for (size_t i = 0u ; i < footer.toc_length ; i++) {
+        bytewise_copy(&item_header, (const byte *) mapping + footer.toc_offset + (i * sizeof(item_header)), sizeof(item_header));
+
+        // reading a single byte of each page is enough for the whole page to be read
+        for (u64 pos = 0u ; (item_header.offset <= footer.toc_offset) && (pos < item_header.data_size) && ((item_header.offset + pos) < footer.toc_offset) ; pos += page_size) {
+            sink ^= ((const byte *) mapping)[item_header.offset + pos];
+        }
+
+        if (on_progress) {
+            on_progress(context, i + 1u, (size_t) footer.toc_length);
         }
-        return storage_data->items->data[data_index].data;
     }
 
-    return nullptr;
+    munmap(mapping, mapping_size);
+    (void) sink;
+
+    return true;
 }
 
 /**
  * @brief Adds an entity as a user of a storage. If the storage had no previous other supplicant entity, it
- * will load the resources present in its associated file, if it exists.
+ * will load the table of contents of its associated file, if it exists.
  *
  * Supplicants are used to track the usage of a storage, and detect simply when to load and unload the resources
  * present in a storage file.
@@ -275,10 +466,10 @@ void resource_storage_add_supplicant(resource_storage *storage_data, basilisk_en
 }
 
 /**
- * @brief Removes an entity as a storage user. If this entity was the last one to be a supplicant to the storage,
- * all resources loaded from the filesystem are released from memory.
+ * @brief Removes an entity as a storage user, releasing all the resources it holds. If this entity was the last one
+ * to be a supplicant to the storage, the storage file is closed.
  *
- * @param[inout] storage_dataTarget storage the supplicant entity is unregistered from.
+ * @param[inout] storage_data Target storage the supplicant entity is unregistered from.
  * @param[in] entity Entity withdrawing its usage from the storage.
  * @param[inout] alloc Allocator used to unlaod the resources.
  */
@@ -288,6 +479,10 @@ void resource_storage_remove_supplicant(resource_storage *storage_data, basilisk
         return;
     }
 
+    for (size_t i = 0u ; i < storage_data->items->length ; i++) {
+        resource_item_release(storage_data->items->data + i, entity, alloc);
+    }
+
     sorted_range_remove_from(RANGE_TO_ANY(storage_data->supplicants), &raw_pointer_compare, &entity);
 
     if (storage_data->supplicants->length == 0) {
@@ -336,41 +531,56 @@ static bool file_data_array_from(const char *str_path, file_data_array **dest, a
 
 /**
  * @brief Adds the entries from a storage file into its storage object, if the storage object was set as not loaded.
+ * Only the table of contents of the file is read : the file is kept open, and each resource is mapped on its own when
+ * it is acquired. The table of contents is already sorted by hash, and is copied as is. Files of another layout
+ * version are loaded without any resource.
  *
  * @param[inout] storage Target storage to populate.
- * @param[in] alloc Allocator used to create memory to store the resources found in the file.
+ * @param[in] alloc Allocator used to index the resources found in the file.
  */
 static void resource_storage_load(resource_storage *storage, allocator alloc)
 {
     FILE *storage_file = nullptr;
-    resource_item_deserialized item = { 0u };
+    storage_file_footer footer = { 0u };
+    storage_file_toc *toc = nullptr;
+    int toc_fd = -1;
 
     if (!storage || storage->is_loaded) {
         return;
     }
 
-    storage_file = fopen(storage->file_path, "r");
-    if (!storage_file) {
-        return;
-    }
+    storage->file_descriptor = open(storage->file_path, O_RDONLY);
 
-    while (!feof(storage_file) && !ferror(storage_file)) {
-        if (fread(&item.header, 1, sizeof(item.header), storage_file) == sizeof(item.header)) {
-            item.data = alloc.malloc(alloc, item.header.data_size);
-            fread(item.data, item.header.data_size, 1, storage_file);
+    // the table of contents is read from the same file as the one the resources will be mapped from
+    toc_fd = (storage->file_descriptor >= 0) ? dup(storage->file_descriptor) : -1;
+    storage_file = (toc_fd >= 0) ? fdopen(toc_fd, "rb") : nullptr;
+    if (!storage_file && (toc_fd >= 0)) {
+        close(toc_fd);
+    }
 
-            storage->items = range_ensure_capacity(alloc, RANGE_TO_ANY(storage->items), 1);
-            sorted_range_insert_in(RANGE_TO_ANY(storage->items), &hash_compare, &item);
+    if (storage_file) {
+        if (storage_file_read_footer(storage_file, &footer)) {
+            toc = storage_file_read_toc(storage_file, footer, alloc);
         }
+        fclose(storage_file);
     }
 
-    fclose(storage_file);
+    if (toc) {
+        storage->items = range_ensure_capacity(alloc, RANGE_TO_ANY(storage->items), toc->length);
+        for (size_t i = 0u ; i < toc->length ; i++) {
+            if ((toc->data[i].offset <= footer.toc_offset) && (toc->data[i].data_size <= (footer.toc_offset - toc->data[i].offset))) {
+                range_insert_value(RANGE_TO_ANY(storage->items), storage->items->length, &(resource_item_deserialized) { .header = toc->data[i] });
+            }
+        }
+        range_destroy_dynamic(alloc, &RANGE_TO_ANY(toc));
+    }
 
     storage->is_loaded = true;
 }
 
 /**
- * @brief removes all entries from a storage object, if the storage object was set as laoded.
+ * @brief removes all entries from a storage object, if the storage object was set as laoded, unmapping the resources
+ * still held and closing its file.
  *
  * @param[inout] storage Target storage to empty.
  * @param[in] alloc Allocator used to release the resources' memory.
@@ -382,56 +592,463 @@ static void resource_storage_unload(resource_storage *storage, allocator alloc)
     }
 
     for (size_t i = 0u ; i < storage->items->length ; i++) {
-        alloc.free(alloc, storage->items->data[i].data);
+        resource_item_unmap(storage->items->data + i, alloc);
     }
     range_clear(RANGE_TO_ANY(storage->items));
 
+    if (storage->file_descriptor >= 0) {
+        close(storage->file_descriptor);
+    }
+    storage->file_descriptor = -1;
+
     storage->is_loaded = false;
 }
 
 /**
- * @brief Appends the contentes of a file at the end of a storage file, after a header containing the hash of the path
- * to the resource file and the number of appended bytes (excluding the header).
+ * @brief Maps the pages of a storage file holding a resource. Mappings start on a page boundary : the mapping begins at
+ * the page containing the first byte of the resource, and the resource data is offset into it.
+ *
+ * @param[inout] item Resource to map.
+ * @param[in] storage_fd Opened storage file the resource is in.
+ * @param[inout] alloc Allocator used to create the collection of holders.
+ * @return bool false if the resource could not be mapped.
+ */
+static bool resource_item_map(resource_item_deserialized *item, int storage_fd, allocator alloc)
+{
+    size_t page_size = 0u;
+    size_t page_offset = 0u;
+    void *mapping = nullptr;
+
+    if (storage_fd < 0) {
+        return false;
+    }
+
+    page_size = (size_t) sysconf(_SC_PAGESIZE);
+    page_offset = (size_t) (item->header.offset % page_size);
+
+    // an empty resource still needs a non-empty mapping, the file always goes on after it with its table of contents
+    item->mapping_size = page_offset + (size_t) item->header.data_size + ((item->header.data_size == 0u) ? 1u : 0u);
+
+    mapping = mmap(nullptr, item->mapping_size, PROT_READ, MAP_PRIVATE, storage_fd, (off_t) (item->header.offset - page_offset));
+    if (mapping == MAP_FAILED) {
+        item->mapping_size = 0u;
+        return false;
+    }
+
+    item->mapping = mapping;
+    item->data = (const byte *) mapping + page_offset;
+    item->holders = range_create_dynamic(alloc, sizeof(*item->holders->data), BASILISK_COLLECTIONS_START_LENGTH);
+
+    return true;
+}
+
+/**
+ * @brief Unmaps a resource, if it was mapped, and forgets all of its holders.
+ *
+ * @param[inout] item Resource to unmap.
+ * @param[inout] alloc Allocator used to release the collection of holders.
+ */
+static void resource_item_unmap(resource_item_deserialized *item, allocator alloc)
+{
+    if (item->mapping) {
+        munmap(item->mapping, item->mapping_size);
+    }
+
+    if (item->holders) {
+        range_destroy_dynamic(alloc, &RANGE_TO_ANY(item->holders));
+    }
+
+    item->data = nullptr;
+    item->mapping = nullptr;
+    item->mapping_size = 0u;
+    item->holders = nullptr;
+}
+
+/**
+ * @brief Removes an entity from the holders of a resource. The resource is unmapped when it has no holder left.
+ *
+ * @param[inout] item Resource released.
+ * @param[in] entity Entity releasing the resource. Nothing happens if it did not hold the resource.
+ * @param[inout] alloc Allocator used to release the collection of holders.
+ */
+static void resource_item_release(resource_item_deserialized *item, basilisk_entity *entity, allocator alloc)
+{
+    if (!item->holders || !sorted_range_find_in(RANGE_TO_ANY(item->holders), &raw_pointer_compare, &entity, nullptr)) {
+        return;
+    }
+
+    sorted_range_remove_from(RANGE_TO_ANY(item->holders), &raw_pointer_compare, &entity);
+
+    if (item->holders->length == 0u) {
+        resource_item_unmap(item, alloc);
+    }
+}
+
+/**
+ * @brief Maps a whole storage file read-only in memory. The file descriptor is closed right away, the mapping outliving
+ * it. Files too small to hold a header and a footer are not mapped.
+ *
+ * @param[in] storage_file_path Path to the storage file.
+ * @param[out] out_mapping_size Outgoing number of bytes mapped, zero if the file was not mapped.
+ * @return void * nullptr if the file could not be mapped.
+ */
+static void *storage_file_map(const char *storage_file_path, size_t *out_mapping_size)
+{
+    int storage_fd = -1;
+    struct stat storage_info = { 0u };
+    void *mapping = nullptr;
+
+    *out_mapping_size = 0u;
+
+    storage_fd = open(storage_file_path, O_RDONLY);
+    if (storage_fd < 0) {
+        return nullptr;
+    }
+
+    if ((fstat(storage_fd, &storage_info) == 0) && ((size_t) storage_info.st_size >= (sizeof(storage_file_header) + sizeof(storage_file_footer)))) {
+        mapping = mmap(nullptr, (size_t) storage_info.st_size, PROT_READ, MAP_PRIVATE, storage_fd, 0);
+    }
+
+    close(storage_fd);
+
+    if (!mapping || (mapping == MAP_FAILED)) {
+        return nullptr;
+    }
+
+    *out_mapping_size = (size_t) storage_info.st_size;
+    return mapping;
+}
+
+/**
+ * @brief Checks that a mapped storage file starts with a header of the current layout version, and returns the footer
+ * at its end. A footer locating a table of contents out of the mapping is rejected.
+ *
+ * @param[in] mapping Mapped storage file, can be nullptr.
+ * @param[in] mapping_size Number of bytes mapped.
+ * @return storage_file_footer A footer with an empty table of contents if the file is not valid.
+ */
+static storage_file_footer storage_mapping_footer(const void *mapping, size_t mapping_size)
+{
+    storage_file_header header = { 0u };
+    storage_file_footer footer = { 0u };
+
+    if (!mapping || (mapping_size < (sizeof(header) + sizeof(footer)))) {
+        return (storage_file_footer) { 0u };
+    }
+
+    bytewise_copy(&header, mapping, sizeof(header));
+    bytewise_copy(&footer, (const byte *) mapping + mapping_size - sizeof(footer), sizeof(footer));
+
+    if ((header.version != STORAGE_FILE_VERSION) || (memcmp(header.magic, STORAGE_FILE_MAGIC, sizeof(header.magic)) != 0)
+            || (footer.toc_offset > (mapping_size - sizeof(footer)))
+            || (footer.toc_length > ((mapping_size - sizeof(footer) - footer.toc_offset) / sizeof(resource_item_header)))) {
+        return (storage_file_footer) { 0u };
+    }
+
+    return footer;
+}
+
+/**
+ * @brief Writes an empty storage file at some path, replacing any file there : a header, and a footer pointing to an
+ * empty table of contents right after the header.
+ *
+ * @param[in] storage_file_path Path to the written storage file.
+ * @return bool
+ */
+static bool storage_file_initialize(const char *storage_file_path)
+{
+    FILE *storage_file = nullptr;
+    storage_file_header header = { .magic = { 0u }, .version = STORAGE_FILE_VERSION };
+    storage_file_footer footer = { .toc_offset = sizeof(header), .toc_length = 0u };
+    bool written = false;
+
+    storage_file = fopen(storage_file_path, "wb");
+    if (!storage_file) {
+        return false;
+    }
+
+    bytewise_copy(header.magic, STORAGE_FILE_MAGIC, sizeof(header.magic));
+    written = (fwrite(&header, sizeof(header), 1, storage_file) == 1) && (fwrite(&footer, sizeof(footer), 1, storage_file) == 1);
+
+    fclose(storage_file);
+
+    return written;
+}
+
+/**
+ * @brief Checks that an opened storage file starts with a header of the current layout version, and reads the footer
+ * at its end. The position in the file is left undefined.
+ *
+ * @param[inout] storage_file Opened storage file.
+ * @param[out] out_footer Outgoing footer.
+ * @return bool false if the file is not a storage file of the current version.
+ */
+static bool storage_file_read_footer(FILE *storage_file, storage_file_footer *out_footer)
+{
+    storage_file_header header = { 0u };
+
+    if ((fseek(storage_file, 0, SEEK_SET) != 0) || (fread(&header, sizeof(header), 1, storage_file) != 1)) {
+        return false;
+    }
+
+    if ((header.version != STORAGE_FILE_VERSION) || (memcmp(header.magic, STORAGE_FILE_MAGIC, sizeof(header.magic)) != 0)) {
+        return false;
+    }
+
+    return (fseek(storage_file, -(long int) sizeof(*out_footer), SEEK_END) == 0) && (fread(out_footer, sizeof(*out_footer), 1, storage_file) == 1);
+}
+
+/**
+ * @brief Searches a resource in the table of contents of an opened storage file, with a binary search reading a single
+ * entry at each step.
+ *
+ * @param[inout] storage_file Opened storage file.
+ * @param[in] footer Footer of the file, locating its table of contents.
+ * @param[in] str_path_hash Hash of the path of the resource.
+ * @param[out] out_header Outgoing entry of the resource, if found. Can be nullptr.
+ * @return bool
+ */
+static bool storage_file_find(FILE *storage_file, storage_file_footer footer, u32 str_path_hash, resource_item_header *out_header)
+{
+    resource_item_header entry = { 0u };
+    u64 low = 0u;
+    u64 high = footer.toc_length;
+    u64 middle = 0u;
+
+    while (low < high) {
+        middle = low + ((high - low) / 2u);
+
+        if ((fseek(storage_file, (long int) (footer.toc_offset + (middle * sizeof(entry))), SEEK_SET) != 0) || (fread(&entry, sizeof(entry), 1, storage_file) != 1)) {
+            return false;
+        }
+
+        if (entry.str_path_hash == str_path_hash) {
+            if (out_header) {
+                *out_header = entry;
+            }
+            return true;
+        } else if (entry.str_path_hash < str_path_hash) {
+            low = middle + 1u;
+        } else {
+            high = middle;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Reads the whole table of contents of an opened storage file, with room for one more entry. The position in
+ * the file is left after the table.
+ *
+ * @param[inout] storage_file Opened storage file.
+ * @param[in] footer Footer of the file, locating its table of contents.
+ * @param[inout] alloc Allocator used for the table.
+ * @return storage_file_toc * nullptr if the table could not be read.
+ */
+static storage_file_toc *storage_file_read_toc(FILE *storage_file, storage_file_footer footer, allocator alloc)
+{
+    storage_file_toc *toc = nullptr;
+
+    if (fseek(storage_file, (long int) footer.toc_offset, SEEK_SET) != 0) {
+        return nullptr;
+    }
+
+    toc = range_create_dynamic(alloc, sizeof(*toc->data), (size_t) footer.toc_length + 1u);
+    if (toc) {
+        toc->length = fread(toc->data, sizeof(*toc->data), (size_t) footer.toc_length, storage_file);
+    }
+
+    return toc;
+}
+
+/**
+ * @brief Writes zeroes to a storage file from some position up to the next position aligned to STORAGE_FILE_ALIGNMENT,
+ * and returns the aligned position.
+ *
+ * @param[inout] storage_file Storage file, written at its current position.
+ * @param[in] position Current position in the file.
+ * @return u64
+ */
+static u64 storage_file_pad(FILE *storage_file, u64 position)
+{
+    while ((position % STORAGE_FILE_ALIGNMENT) != 0u) {
+        fputc(0, storage_file);
+        position += 1u;
+    }
+
+    return position;
+}
+
+/**
+ * @brief Writes the contents of a file to a storage file, and adds it to the table of contents of the storage file under
+ * the hash of the path to the resource file. If the table already holds the resource with the same size and
+ * modification time as the file, nothing is written and the file is not read.
+ * Otherwise, the resource is written over the former table of contents, at an aligned position, and the table of
+ * contents is written again after it, followed by the footer. A resource written again is replaced in the table of
+ * contents, its former data left unused until the storage file is compacted : this happens once the unused data takes
+ * more room than the used data.
  * The function will return true if the operation succeeded, and false otherwise.
  *
  * @param storage_file_path Path to the target storage file.
  * @param res_path Path to the resource file.
- * @param alloc Allocator used to create a buffer to read the file.
+ * @param alloc Allocator used to create buffers to read the files.
  * @return bool
  */
-static bool storage_file_append(const char *storage_file_path, const char *res_path, allocator alloc)
+static bool storage_file_update(const char *storage_file_path, const char *res_path, allocator alloc)
 {
     file_data_array *resource_file_data = nullptr;
+    storage_file_toc *toc = nullptr;
     FILE *storage_file = nullptr;
-    u32 str_path_hash = 0u;
+    struct stat resource_info = { 0u };
+    storage_file_footer footer = { 0u };
+    resource_item_header written_item = { 0u };
+    resource_item_header stored_item = { 0u };
+    size_t toc_pos = 0u;
+    u64 used_size = 0u;
+    bool written = false;
+
+    if (!storage_file_path || !res_path || (stat(res_path, &resource_info) != 0)) {
+        return false;
+    }
 
-    if (!storage_file_path || !res_path) {
+    written_item.str_path_hash = hash_jenkins_one_at_a_time((const byte *) res_path, c_string_length(res_path, false), 0u);
+    written_item.data_size = (u64) resource_info.st_size;
+    written_item.source_mtime = (i64) resource_info.st_mtime;
+
+    storage_file = fopen(storage_file_path, "r+b");
+    if (!storage_file || !storage_file_read_footer(storage_file, &footer)) {
+        if (storage_file) {
+            fclose(storage_file);
+        }
         return false;
     }
 
-    str_path_hash = hash_jenkins_one_at_a_time((const byte *) res_path, c_string_length(res_path, false), 0u);
+    // unchanged resources are left as they are
+    if (storage_file_find(storage_file, footer, written_item.str_path_hash, &stored_item)
+            && (stored_item.data_size == written_item.data_size) && (stored_item.source_mtime == written_item.source_mtime)) {
+        fclose(storage_file);
+        return true;
+    }
 
-    // fetch raw data from the target file
+    // fetch raw data from the target file, and the current table of contents of the storage file
     resource_file_data = range_create_dynamic(alloc, sizeof(*resource_file_data->data), 1u);
+    toc = storage_file_read_toc(storage_file, footer, alloc);
 
-    if (!file_data_array_from(res_path, &resource_file_data, alloc)) {
+    if (!toc || !file_data_array_from(res_path, &resource_file_data, alloc)) {
+        fclose(storage_file);
+        range_destroy_dynamic(alloc, &RANGE_TO_ANY(toc));
         range_destroy_dynamic(alloc, &RANGE_TO_ANY(resource_file_data));
         return false;
     }
 
-    // append resource file content at str_path in storage file
-    storage_file = fopen(storage_file_path, "a");
-    if (!storage_file) {
-        range_destroy_dynamic(alloc, &RANGE_TO_ANY(resource_file_data));
-        return false;
+    // write the resource over the former table of contents, then the new table of contents and footer
+    fseek(storage_file, (long int) footer.toc_offset, SEEK_SET);
+    written_item.offset = storage_file_pad(storage_file, footer.toc_offset);
+    written_item.data_size = resource_file_data->length;
+    fwrite(resource_file_data->data, resource_file_data->length, 1, storage_file);
+
+    if (sorted_range_find_in(RANGE_TO_ANY(toc), &hash_compare, &written_item, &toc_pos)) {
+        toc->data[toc_pos] = written_item;
+    } else {
+        sorted_range_insert_in(RANGE_TO_ANY(toc), &hash_compare, &written_item);
     }
 
-    fwrite(&(resource_item_header) { .str_path_hash = str_path_hash, .data_size = resource_file_data->length }, sizeof(resource_item_header), 1, storage_file);
-    fwrite(resource_file_data->data, resource_file_data->length, 1, storage_file);
+    footer.toc_offset = storage_file_pad(storage_file, written_item.offset + written_item.data_size);
+    footer.toc_length = toc->length;
+    written = (fwrite(toc->data, sizeof(*toc->data), toc->length, storage_file) == toc->length) && (fwrite(&footer, sizeof(footer), 1, storage_file) == 1);
     fflush(storage_file);
 
     fclose(storage_file);
+
+    for (size_t i = 0u ; i < toc->length ; i++) {
+        used_size += toc->data[i].data_size;
+    }
+
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY(toc));
     range_destroy_dynamic(alloc, &RANGE_TO_ANY(resource_file_data));
 
-    return true;
+    if (written && ((footer.toc_offset - sizeof(storage_file_header) - used_size) > used_size)) {
+        written = storage_file_compact(storage_file_path, alloc);
+    }
+
+    return written;
+}
+
+/**
+ * @brief Rewrites a storage file with only the resources listed in its table of contents, one after the other, dropping
+ * the data of replaced resources. The compacted file is written next to the storage file, then moved over it.
+ *
+ * @param storage_file_path Path to the target storage file.
+ * @param alloc Allocator used to create buffers to read the resources.
+ * @return bool
+ */
+static bool storage_file_compact(const char *storage_file_path, allocator alloc)
+{
+    FILE *storage_file = nullptr;
+    FILE *compacted_file = nullptr;
+    char *compacted_path = nullptr;
+    size_t path_length = 0u;
+    file_data_array *resource_data = nullptr;
+    storage_file_toc *toc = nullptr;
+    storage_file_footer footer = { 0u };
+    storage_file_header header = { .magic = { 0u }, .version = STORAGE_FILE_VERSION };
+    u64 position = sizeof(header);
+    bool written = true;
+
+    storage_file = fopen(storage_file_path, "rb");
+    if (!storage_file || !storage_file_read_footer(storage_file, &footer) || !(toc = storage_file_read_toc(storage_file, footer, alloc))) {
+        if (storage_file) {
+            fclose(storage_file);
+        }
+        return false;
+    }
+
+    path_length = c_string_length(storage_file_path, false);
+    compacted_path = alloc.malloc(alloc, path_length + sizeof(".tmp"));
+    bytewise_copy(compacted_path, storage_file_path, path_length);
+    bytewise_copy(compacted_path + path_length, ".tmp", sizeof(".tmp"));
+
+    resource_data = range_create_dynamic(alloc, sizeof(*resource_data->data), 1u);
+
+    compacted_file = fopen(compacted_path, "wb");
+    written = (compacted_file != nullptr);
+
+    if (written) {
+        bytewise_copy(header.magic, STORAGE_FILE_MAGIC, sizeof(header.magic));
+        written = (fwrite(&header, sizeof(header), 1, compacted_file) == 1);
+    }
+
+    for (size_t i = 0u ; written && (i < toc->length) ; i++) {
+        resource_data = range_ensure_capacity(alloc, RANGE_TO_ANY(resource_data), (size_t) toc->data[i].data_size);
+        written = (fseek(storage_file, (long int) toc->data[i].offset, SEEK_SET) == 0)
+                && (fread(resource_data->data, 1u, (size_t) toc->data[i].data_size, storage_file) == toc->data[i].data_size);
+
+        toc->data[i].offset = storage_file_pad(compacted_file, position);
+        written = written && (fwrite(resource_data->data, 1u, (size_t) toc->data[i].data_size, compacted_file) == toc->data[i].data_size);
+        position = toc->data[i].offset + toc->data[i].data_size;
+    }
+
+    if (written) {
+        footer.toc_offset = storage_file_pad(compacted_file, position);
+        written = (fwrite(toc->data, sizeof(*toc->data), toc->length, compacted_file) == toc->length) && (fwrite(&footer, sizeof(footer), 1, compacted_file) == 1);
+    }
+
+    fclose(storage_file);
+    if (compacted_file) {
+        fclose(compacted_file);
+    }
+
+    // the storage file is only replaced by a complete compacted file
+    if (written) {
+        written = (rename(compacted_path, storage_file_path) == 0);
+    } else {
+        (void) remove(compacted_path);
+    }
+
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY(resource_data));
+    alloc.free(alloc, compacted_path);
+    range_destroy_dynamic(alloc, &RANGE_TO_ANY(toc));
+
+    return written;
 }
@@ -41,17 +41,25 @@ void resource_storage_destroy(resource_storage **storage_data, allocator alloc);
 /* Tests the presence of a resource (identified by its path) in a resource storage's associated storage file. */
 bool resource_storage_check(resource_storage *storage_data, const char *str_path, allocator alloc);
 
-/* Returns a resource from the loaded resources in a storage. This storage needs to be loaded to return the
-   resource (i.e. have at least one supplicant entity.) */
-void *resource_storage_get(resource_storage *storage_data, const char *str_path, size_t *out_size);
+/* Returns a resource from the loaded resources in a storage, mapping it if needed, and marks an entity as holding it.
+   This storage needs to be loaded to return the resource (i.e. have at least one supplicant entity.) The resource points
+   into a read-only mapping of its own pages of the storage file. */
+const void *resource_storage_acquire(resource_storage *storage_data, const char *str_path, basilisk_entity *entity, size_t *out_size, allocator alloc);
+
+/* Removes an entity from the holders of a resource. If no holders are left, the resource is unmapped. */
+void resource_storage_release(resource_storage *storage_data, const char *str_path, basilisk_entity *entity, allocator alloc);
+
+/* Reads all resources of a storage file in memory through a mapping of its own, so that they are in the page cache
+   when they are fetched. Can be called from any thread. */
+bool resource_storage_prefetch(const char *str_storage_path, void (*on_progress)(void *context, size_t prefetched_count, size_t resources_count), void *context);
 
 // -------------------------------------------------------------------------------------------------
 
-/* Adds an entity as a supplicant, or user, of a storage. If it is the first one, the storage file will be
-  loaded in memory.*/
+/* Adds an entity as a supplicant, or user, of a storage. If it is the first one, the table of contents of the
+  storage file will be loaded in memory.*/
 void resource_storage_add_supplicant(resource_storage *storage_data, basilisk_entity *entity, allocator alloc);
 
-/* Removes an entity as a supplicant from a storage. If no supplicants are left, the storage unloads its resources. */
+/* Removes an entity as a supplicant from a storage, releasing the resources it holds. If no supplicants are left, the storage unloads its resources. */
 void resource_storage_remove_supplicant(resource_storage *storage_data, basilisk_entity *entity, allocator alloc);
 
 // -------------------------------------------------------------------------------------------------
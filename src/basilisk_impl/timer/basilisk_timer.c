@@ -0,0 +1,357 @@
+/**
+ * @file basilisk_timer.c
+ * @author gabriel ()
+ * @brief Implementation file for the hierarchical timing wheel.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "basilisk_timer.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/// Number of bits of the expiry tick used to index the slots of a single level of the wheel.
+#define TIMER_WHEEL_SLOT_BITS (6u)
+/// Number of slots in a single level of the wheel.
+#define TIMER_WHEEL_SLOTS_COUNT (1u << TIMER_WHEEL_SLOT_BITS)
+/// Mask extracting a slot index from a tick.
+#define TIMER_WHEEL_SLOT_MASK (TIMER_WHEEL_SLOTS_COUNT - 1u)
+/// Number of levels of the wheel. Each level covers TIMER_WHEEL_SLOTS_COUNT times the span of the previous one.
+#define TIMER_WHEEL_LEVELS_COUNT (4u)
+/// Number of ticks (milliseconds) covered by the whole wheel. Timers further in time are parked on the last level and re-cascaded.
+#define TIMER_WHEEL_SPAN ((u64) 1u << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS_COUNT))
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Single timer tied to an entity.
+ */
+typedef struct timer_entry {
+    /** Absolute tick at which the timer fires. */
+    u64 expiry;
+    /** Number of ticks between two firings of the timer. If zero, the timer fires once. */
+    u64 period;
+
+    /** Entity the timer is tied to, receiving the callback. */
+    basilisk_engine_entity *source;
+    /** Function executed when the timer fires. */
+    void (*callback)(basilisk_entity *self_data, void *timer_data);
+    /** Non-owned user data passed to the callback. */
+    void *data;
+} timer_entry;
+
+/**
+ * @brief Collection of timers sharing a slot of the wheel.
+ */
+typedef RANGE(timer_entry) timer_slot;
+
+/**
+ * @brief Hierarchical timing wheel. The first level has a resolution of one tick (a millisecond), and each slot of
+ * the next levels spans a whole rotation of the previous level. When the first level completes a rotation, the
+ * matching slot of the next level is cascaded down.
+ */
+typedef struct timer_wheel {
+    /** Current tick of the wheel. */
+    u64 now;
+    /** Fraction of a tick that was not yet consumed by the last advance. */
+    f32 remainder_ms;
+    /** Number of timers stored in the wheel. */
+    size_t length;
+
+    /** All the slots of the wheel, level by level. */
+    timer_slot *slots[TIMER_WHEEL_LEVELS_COUNT][TIMER_WHEEL_SLOTS_COUNT];
+} timer_wheel;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Places a timer in the slot matching its expiry. */
+static void timer_wheel_insert(timer_wheel *wheel, timer_entry entry, allocator alloc);
+
+/* Redistributes the timers of a slot to lower levels. */
+static void timer_wheel_cascade(timer_wheel *wheel, size_t level, allocator alloc);
+
+/* Moves the wheel by one tick, firing all timers expiring on this tick. */
+static void timer_wheel_tick(timer_wheel *wheel, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates a new timing wheel with no timer in it.
+ *
+ * @param[inout] alloc Allocator used for the creation.
+ * @return timer_wheel *
+ */
+timer_wheel *timer_wheel_create(allocator alloc)
+{
+    timer_wheel *new_wheel = nullptr;
+
+    new_wheel = alloc.malloc(alloc, sizeof(*new_wheel));
+
+    if (new_wheel) {
+        *new_wheel = (timer_wheel) { 0u };
+
+        for (size_t level = 0u ; level < TIMER_WHEEL_LEVELS_COUNT ; level++) {
+            for (size_t slot = 0u ; slot < TIMER_WHEEL_SLOTS_COUNT ; slot++) {
+                new_wheel->slots[level][slot] = range_create_dynamic(alloc, sizeof(*new_wheel->slots[level][slot]->data), 1u);
+            }
+        }
+    }
+
+    return new_wheel;
+}
+
+/**
+ * @brief Releases the memory taken by a timing wheel and nullifies the pointer passed. Pending timers are dropped.
+ *
+ * @param[inout] wheel Object to destroy.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void timer_wheel_destroy(timer_wheel **wheel, allocator alloc)
+{
+    if (!wheel || !*wheel) {
+        return;
+    }
+
+    for (size_t level = 0u ; level < TIMER_WHEEL_LEVELS_COUNT ; level++) {
+        for (size_t slot = 0u ; slot < TIMER_WHEEL_SLOTS_COUNT ; slot++) {
+            range_destroy_dynamic(alloc, &RANGE_TO_ANY((*wheel)->slots[level][slot]));
+        }
+    }
+
+    alloc.free(alloc, *wheel);
+    *wheel = nullptr;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Adds a timer to the wheel. The callback will receive the entity's data and the timer data once the delay
+ * has elapsed, and then every period if the period is not zero.
+ * A delay of zero fires the timer on the next tick.
+ *
+ * @param[inout] wheel Wheel receiving the timer.
+ * @param[in] source Entity the timer is tied to.
+ * @param[in] delay_ms Number of milliseconds before the first firing.
+ * @param[in] period_ms Number of milliseconds between two firings, or zero for a one-shot timer.
+ * @param[in] callback Function executed when the timer fires.
+ * @param[in] timer_data Non-owned data passed to the callback.
+ * @param[inout] alloc Allocator used for the eventual slot extension.
+ */
+void timer_wheel_schedule(timer_wheel *wheel, basilisk_engine_entity *source, u64 delay_ms, u64 period_ms, void (*callback)(basilisk_entity *self_data, void *timer_data), void *timer_data, allocator alloc)
+{
+    if (!wheel || !source || !callback) {
+        return;
+    }
+
+    timer_wheel_insert(wheel, (timer_entry) {
+            .expiry = wheel->now + ((delay_ms > 0u) ? delay_ms : 1u),
+            .period = period_ms,
+            .source = source,
+            .callback = callback,
+            .data = timer_data, }, alloc);
+}
+
+/**
+ * @brief Removes all timers tied to some entity and some callback.
+ *
+ * @param[inout] wheel Wheel storing the timers.
+ * @param[in] source Entity the timers are tied to.
+ * @param[in] callback Callback the timers were scheduled with.
+ */
+void timer_wheel_unschedule(timer_wheel *wheel, basilisk_engine_entity *source, void (*callback)(basilisk_entity *self_data, void *timer_data))
+{
+    timer_slot *slot = nullptr;
+    size_t pos = 0u;
+
+    if (!wheel || !source) {
+        return;
+    }
+
+    for (size_t level = 0u ; level < TIMER_WHEEL_LEVELS_COUNT ; level++) {
+        for (size_t slot_index = 0u ; slot_index < TIMER_WHEEL_SLOTS_COUNT ; slot_index++) {
+            slot = wheel->slots[level][slot_index];
+            pos = 0u;
+
+            while (pos < slot->length) {
+                if ((slot->data[pos].source == source) && (!callback || (slot->data[pos].callback == callback))) {
+                    range_remove(RANGE_TO_ANY(slot), pos);
+                    wheel->length -= 1u;
+                } else {
+                    pos += 1u;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Removes all timers tied to some entity.
+ *
+ * @param[inout] wheel Wheel storing the timers.
+ * @param[in] source Entity that might have scheduled timers.
+ */
+void timer_wheel_remove_timers_of(timer_wheel *wheel, basilisk_engine_entity *source)
+{
+    timer_wheel_unschedule(wheel, source, nullptr);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Moves the wheel forward in time by some number of milliseconds, firing every timer expiring in the meantime.
+ * Fractions of milliseconds are accumulated across calls.
+ *
+ * @param[inout] wheel Target wheel.
+ * @param[in] elapsed_ms Number of milliseconds elapsed since the last advance.
+ * @param[inout] alloc Allocator used to re-insert cascaded and periodic timers.
+ */
+void timer_wheel_advance(timer_wheel *wheel, f32 elapsed_ms, allocator alloc)
+{
+    u64 ticks = 0u;
+
+    if (!wheel || (elapsed_ms <= 0.f)) {
+        return;
+    }
+
+    wheel->remainder_ms += elapsed_ms;
+    ticks = (u64) wheel->remainder_ms;
+    wheel->remainder_ms -= (f32) ticks;
+
+    if (wheel->length == 0u) {
+        wheel->now += ticks;
+        return;
+    }
+
+    for (u64 i = 0u ; i < ticks ; i++) {
+        timer_wheel_tick(wheel, alloc);
+    }
+}
+
+/**
+ * @brief Returns the number of timers waiting to fire.
+ *
+ * @param[in] wheel Examined wheel.
+ * @return size_t
+ */
+size_t timer_wheel_length(const timer_wheel *wheel)
+{
+    if (!wheel) {
+        return 0u;
+    }
+
+    return wheel->length;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Inserts a timer in the slot of the lowest level able to hold its expiry. Timers too far in the future are
+ * parked in the last slot of the last level and will be re-inserted when this slot is cascaded.
+ *
+ * @param[inout] wheel Target wheel.
+ * @param[in] entry Inserted timer.
+ * @param[inout] alloc Allocator used for the eventual slot extension.
+ */
+static void timer_wheel_insert(timer_wheel *wheel, timer_entry entry, allocator alloc)
+{
+    u64 delta = entry.expiry - wheel->now;
+    u64 slot_tick = entry.expiry;
+    size_t level = 0u;
+    size_t slot_index = 0u;
+
+    if (entry.expiry < wheel->now) {
+        delta = 0u;
+        slot_tick = wheel->now;
+    } else if (delta >= TIMER_WHEEL_SPAN) {
+        delta = TIMER_WHEEL_SPAN - 1u;
+        slot_tick = wheel->now + delta;
+    }
+
+    while ((level < (TIMER_WHEEL_LEVELS_COUNT - 1u)) && (delta >= ((u64) 1u << (TIMER_WHEEL_SLOT_BITS * (level + 1u))))) {
+        level += 1u;
+    }
+
+    slot_index = (size_t) ((slot_tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK);
+
+    wheel->slots[level][slot_index] = range_ensure_capacity(alloc, RANGE_TO_ANY(wheel->slots[level][slot_index]), 1);
+    range_insert_value(RANGE_TO_ANY(wheel->slots[level][slot_index]), wheel->slots[level][slot_index]->length, &entry);
+    wheel->length += 1u;
+}
+
+/**
+ * @brief Empties the current slot of a level, re-inserting its timers so they land in lower levels.
+ *
+ * @param[inout] wheel Target wheel.
+ * @param[in] level Level of the cascaded slot.
+ * @param[inout] alloc Allocator used for the re-insertions.
+ */
+static void timer_wheel_cascade(timer_wheel *wheel, size_t level, allocator alloc)
+{
+    size_t slot_index = (size_t) ((wheel->now >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK);
+    timer_slot *cascaded = wheel->slots[level][slot_index];
+    timer_entry entry = { 0u };
+
+    while (cascaded->length > 0u) {
+        entry = cascaded->data[cascaded->length - 1u];
+        range_remove(RANGE_TO_ANY(cascaded), cascaded->length - 1u);
+        wheel->length -= 1u;
+
+        timer_wheel_insert(wheel, entry, alloc);
+        cascaded = wheel->slots[level][slot_index];
+    }
+}
+
+/**
+ * @brief Advances the wheel by a single tick. Upper levels are cascaded when the lower level completes a rotation,
+ * then all timers of the current first-level slot are fired.
+ * Periodic timers are re-inserted before their callback runs, so a callback can unschedule its own timer.
+ *
+ * @param[inout] wheel Target wheel.
+ * @param[inout] alloc Allocator used for the re-insertions.
+ */
+static void timer_wheel_tick(timer_wheel *wheel, allocator alloc)
+{
+    size_t level = 1u;
+    size_t slot_index = 0u;
+    timer_entry entry = { 0u };
+
+    wheel->now += 1u;
+
+    while ((level < TIMER_WHEEL_LEVELS_COUNT) && (((wheel->now >> (TIMER_WHEEL_SLOT_BITS * (level - 1u))) & TIMER_WHEEL_SLOT_MASK) == 0u)) {
+        timer_wheel_cascade(wheel, level, alloc);
+        level += 1u;
+    }
+
+    slot_index = (size_t) (wheel->now & TIMER_WHEEL_SLOT_MASK);
+
+    // the slot is re-read each time since callbacks can schedule and unschedule timers
+    while (wheel->slots[0u][slot_index]->length > 0u) {
+        entry = wheel->slots[0u][slot_index]->data[wheel->slots[0u][slot_index]->length - 1u];
+        range_remove(RANGE_TO_ANY(wheel->slots[0u][slot_index]), wheel->slots[0u][slot_index]->length - 1u);
+        wheel->length -= 1u;
+
+        if (entry.period > 0u) {
+            timer_wheel_insert(wheel, (timer_entry) {
+                    .expiry = wheel->now + entry.period,
+                    .period = entry.period,
+                    .source = entry.source,
+                    .callback = entry.callback,
+                    .data = entry.data, }, alloc);
+        }
+
+        basilisk_engine_entity_send_timer(entry.source, entry.callback, entry.data);
+    }
+}
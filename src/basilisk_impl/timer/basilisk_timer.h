@@ -0,0 +1,57 @@
+/**
+ * @file basilisk_timer.h
+ * @author gabriel ()
+ * @brief Schedule entity callbacks to be executed after some delay, once or periodically.
+ *
+ * Timers are stored in a hierarchical timing wheel : inserting and firing a timer are done in constant amortized
+ * time, so that an entity waiting on a timer costs nothing to the engine until it fires.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef __TIMER_H__
+#define __TIMER_H__
+
+#include "../basilisk_common.h"
+#include "../entity/basilisk_entity.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Opaque type to a hierarchical timing wheel holding entity timers. */
+typedef struct timer_wheel timer_wheel;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Allocates a timing wheel and returns a pointer to it. */
+timer_wheel *timer_wheel_create(allocator alloc);
+
+/* Releases memory taken by a timing wheel and nullifies the pointer passed. */
+void timer_wheel_destroy(timer_wheel **wheel, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Adds a timer tied to an entity, that will fire after some delay and then every period if the period is not zero. */
+void timer_wheel_schedule(timer_wheel *wheel, basilisk_engine_entity *source, u64 delay_ms, u64 period_ms, void (*callback)(basilisk_entity *self_data, void *timer_data), void *timer_data, allocator alloc);
+
+/* Removes all timers tied to an entity and a callback. */
+void timer_wheel_unschedule(timer_wheel *wheel, basilisk_engine_entity *source, void (*callback)(basilisk_entity *self_data, void *timer_data));
+
+/* Removes all timers tied to an entity. */
+void timer_wheel_remove_timers_of(timer_wheel *wheel, basilisk_engine_entity *source);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Moves the wheel forward in time, firing all timers that expire in the meantime. */
+void timer_wheel_advance(timer_wheel *wheel, f32 elapsed_ms, allocator alloc);
+
+/* Returns the number of pending timers in the wheel. */
+size_t timer_wheel_length(const timer_wheel *wheel);
+
+#endif
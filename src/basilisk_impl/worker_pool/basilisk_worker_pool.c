@@ -0,0 +1,499 @@
+/**
+ * @file basilisk_worker_pool.c
+ * @author gabriel ()
+ * @brief Implementation file for the work-stealing thread pool.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <threads.h>
+
+#include "basilisk_worker_pool.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Tasks waiting to be executed by a worker, stored in a ring buffer. The owner takes tasks from the back,
+ * thieves from the front.
+ */
+typedef struct worker_deque {
+    /** Lock protecting the tasks from concurrent access between the owner, the thieves and the submitter. */
+    mtx_t lock;
+    /** Ring buffer of capacity tasks. */
+    worker_task *tasks;
+    /** Number of tasks the buffer can hold. */
+    size_t capacity;
+    /** Position in the buffer of the oldest task. */
+    size_t front;
+    /** Number of pending tasks. */
+    size_t length;
+} worker_deque;
+
+/**
+ * @brief Data of a single thread of the pool.
+ */
+typedef struct worker {
+    /** Thread executing the tasks. */
+    thrd_t thread;
+    /** Non-owned reference to the pool the worker belongs to. */
+    worker_pool *pool;
+    /** Position of the worker in the pool, used to start stealing from its neighbours. */
+    size_t index;
+    /** Tasks handed to this worker. */
+    worker_deque deque;
+} worker;
+
+/**
+ * @brief Set of threads executing tasks.
+ */
+typedef struct worker_pool {
+    /** Number of threads. */
+    size_t workers_count;
+    /** Array of workers_count workers. */
+    worker *workers;
+
+    /** Lock used with the condition variables to put threads to sleep. */
+    mtx_t sleep_lock;
+    /** Signaled when a task is submitted or when the pool stops. */
+    cnd_t wake_up;
+    /** Signaled when the last pending task of the pool or of a group completes. */
+    cnd_t all_done;
+
+    /** Number of tasks submitted and not completed yet. */
+    atomic_size_t pending;
+    /** Number of tasks sitting in the deques. */
+    atomic_size_t queued;
+    /** Index of the next worker to receive a task. */
+    size_t next_worker;
+    /** Flags the workers to exit. */
+    atomic_bool should_stop;
+} worker_pool;
+
+/// Set while the calling thread executes a task, so that a thread helping a pool is not mistaken for the submitter.
+static thread_local bool worker_is_running_task = false;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Main function of a worker thread. */
+static int worker_main(void *worker_arg);
+
+/* Appends a task to the back of a deque, growing it if needed. */
+static bool worker_deque_push(worker_deque *deque, worker_task task, allocator alloc);
+
+/* Takes a task from the back of a deque. */
+static bool worker_deque_pop(worker_deque *deque, worker_task *out_task);
+
+/* Takes a task from the front of a deque, optionally the oldest one of some group. */
+static bool worker_deque_steal(worker_deque *deque, worker_task_group *group, worker_task *out_task);
+
+/* Searches for a task, starting with some worker's deque and stealing from the others. */
+static bool worker_pool_take(worker_pool *pool, size_t start_index, worker_task_group *group, worker_task *out_task);
+
+/* Executes a task taken from the pool and notifies the waiting thread if it was the last one. */
+static void worker_pool_run(worker_pool *pool, worker_task task);
+
+/* Executes the routine of a task, flagging the calling thread as running a task meanwhile. */
+static void worker_task_execute(worker_task task);
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates a pool of threads and starts them. With zero threads, submitted tasks are executed immediately
+ * by the submitting thread.
+ *
+ * @param[in] workers_count Number of threads to start.
+ * @param[inout] alloc Allocator used for the creation.
+ * @return worker_pool *
+ */
+worker_pool *worker_pool_create(size_t workers_count, allocator alloc)
+{
+    worker_pool *new_pool = nullptr;
+
+    new_pool = alloc.malloc(alloc, sizeof(*new_pool));
+
+    if (!new_pool) {
+        return nullptr;
+    }
+
+    *new_pool = (worker_pool) { .workers_count = workers_count, };
+
+    atomic_init(&new_pool->pending, 0u);
+    atomic_init(&new_pool->queued, 0u);
+    atomic_init(&new_pool->should_stop, false);
+    mtx_init(&new_pool->sleep_lock, mtx_plain);
+    cnd_init(&new_pool->wake_up);
+    cnd_init(&new_pool->all_done);
+
+    if (workers_count > 0u) {
+        new_pool->workers = alloc.malloc(alloc, sizeof(*new_pool->workers) * workers_count);
+    }
+
+    for (size_t i = 0u ; i < new_pool->workers_count ; i++) {
+        new_pool->workers[i] = (worker) {
+                .pool = new_pool,
+                .index = i,
+                .deque.tasks = alloc.malloc(alloc, sizeof(*new_pool->workers[i].deque.tasks) * BASILISK_COLLECTIONS_START_LENGTH),
+        };
+        new_pool->workers[i].deque.capacity = (new_pool->workers[i].deque.tasks) ? BASILISK_COLLECTIONS_START_LENGTH : 0u;
+        mtx_init(&new_pool->workers[i].deque.lock, mtx_plain);
+    }
+
+    for (size_t i = 0u ; i < new_pool->workers_count ; i++) {
+        thrd_create(&new_pool->workers[i].thread, &worker_main, new_pool->workers + i);
+    }
+
+    return new_pool;
+}
+
+/**
+ * @brief Waits for the pending tasks, stops the threads of the pool and releases its memory, nullifying the pointer passed.
+ *
+ * @param[inout] pool Object to destroy.
+ * @param[inout] alloc Allocator used for the free.
+ */
+void worker_pool_destroy(worker_pool **pool, allocator alloc)
+{
+    if (!pool || !*pool) {
+        return;
+    }
+
+    worker_pool_wait(*pool, nullptr);
+
+    mtx_lock(&(*pool)->sleep_lock);
+    atomic_store(&(*pool)->should_stop, true);
+    cnd_broadcast(&(*pool)->wake_up);
+    mtx_unlock(&(*pool)->sleep_lock);
+
+    for (size_t i = 0u ; i < (*pool)->workers_count ; i++) {
+        thrd_join((*pool)->workers[i].thread, nullptr);
+        mtx_destroy(&(*pool)->workers[i].deque.lock);
+        if ((*pool)->workers[i].deque.tasks) {
+            alloc.free(alloc, (*pool)->workers[i].deque.tasks);
+        }
+    }
+
+    if ((*pool)->workers) {
+        alloc.free(alloc, (*pool)->workers);
+    }
+
+    cnd_destroy(&(*pool)->all_done);
+    cnd_destroy(&(*pool)->wake_up);
+    mtx_destroy(&(*pool)->sleep_lock);
+
+    alloc.free(alloc, *pool);
+    *pool = nullptr;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Hands a task to the pool. Tasks are distributed to the workers in turn ; idle workers will steal them from
+ * busy ones. Tasks should be submitted from a single thread.
+ *
+ * @param[inout] pool Target pool.
+ * @param[in] task Task (copied) to execute.
+ * @param[inout] alloc Allocator used to extend the receiving deque.
+ */
+void worker_pool_submit(worker_pool *pool, worker_task task, allocator alloc)
+{
+    worker_deque *deque = nullptr;
+
+    if (!pool || !task.routine) {
+        return;
+    }
+
+    if (pool->workers_count == 0u) {
+        worker_task_execute(task);
+        return;
+    }
+
+    deque = &pool->workers[pool->next_worker].deque;
+    pool->next_worker = (pool->next_worker + 1u) % pool->workers_count;
+
+    atomic_fetch_add(&pool->pending, 1u);
+    if (task.group) {
+        atomic_fetch_add(&task.group->pending, 1u);
+    }
+
+    // a task that cannot be queued is executed right away
+    if (!worker_deque_push(deque, task, alloc)) {
+        worker_pool_run(pool, task);
+        return;
+    }
+
+    atomic_fetch_add(&pool->queued, 1u);
+
+    mtx_lock(&pool->sleep_lock);
+    cnd_signal(&pool->wake_up);
+    mtx_unlock(&pool->sleep_lock);
+}
+
+/**
+ * @brief Blocks the calling thread until all tasks of a group are completed. If no group is given, the function waits
+ * for all tasks submitted to the pool. The calling thread steals and executes pending tasks of the group while it waits.
+ *
+ * @param[inout] pool Target pool.
+ * @param[inout] group Waited group. Can be nullptr.
+ */
+void worker_pool_wait(worker_pool *pool, worker_task_group *group)
+{
+    worker_task task = { 0u };
+    atomic_size_t *pending = nullptr;
+
+    if (!pool || (pool->workers_count == 0u)) {
+        return;
+    }
+
+    pending = group ? &group->pending : &pool->pending;
+
+    while ((atomic_load(pending) > 0u) && worker_pool_take(pool, 0u, group, &task)) {
+        worker_pool_run(pool, task);
+    }
+
+    mtx_lock(&pool->sleep_lock);
+    while (atomic_load(pending) > 0u) {
+        cnd_wait(&pool->all_done, &pool->sleep_lock);
+    }
+    mtx_unlock(&pool->sleep_lock);
+}
+
+/**
+ * @brief Returns the number of threads started by the pool.
+ *
+ * @param[in] pool Examined pool.
+ * @return size_t
+ */
+size_t worker_pool_workers_count(const worker_pool *pool)
+{
+    if (!pool) {
+        return 0u;
+    }
+
+    return pool->workers_count;
+}
+
+/**
+ * @brief Checks if the calling thread is executing the routine of a task : on a worker thread, on a thread stealing
+ * tasks while waiting on a pool, or on the submitting thread of a pool without workers.
+ *
+ * @return bool
+ */
+bool worker_pool_is_running_task(void)
+{
+    return worker_is_running_task;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Loop of a worker thread : executes tasks from its own deque or stolen from others, and sleeps when no
+ * task can be found, until the pool is stopped.
+ *
+ * @param[inout] worker_arg Pointer to the worker data.
+ * @return int
+ */
+static int worker_main(void *worker_arg)
+{
+    worker *self = (worker *) worker_arg;
+    worker_pool *pool = self->pool;
+    worker_task task = { 0u };
+
+    while (!atomic_load(&pool->should_stop)) {
+        if (worker_pool_take(pool, self->index, nullptr, &task)) {
+            worker_pool_run(pool, task);
+        } else {
+            mtx_lock(&pool->sleep_lock);
+            while (!atomic_load(&pool->should_stop) && (atomic_load(&pool->queued) == 0u)) {
+                cnd_wait(&pool->wake_up, &pool->sleep_lock);
+            }
+            mtx_unlock(&pool->sleep_lock);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Appends a task to the back of a deque and returns true. When the buffer is full, it is replaced by one twice as
+ * large, the tasks being moved to its start ; the function returns false if that allocation fails.
+ *
+ * @param[inout] deque Target deque.
+ * @param[in] task Task (copied) to append.
+ * @param[inout] alloc Allocator used to grow the buffer.
+ * @return bool
+ */
+static bool worker_deque_push(worker_deque *deque, worker_task task, allocator alloc)
+{
+    worker_task *grown = nullptr;
+    size_t grown_capacity = 0u;
+
+    mtx_lock(&deque->lock);
+    if (deque->length == deque->capacity) {
+        grown_capacity = (deque->capacity > 0u) ? (deque->capacity * 2u) : BASILISK_COLLECTIONS_START_LENGTH;
+        grown = alloc.malloc(alloc, sizeof(*grown) * grown_capacity);
+        if (!grown) {
+            mtx_unlock(&deque->lock);
+            return false;
+        }
+
+        for (size_t i = 0u ; i < deque->length ; i++) {
+            grown[i] = deque->tasks[(deque->front + i) % deque->capacity];
+        }
+        if (deque->tasks) {
+            alloc.free(alloc, deque->tasks);
+        }
+
+        deque->tasks = grown;
+        deque->capacity = grown_capacity;
+        deque->front = 0u;
+    }
+
+    deque->tasks[(deque->front + deque->length) % deque->capacity] = task;
+    deque->length += 1u;
+    mtx_unlock(&deque->lock);
+
+    return true;
+}
+
+/**
+ * @brief Removes the newest task of a deque and returns true, or returns false if the deque is empty.
+ *
+ * @param[inout] deque Target deque.
+ * @param[out] out_task Outgoing task.
+ * @return bool
+ */
+static bool worker_deque_pop(worker_deque *deque, worker_task *out_task)
+{
+    bool found = false;
+
+    mtx_lock(&deque->lock);
+    if (deque->length > 0u) {
+        deque->length -= 1u;
+        *out_task = deque->tasks[(deque->front + deque->length) % deque->capacity];
+        found = true;
+    }
+    mtx_unlock(&deque->lock);
+
+    return found;
+}
+
+/**
+ * @brief Removes the oldest task of a deque and returns true, or returns false if the deque is empty. If a group is
+ * given, the oldest task of this group is taken instead, and the function returns false if there is none.
+ * Taking the oldest task is done in constant time ; a task of a group found further in the deque is removed by moving
+ * the older tasks one place towards the back.
+ *
+ * @param[inout] deque Target deque.
+ * @param[in] group Group of the searched task. Can be nullptr.
+ * @param[out] out_task Outgoing task.
+ * @return bool
+ */
+static bool worker_deque_steal(worker_deque *deque, worker_task_group *group, worker_task *out_task)
+{
+    bool found = false;
+    size_t pos = 0u;
+
+    mtx_lock(&deque->lock);
+    while (!found && (pos < deque->length)) {
+        found = !group || (deque->tasks[(deque->front + pos) % deque->capacity].group == group);
+        pos += (size_t) !found;
+    }
+
+    if (found) {
+        *out_task = deque->tasks[(deque->front + pos) % deque->capacity];
+        for (size_t i = pos ; i > 0u ; i--) {
+            deque->tasks[(deque->front + i) % deque->capacity] = deque->tasks[(deque->front + i - 1u) % deque->capacity];
+        }
+        deque->front = (deque->front + 1u) % deque->capacity;
+        deque->length -= 1u;
+    }
+    mtx_unlock(&deque->lock);
+
+    return found;
+}
+
+/**
+ * @brief Takes a task from the deque of a worker, or steals one from the other workers, and returns true if a task
+ * was found. If a group is given, only tasks of this group are stolen from all deques.
+ *
+ * @param[inout] pool Target pool.
+ * @param[in] start_index Index of the worker whose deque is searched first.
+ * @param[in] group Group of the searched task. Can be nullptr.
+ * @param[out] out_task Outgoing task.
+ * @return bool
+ */
+static bool worker_pool_take(worker_pool *pool, size_t start_index, worker_task_group *group, worker_task *out_task)
+{
+    bool found = false;
+
+    if (atomic_load(&pool->queued) == 0u) {
+        return false;
+    }
+
+    if (group) {
+        found = worker_deque_steal(&pool->workers[start_index].deque, group, out_task);
+    } else {
+        found = worker_deque_pop(&pool->workers[start_index].deque, out_task);
+    }
+
+    for (size_t i = 1u ; !found && (i < pool->workers_count) ; i++) {
+        found = worker_deque_steal(&pool->workers[(start_index + i) % pool->workers_count].deque, group, out_task);
+    }
+
+    if (found) {
+        atomic_fetch_sub(&pool->queued, 1u);
+    }
+
+    return found;
+}
+
+/**
+ * @brief Executes a task and, if it was the last pending one of the pool or of its group, wakes up the threads
+ * waiting on the pool.
+ *
+ * @param[inout] pool Target pool.
+ * @param[in] task Executed task.
+ */
+static void worker_pool_run(worker_pool *pool, worker_task task)
+{
+    bool is_last = false;
+
+    worker_task_execute(task);
+
+    if (task.group) {
+        is_last = (atomic_fetch_sub(&task.group->pending, 1u) == 1u);
+    }
+    is_last = (atomic_fetch_sub(&pool->pending, 1u) == 1u) || is_last;
+
+    if (is_last) {
+        mtx_lock(&pool->sleep_lock);
+        cnd_broadcast(&pool->all_done);
+        mtx_unlock(&pool->sleep_lock);
+    }
+}
+
+/**
+ * @brief Executes the routine of a task. The calling thread is flagged as running a task until the routine returns,
+ * the previous flag being restored for routines waiting on a pool themselves.
+ *
+ * @param[in] task Executed task.
+ */
+static void worker_task_execute(worker_task task)
+{
+    bool was_running_task = worker_is_running_task;
+
+    worker_is_running_task = true;
+    task.routine(task.args);
+    worker_is_running_task = was_running_task;
+}
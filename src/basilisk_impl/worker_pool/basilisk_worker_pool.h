@@ -0,0 +1,74 @@
+/**
+ * @file basilisk_worker_pool.h
+ * @author gabriel ()
+ * @brief Run tasks concurrently on a fixed set of threads.
+ *
+ * Each worker thread owns a deque of tasks it consumes from the back, and steals from the front of the other
+ * workers' deques when its own is empty. Tasks can be gathered in groups to wait for a specific set of them ; the
+ * thread waiting for a group also steals the group's tasks instead of idling.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef __WORKER_POOL_H__
+#define __WORKER_POOL_H__
+
+#include <stdatomic.h>
+
+#include "../basilisk_common.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Opaque type to a set of threads executing tasks. */
+typedef struct worker_pool worker_pool;
+
+/**
+ * @brief Set of tasks that can be waited for together.
+ */
+typedef struct worker_task_group {
+    /** Number of tasks of the group submitted and not completed yet. */
+    atomic_size_t pending;
+} worker_task_group;
+
+/**
+ * @brief Unit of work executed by a worker thread.
+ */
+typedef struct worker_task {
+    /** Function executed by the worker. */
+    void (*routine)(void *task_args);
+    /** Non-owned arguments passed to the function. */
+    void *args;
+    /** Non-owned group the task belongs to. Can be nullptr. */
+    worker_task_group *group;
+} worker_task;
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+
+/* Allocates a pool and starts its threads. */
+worker_pool *worker_pool_create(size_t workers_count, allocator alloc);
+
+/* Stops the threads of a pool, releases its memory and nullifies the pointer passed. */
+void worker_pool_destroy(worker_pool **pool, allocator alloc);
+
+// -------------------------------------------------------------------------------------------------
+
+/* Hands a task to the pool. */
+void worker_pool_submit(worker_pool *pool, worker_task task, allocator alloc);
+
+/* Blocks until all tasks of a group (or all tasks if no group is given) are completed, helping the workers in the meantime. */
+void worker_pool_wait(worker_pool *pool, worker_task_group *group);
+
+/* Returns the number of threads of the pool. */
+size_t worker_pool_workers_count(const worker_pool *pool);
+
+/* Checks if the calling thread is executing a task, on a worker or while waiting on a pool. */
+bool worker_pool_is_running_task(void);
+
+#endif